@@ -0,0 +1,284 @@
+/* hyscan-buffer-decoder.c
+ *
+ * Copyright 2019 Screen LLC, Andrei Fadeev <andrei@webcontrol.ru>
+ *
+ * This file is part of HyScanTypes.
+ *
+ * HyScanTypes is dual-licensed: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * HyScanTypes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Alternatively, you can license this code under a commercial license.
+ * Contact the Screen LLC in this case - <info@screen-co.ru>.
+ */
+
+/* HyScanTypes имеет двойную лицензию.
+ *
+ * Во-первых, вы можете распространять HyScanTypes на условиях Стандартной
+ * Общественной Лицензии GNU версии 3, либо по любой более поздней версии
+ * лицензии (по вашему выбору). Полные положения лицензии GNU приведены в
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Во-вторых, этот программный код можно использовать по коммерческой
+ * лицензии. Для этого свяжитесь с ООО Экран - <info@screen-co.ru>.
+ */
+
+/**
+ * SECTION: hyscan-buffer-decoder
+ * @Short_description: потоковый импорт данных
+ * @Title: HyScanBufferDecoder
+ *
+ * Класс предназначен для импорта данных по мере их поступления, например
+ * при приёме длинной строки данных по сети. Данные передаются частями
+ * произвольного размера, в том числе не кратного размеру точки. Результат
+ * импорта совпадает с результатом функции #hyscan_buffer_import для всех
+ * данных целиком.
+ *
+ * Создание объекта класса осуществляется функцией #hyscan_buffer_decoder_new,
+ * в которую передаётся тип импортируемых данных.
+ *
+ * Функция #hyscan_buffer_decoder_push импортирует очередную часть данных и
+ * добавляет полученные точки в конец выходного буфера. Часть точки,
+ * оставшаяся в конце переданных данных, сохраняется в декодере до получения
+ * оставшихся байт. Функция #hyscan_buffer_decoder_reset начинает импорт
+ * новых данных, отбрасывая незавершённую точку.
+ *
+ * Для уменьшения числа выделений памяти при добавлении точек рекомендуется
+ * использовать для выходного буфера политику #HYSCAN_BUFFER_GROWTH_GEOMETRIC
+ * или заранее выделять память функцией #hyscan_buffer_reserve.
+ */
+
+#include "hyscan-buffer-decoder.h"
+#include "hyscan-buffer-internal.h"
+#include <string.h>
+
+struct _HyScanBufferDecoderPrivate
+{
+  const HyScanBufferFormat    *format;         /* Формат импортируемых данных. */
+  guint32                      point_size;     /* Размер точки импортируемых данных. */
+  guint32                      float_size;     /* Размер точки после импорта. */
+
+  guint32                      n_points;       /* Число импортированных точек. */
+  guint32                      pending;        /* Число байт незавершённой точки. */
+  guint64                      point[HYSCAN_BUFFER_MAX_POINT_SIZE / sizeof (guint64)];
+};
+
+G_DEFINE_TYPE_WITH_PRIVATE (HyScanBufferDecoder, hyscan_buffer_decoder, G_TYPE_OBJECT)
+
+static void
+hyscan_buffer_decoder_class_init (HyScanBufferDecoderClass *klass)
+{
+}
+
+static void
+hyscan_buffer_decoder_init (HyScanBufferDecoder *decoder)
+{
+  decoder->priv = hyscan_buffer_decoder_get_instance_private (decoder);
+}
+
+/**
+ * hyscan_buffer_decoder_new:
+ * @type: тип импортируемых данных
+ *
+ * Функция создаёт новый объект #HyScanBufferDecoder.
+ *
+ * Returns: (nullable): #HyScanBufferDecoder или NULL, если тип данных не
+ *          поддерживается. Для удаления #g_object_unref.
+ */
+HyScanBufferDecoder *
+hyscan_buffer_decoder_new (HyScanDataType type)
+{
+  const HyScanBufferFormat *format;
+  HyScanBufferDecoder *decoder;
+  HyScanBufferDecoderPrivate *priv;
+
+  format = hyscan_buffer_internal_get_format (type);
+  if (format == NULL)
+    return NULL;
+
+  if (hyscan_data_get_point_size (type) > HYSCAN_BUFFER_MAX_POINT_SIZE)
+    return NULL;
+
+  decoder = g_object_new (HYSCAN_TYPE_BUFFER_DECODER, NULL);
+  priv = decoder->priv;
+
+  priv->format = format;
+  priv->point_size = hyscan_data_get_point_size (type);
+  priv->float_size = hyscan_data_get_point_size (format->float_type);
+
+  return decoder;
+}
+
+/**
+ * hyscan_buffer_decoder_get_data_type:
+ * @decoder: указатель на #HyScanBufferDecoder
+ *
+ * Функция возвращает тип импортируемых данных.
+ *
+ * Returns: Тип импортируемых данных.
+ */
+HyScanDataType
+hyscan_buffer_decoder_get_data_type (HyScanBufferDecoder *decoder)
+{
+  g_return_val_if_fail (HYSCAN_IS_BUFFER_DECODER (decoder), HYSCAN_DATA_INVALID);
+
+  return decoder->priv->format->type;
+}
+
+/**
+ * hyscan_buffer_decoder_reset:
+ * @decoder: указатель на #HyScanBufferDecoder
+ *
+ * Функция начинает импорт новых данных. Незавершённая точка отбрасывается.
+ * Следующий вызов #hyscan_buffer_decoder_push очищает выходной буфер.
+ */
+void
+hyscan_buffer_decoder_reset (HyScanBufferDecoder *decoder)
+{
+  g_return_if_fail (HYSCAN_IS_BUFFER_DECODER (decoder));
+
+  decoder->priv->n_points = 0;
+  decoder->priv->pending = 0;
+}
+
+/**
+ * hyscan_buffer_decoder_push:
+ * @decoder: указатель на #HyScanBufferDecoder
+ * @output: указатель на #HyScanBuffer для импортированных данных
+ * @data: (array length=size) (element-type guint8): часть данных
+ * @size: размер части данных
+ *
+ * Функция импортирует часть данных и добавляет полученные точки в конец
+ * буфера @output. После #hyscan_buffer_decoder_reset и при первом вызове
+ * буфер @output очищается и в нём устанавливается тип импортированных
+ * данных. Между вызовами функции буфер @output не должен изменяться.
+ *
+ * Returns: %TRUE если данные успешно импортированы, иначе %FALSE.
+ */
+gboolean
+hyscan_buffer_decoder_push (HyScanBufferDecoder *decoder,
+                            HyScanBuffer        *output,
+                            gconstpointer        data,
+                            guint32              size)
+{
+  HyScanBufferDecoderPrivate *priv;
+  const guint8 *raw = data;
+  guint8 *values;
+  guint32 output_size;
+  guint32 n_points;
+  guint32 n_bytes;
+
+  g_return_val_if_fail (HYSCAN_IS_BUFFER_DECODER (decoder), FALSE);
+  g_return_val_if_fail (HYSCAN_IS_BUFFER (output), FALSE);
+
+  priv = decoder->priv;
+
+  if ((size > 0) && (data == NULL))
+    return FALSE;
+
+  /* Начало импорта новых данных. */
+  if ((priv->n_points == 0) && (priv->pending == 0))
+    {
+      if (!hyscan_buffer_set (output, priv->format->float_type, NULL, 0))
+        return FALSE;
+    }
+
+  /* Выходной буфер должен содержать ранее импортированные точки. */
+  output_size = priv->n_points * priv->float_size;
+  if ((hyscan_buffer_get_data_type (output) != priv->format->float_type) ||
+      (hyscan_buffer_get_data_size (output) != output_size))
+    {
+      return FALSE;
+    }
+
+  /* Число точек, завершённых этой частью данных. */
+  n_points = (guint32)(((guint64)priv->pending + size) / priv->point_size);
+  if ((guint64)n_points * priv->float_size > G_MAXUINT32 - output_size)
+    return FALSE;
+
+  if (!hyscan_buffer_set_data_size (output, output_size + n_points * priv->float_size))
+    return FALSE;
+
+  values = hyscan_buffer_get (output, NULL, &output_size);
+  values += (gsize)priv->n_points * priv->float_size;
+
+  /* Окончание точки, начатой в предыдущих частях данных. */
+  if (priv->pending > 0)
+    {
+      n_bytes = MIN (priv->point_size - priv->pending, size);
+      memcpy ((guint8 *)priv->point + priv->pending, raw, n_bytes);
+      priv->pending += n_bytes;
+      raw += n_bytes;
+      size -= n_bytes;
+
+      if (priv->pending < priv->point_size)
+        return TRUE;
+
+      hyscan_buffer_internal_decode (priv->format, (gfloat *)values, priv->point, 1, 1);
+      values += priv->float_size;
+      priv->n_points += 1;
+      priv->pending = 0;
+      n_points -= 1;
+    }
+
+  /* Точки, целиком находящиеся в этой части данных. */
+  if (n_points > 0)
+    {
+      hyscan_buffer_internal_decode (priv->format, (gfloat *)values, raw, n_points, 1);
+      priv->n_points += n_points;
+      raw += (gsize)n_points * priv->point_size;
+      size -= n_points * priv->point_size;
+    }
+
+  /* Начало точки, продолжающейся в следующей части данных. */
+  if (size > 0)
+    {
+      memcpy (priv->point, raw, size);
+      priv->pending = size;
+    }
+
+  return TRUE;
+}
+
+/**
+ * hyscan_buffer_decoder_get_n_points:
+ * @decoder: указатель на #HyScanBufferDecoder
+ *
+ * Функция возвращает число точек, импортированных после
+ * #hyscan_buffer_decoder_reset.
+ *
+ * Returns: Число импортированных точек.
+ */
+guint32
+hyscan_buffer_decoder_get_n_points (HyScanBufferDecoder *decoder)
+{
+  g_return_val_if_fail (HYSCAN_IS_BUFFER_DECODER (decoder), 0);
+
+  return decoder->priv->n_points;
+}
+
+/**
+ * hyscan_buffer_decoder_get_pending:
+ * @decoder: указатель на #HyScanBufferDecoder
+ *
+ * Функция возвращает число байт незавершённой точки, ожидающих
+ * оставшихся данных.
+ *
+ * Returns: Число байт незавершённой точки.
+ */
+guint32
+hyscan_buffer_decoder_get_pending (HyScanBufferDecoder *decoder)
+{
+  g_return_val_if_fail (HYSCAN_IS_BUFFER_DECODER (decoder), 0);
+
+  return decoder->priv->pending;
+}
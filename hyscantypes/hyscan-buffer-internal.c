@@ -0,0 +1,4602 @@
+/* hyscan-buffer-internal.c
+ *
+ * Copyright 2017-2018 Screen LLC, Andrei Fadeev <andrei@webcontrol.ru>
+ *
+ * This file is part of HyScanTypes.
+ *
+ * HyScanTypes is dual-licensed: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * HyScanTypes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Alternatively, you can license this code under a commercial license.
+ * Contact the Screen LLC in this case - <info@screen-co.ru>.
+ */
+
+/* HyScanTypes имеет двойную лицензию.
+ *
+ * Во-первых, вы можете распространять HyScanTypes на условиях Стандартной
+ * Общественной Лицензии GNU версии 3, либо по любой более поздней версии
+ * лицензии (по вашему выбору). Полные положения лицензии GNU приведены в
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Во-вторых, этот программный код можно использовать по коммерческой
+ * лицензии. Для этого свяжитесь с ООО Экран - <info@screen-co.ru>.
+ */
+
+#include "hyscan-buffer-internal.h"
+#include <string.h>
+#include <math.h>
+
+/* Векторные функции используют расширения GCC/Clang для выбора набора
+ * инструкций на уровне отдельных функций. Это позволяет собирать библиотеку
+ * без дополнительных флагов компилятора и выбирать функции во время работы. */
+#if (defined (__GNUC__) || defined (__clang__)) && (defined (__x86_64__) || defined (__i386__)) && \
+    (G_BYTE_ORDER == G_LITTLE_ENDIAN)
+#define HYSCAN_BUFFER_X86
+#define HYSCAN_BUFFER_SSE2  __attribute__ ((target ("sse2")))
+#define HYSCAN_BUFFER_AVX2  __attribute__ ((target ("avx2")))
+#define HYSCAN_BUFFER_F16C  __attribute__ ((target ("avx2,f16c")))
+#include <immintrin.h>
+#endif
+
+#if (defined (__ARM_NEON) || defined (__ARM_NEON__)) && (G_BYTE_ORDER == G_LITTLE_ENDIAN)
+#define HYSCAN_BUFFER_NEON
+#include <arm_neon.h>
+#include <fenv.h>
+#endif
+
+/* На платформах с порядком байт big endian данные в формате little endian
+ * декодируются блоками: сначала переставляются байты целого блока значений,
+ * затем выполняется преобразование без перестановки каждого значения. Для
+ * перестановки используется AltiVec, если он доступен при сборке. */
+#if G_BYTE_ORDER == G_BIG_ENDIAN
+#define HYSCAN_BUFFER_SWAP
+#if (defined (__GNUC__) || defined (__clang__)) && defined (__ALTIVEC__)
+#define HYSCAN_BUFFER_ALTIVEC
+#include <altivec.h>
+#undef vector
+#undef pixel
+#undef bool
+#define HYSCAN_BUFFER_SWAP_ALIGNED __attribute__ ((aligned (16)))
+#else
+#define HYSCAN_BUFFER_SWAP_ALIGNED
+#endif
+#endif
+
+union float32int
+{
+  gfloat                       value;          /* Значение числа. */
+  guint32                      code;           /* 32-х битное представление. */
+};
+
+/* Описание типов данных. */
+static const HyScanBufferFormat hyscan_buffer_formats[] =
+{
+  { HYSCAN_DATA_FLOAT,               HYSCAN_DATA_FLOAT,         HYSCAN_BUFFER_CODEC_FLOAT,     1 },
+  { HYSCAN_DATA_COMPLEX_FLOAT,       HYSCAN_DATA_COMPLEX_FLOAT, HYSCAN_BUFFER_CODEC_FLOAT,     2 },
+  { HYSCAN_DATA_DOA,                 HYSCAN_DATA_DOA,           HYSCAN_BUFFER_CODEC_FLOAT,     3 },
+
+  { HYSCAN_DATA_ADC14LE,             HYSCAN_DATA_FLOAT,         HYSCAN_BUFFER_CODEC_ADC14LE,   1 },
+  { HYSCAN_DATA_ADC16LE,             HYSCAN_DATA_FLOAT,         HYSCAN_BUFFER_CODEC_ADC16LE,   1 },
+  { HYSCAN_DATA_ADC24LE,             HYSCAN_DATA_FLOAT,         HYSCAN_BUFFER_CODEC_ADC24LE,   1 },
+
+  { HYSCAN_DATA_FLOAT16LE,           HYSCAN_DATA_FLOAT,         HYSCAN_BUFFER_CODEC_FLOAT16LE, 1 },
+  { HYSCAN_DATA_FLOAT32LE,           HYSCAN_DATA_FLOAT,         HYSCAN_BUFFER_CODEC_FLOAT32LE, 1 },
+
+  { HYSCAN_DATA_COMPLEX_ADC14LE,     HYSCAN_DATA_COMPLEX_FLOAT, HYSCAN_BUFFER_CODEC_ADC14LE,   2 },
+  { HYSCAN_DATA_COMPLEX_ADC16LE,     HYSCAN_DATA_COMPLEX_FLOAT, HYSCAN_BUFFER_CODEC_ADC16LE,   2 },
+  { HYSCAN_DATA_COMPLEX_ADC24LE,     HYSCAN_DATA_COMPLEX_FLOAT, HYSCAN_BUFFER_CODEC_ADC24LE,   2 },
+
+  { HYSCAN_DATA_COMPLEX_FLOAT16LE,   HYSCAN_DATA_COMPLEX_FLOAT, HYSCAN_BUFFER_CODEC_FLOAT16LE, 2 },
+  { HYSCAN_DATA_COMPLEX_FLOAT32LE,   HYSCAN_DATA_COMPLEX_FLOAT, HYSCAN_BUFFER_CODEC_FLOAT32LE, 2 },
+
+  { HYSCAN_DATA_AMPLITUDE_INT8,      HYSCAN_DATA_FLOAT,         HYSCAN_BUFFER_CODEC_INT8,      1 },
+  { HYSCAN_DATA_AMPLITUDE_INT16LE,   HYSCAN_DATA_FLOAT,         HYSCAN_BUFFER_CODEC_INT16LE,   1 },
+  { HYSCAN_DATA_AMPLITUDE_INT24LE,   HYSCAN_DATA_FLOAT,         HYSCAN_BUFFER_CODEC_INT24LE,   1 },
+  { HYSCAN_DATA_AMPLITUDE_INT32LE,   HYSCAN_DATA_FLOAT,         HYSCAN_BUFFER_CODEC_INT32LE,   1 },
+
+  { HYSCAN_DATA_AMPLITUDE_FLOAT16LE, HYSCAN_DATA_FLOAT,         HYSCAN_BUFFER_CODEC_FLOAT16LE, 1 },
+  { HYSCAN_DATA_AMPLITUDE_FLOAT32LE, HYSCAN_DATA_FLOAT,         HYSCAN_BUFFER_CODEC_FLOAT32LE, 1 },
+
+  { HYSCAN_DATA_DOA_FLOAT32LE,       HYSCAN_DATA_DOA,           HYSCAN_BUFFER_CODEC_FLOAT32LE, 3 },
+
+  { HYSCAN_DATA_ADC24LE_PACKED,           HYSCAN_DATA_FLOAT,         HYSCAN_BUFFER_CODEC_ADC24LE_PACKED, 1 },
+  { HYSCAN_DATA_COMPLEX_ADC24LE_PACKED,   HYSCAN_DATA_COMPLEX_FLOAT, HYSCAN_BUFFER_CODEC_ADC24LE_PACKED, 2 },
+  { HYSCAN_DATA_AMPLITUDE_INT24LE_PACKED, HYSCAN_DATA_FLOAT,         HYSCAN_BUFFER_CODEC_INT24LE_PACKED, 1 },
+
+  { HYSCAN_DATA_ADC12LE,                  HYSCAN_DATA_FLOAT,         HYSCAN_BUFFER_CODEC_ADC12LE,        1 },
+  { HYSCAN_DATA_COMPLEX_ADC12LE_PACKED,   HYSCAN_DATA_COMPLEX_FLOAT, HYSCAN_BUFFER_CODEC_ADC12LE_PACKED, 2 },
+
+  { HYSCAN_DATA_BFLOAT16LE,               HYSCAN_DATA_FLOAT,         HYSCAN_BUFFER_CODEC_BFLOAT16LE,     1 },
+  { HYSCAN_DATA_COMPLEX_BFLOAT16LE,       HYSCAN_DATA_COMPLEX_FLOAT, HYSCAN_BUFFER_CODEC_BFLOAT16LE,     2 },
+  { HYSCAN_DATA_AMPLITUDE_BFLOAT16LE,     HYSCAN_DATA_FLOAT,         HYSCAN_BUFFER_CODEC_BFLOAT16LE,     1 }
+};
+
+static guint32                 hyscan_buffer_mantissa16[2048];
+static guint32                 hyscan_buffer_exponent16[64];
+static guint32                 hyscan_buffer_offset16[64];
+
+static guint16                 hyscan_buffer_shift16[512];
+static guint16                 hyscan_buffer_base16[1924];
+
+static HyScanBufferCodecs      hyscan_buffer_codecs_scalar;
+#ifdef HYSCAN_BUFFER_X86
+static HyScanBufferCodecs      hyscan_buffer_codecs_sse2;
+static HyScanBufferCodecs      hyscan_buffer_codecs_avx2;
+static HyScanBufferCodecs      hyscan_buffer_codecs_f16c;
+#endif
+#ifdef HYSCAN_BUFFER_NEON
+static HyScanBufferCodecs      hyscan_buffer_codecs_neon;
+#endif
+
+static const HyScanBufferCodecs *hyscan_buffer_codecs = NULL;
+
+/* Число значений, обрабатываемых потоком за один раз. Выбрано так, чтобы
+ * исходные данные и результат помещались в кэш второго уровня. */
+#define HYSCAN_BUFFER_CHUNK_SIZE       16384
+
+/* Число значений, над которыми выполняются все операции при импорте
+ * с преобразованием. Выбрано так, чтобы данные помещались в кэш первого
+ * уровня. Должно быть чётным. */
+#define HYSCAN_BUFFER_TILE_SIZE        1024
+
+/* Число значений в блоке перестановки байт. */
+#define HYSCAN_BUFFER_SWAP_SIZE        256
+
+/* Число точек, начиная с которого преобразование выполняется параллельно. */
+#define HYSCAN_BUFFER_PARALLEL_THRESHOLD 262144
+
+static GThreadPool            *hyscan_buffer_pool = NULL;
+static guint32                 hyscan_buffer_parallel_threshold = HYSCAN_BUFFER_PARALLEL_THRESHOLD;
+
+/* Задача, выполняемая несколькими потоками. */
+typedef struct
+{
+  HyScanBufferTaskFunc         func;                           /* Функция обработки части задачи. */
+  gpointer                     data;                           /* Данные задачи. */
+  guint                        n_tasks;                        /* Число частей задачи. */
+  gint                         next;                           /* Номер следующей части. */
+
+  gint                         ref_count;                      /* Число ссылок на задачу. */
+  GMutex                       lock;                           /* Блокировка. */
+  GCond                        cond;                           /* Сигнал завершения работы потока. */
+  gboolean                     closed;                         /* Признак завершения задачи. */
+  guint                        n_active;                       /* Число работающих потоков. */
+} HyScanBufferJob;
+
+/* Часть задачи декодирования или кодирования. */
+typedef struct
+{
+  HyScanBufferDecodeFunc       decode;                         /* Функция декодирования. */
+  HyScanBufferEncodeFunc       encode;                         /* Функция кодирования. */
+  gfloat                      *values;                         /* Значения gfloat. */
+  guint8                      *raw;                            /* Значения в формате хранения. */
+  gsize                        point_size;                     /* Размер точки в формате хранения. */
+  guint                        n_point_values;                 /* Число значений в точке. */
+  gsize                        n_values;                       /* Общее число значений. */
+} HyScanBufferConvert;
+
+/* Функция вычисляет таблицы для преобразования float32 <-> float16. Сам
+ * алгоритм преобразования описан в статье "Fast Half Float Conversions"
+ * за авторством Jeroen van der Zijp. */
+static void
+hyscan_buffer_setup_table16 (void)
+{
+  guint i;
+
+  /* Таблицы преобразования float16 -> float32. */
+  hyscan_buffer_mantissa16[0] = 0;
+
+  for (i = 1; i <= 1023; i++)
+    {
+      guint m = i << 13;
+      guint e=0;
+      while (!(m & 0x00800000))
+        {
+          e-=0x00800000;
+          m <<= 1;
+        }
+      m &= ~0x00800000;
+      e += 0x38800000;
+      hyscan_buffer_mantissa16[i] = m | e;
+    }
+
+  for (i = 1024; i <= 2047; i++)
+    hyscan_buffer_mantissa16[i] = 0x38000000 + ((i - 1024) << 13);
+
+  hyscan_buffer_exponent16[0] = 0;
+  hyscan_buffer_exponent16[32] = 0x80000000;
+
+  for (i = 1; i <= 30; i++)
+    hyscan_buffer_exponent16[i] = i << 23;
+
+  for (i = 33; i <= 62; i++)
+    hyscan_buffer_exponent16[i] = 0x80000000 + ((i - 32) << 23);
+
+  hyscan_buffer_exponent16[31] = 0x47800000;
+  hyscan_buffer_exponent16[63] = 0xC7800000;
+
+  for (i = 0; i <= 63; i++)
+    hyscan_buffer_offset16[i] = 1024;
+
+  hyscan_buffer_offset16[0] = 0;
+  hyscan_buffer_offset16[32] = 0;
+
+  /* Таблицы преобразования float32 -> float16. */
+  for (i = 0; i < 256; i++)
+    {
+    gint e = i - 127;
+    if (e < -24)
+      {
+        hyscan_buffer_base16[i|0x000] = 0x0000;
+        hyscan_buffer_base16[i|0x100] = 0x8000;
+        hyscan_buffer_shift16[i|0x000] = 24;
+        hyscan_buffer_shift16[i|0x100] = 24;
+      }
+    else if (e < -14)
+      {
+        hyscan_buffer_base16[i|0x000] = (0x0400 >> (-e - 14));
+        hyscan_buffer_base16[i|0x100] = (0x0400 >> (-e - 14)) | 0x8000;
+        hyscan_buffer_shift16[i|0x000] = -e-1;
+        hyscan_buffer_shift16[i|0x100] = -e-1;
+    }
+    else if (e <= 15)
+      {
+        hyscan_buffer_base16[i|0x000] = ((e + 15) << 10);
+        hyscan_buffer_base16[i|0x100] = ((e + 15) << 10) | 0x8000;
+        hyscan_buffer_shift16[i|0x000] = 13;
+        hyscan_buffer_shift16[i|0x100] = 13;
+      }
+    else if(e < 128)
+      {
+        hyscan_buffer_base16[i|0x000] = 0x7C00;
+        hyscan_buffer_base16[i|0x100] = 0xFC00;
+        hyscan_buffer_shift16[i|0x000] = 24;
+        hyscan_buffer_shift16[i|0x100] = 24;
+      }
+    else
+      {
+        hyscan_buffer_base16[i|0x000] = 0x7C00;
+        hyscan_buffer_base16[i|0x100] = 0xFC00;
+        hyscan_buffer_shift16[i|0x000] = 13;
+        hyscan_buffer_shift16[i|0x100] = 13;
+      }
+    }
+}
+
+/* Функции декодирования данных. Значения передаются в порядке байт
+ * платформы, функции для данных в порядке little endian являются
+ * обёртками над ними. */
+
+static inline gfloat
+hyscan_buffer_decode_adc_14 (guint16 code)
+{
+  static const gfloat scale = 2.0f / 16383.0f;
+  code = code & 0x3fff;
+  return scale * code - 1.0;
+}
+
+static inline gfloat
+hyscan_buffer_decode_adc_16 (guint16 code)
+{
+  static const gfloat scale = 2.0f / 65535.0f;
+  return scale * code - 1.0;
+}
+
+static inline gfloat
+hyscan_buffer_decode_adc_24 (guint32 code)
+{
+  static const gfloat scale = 2.0f / 16777215.0f;
+  code = code & 0x00ffffff;
+  return scale * code - 1.0;
+}
+
+static inline gfloat
+hyscan_buffer_decode_int8 (guint8 code)
+{
+  static const gfloat scale = 1.0f / 255.0f;
+  return scale * code;
+}
+
+static inline gfloat
+hyscan_buffer_decode_int16 (guint16 code)
+{
+  static const gfloat scale = 1.0f / 65536.0f;
+  return scale * code;
+}
+
+static inline gfloat
+hyscan_buffer_decode_int24 (guint32 code)
+{
+  static const gfloat scale = 1.0f / 16777215.0f;
+  code = code & 0x00ffffff;
+  return scale * code;
+}
+
+static inline gfloat
+hyscan_buffer_decode_int32 (guint32 code)
+{
+  static const gfloat scale = 1.0f / 4294967295.0f;
+  return scale * code;
+}
+
+static inline gfloat
+hyscan_buffer_decode_float16 (guint16 code)
+{
+  union float32int value;
+
+  value.code  = hyscan_buffer_mantissa16[hyscan_buffer_offset16[code >> 10] + (code & 0x3ff)];
+  value.code += hyscan_buffer_exponent16[code>>10];
+
+  return value.value;
+}
+
+static inline gfloat
+hyscan_buffer_decode_adc_12 (guint16 code)
+{
+  static const gfloat scale = 2.0f / 4095.0f;
+  code = code & 0x0fff;
+  return scale * code - 1.0;
+}
+
+static inline gfloat
+hyscan_buffer_decode_bfloat16 (guint16 code)
+{
+  union float32int value;
+
+  value.code = (guint32)code << 16;
+
+  return value.value;
+}
+
+static inline gfloat
+hyscan_buffer_decode_adc_14le (guint16 code)
+{
+  return hyscan_buffer_decode_adc_14 (GUINT16_FROM_LE (code));
+}
+
+static inline gfloat
+hyscan_buffer_decode_adc_16le (guint16 code)
+{
+  return hyscan_buffer_decode_adc_16 (GUINT16_FROM_LE (code));
+}
+
+static inline gfloat
+hyscan_buffer_decode_adc_24le (guint32 code)
+{
+  return hyscan_buffer_decode_adc_24 (GUINT32_FROM_LE (code));
+}
+
+static inline gfloat
+hyscan_buffer_decode_int16le (guint16 code)
+{
+  return hyscan_buffer_decode_int16 (GUINT16_FROM_LE (code));
+}
+
+static inline gfloat
+hyscan_buffer_decode_int24le (guint32 code)
+{
+  return hyscan_buffer_decode_int24 (GUINT32_FROM_LE (code));
+}
+
+static inline gfloat
+hyscan_buffer_decode_int32le (guint32 code)
+{
+  return hyscan_buffer_decode_int32 (GUINT32_FROM_LE (code));
+}
+
+static inline gfloat
+hyscan_buffer_decode_float16le (guint16 code)
+{
+  return hyscan_buffer_decode_float16 (GUINT16_FROM_LE (code));
+}
+
+static inline gfloat
+hyscan_buffer_decode_adc_12le (guint16 code)
+{
+  return hyscan_buffer_decode_adc_12 (GUINT16_FROM_LE (code));
+}
+
+static inline gfloat
+hyscan_buffer_decode_bfloat16le (guint16 code)
+{
+  return hyscan_buffer_decode_bfloat16 (GUINT16_FROM_LE (code));
+}
+
+static inline gfloat
+hyscan_buffer_decode_float32le (guint32 code)
+{
+  union float32int value;
+
+  value.code = GUINT32_FROM_LE (code);
+
+  return value.value;
+}
+
+/* Функции кодирования данных. Результат возвращается в порядке байт
+ * платформы, функции для данных в порядке little endian являются
+ * обёртками над ними. */
+
+static inline guint16
+hyscan_buffer_encode_adc_14 (gfloat value)
+{
+  value = 8192.0 * (value + 1.0);
+  return CLAMP (value, 0.0, 16383.0);
+}
+
+static inline guint16
+hyscan_buffer_encode_adc_16 (gfloat value)
+{
+  value = 32768.0 * (value + 1.0);
+  return CLAMP (value, 0.0, 65535.0);
+}
+
+static inline guint32
+hyscan_buffer_encode_adc_24 (gfloat value)
+{
+  value = 8388608.0 * (value + 1.0);
+  return CLAMP (value, 0.0, 16777215.0);
+}
+
+static inline guint8
+hyscan_buffer_encode_int8 (gfloat value)
+{
+  guint8 code;
+  value = 256.0 * value;
+  code = CLAMP (value, 0.0, 255.0);
+  return code;
+}
+
+static inline guint16
+hyscan_buffer_encode_int16 (gfloat value)
+{
+  value = 65536.0 * value;
+  return CLAMP (value, 0.0, 65535.0);
+}
+
+static inline guint32
+hyscan_buffer_encode_int24 (gfloat value)
+{
+  value = 16777215.0 * value;
+  return CLAMP (value, 0.0, 16777215.0);
+}
+
+static inline guint32
+hyscan_buffer_encode_int32 (gfloat value)
+{
+  value = 4294967296.0 * value;
+  return CLAMP (value, 0.0, 4294967295.0);
+}
+
+static inline guint16
+hyscan_buffer_encode_float16 (gfloat value)
+{
+  union float32int code32;
+  guint16 code16;
+
+  code32.value = value;
+
+  code16  = hyscan_buffer_base16[(code32.code >> 23) & 0x1ff];
+  code16 += (code32.code & 0x007fffff) >> hyscan_buffer_shift16[(code32.code >> 23) & 0x1ff];
+
+  return code16;
+}
+
+static inline guint16
+hyscan_buffer_encode_adc_12 (gfloat value)
+{
+  value = 2048.0 * (value + 1.0);
+  return CLAMP (value, 0.0, 4095.0);
+}
+
+/* Значение округляется до ближайшего, при равенстве - до чётного. Значение
+ * NaN остаётся NaN: сохраняются старшие биты мантиссы и устанавливается
+ * старший бит оставшейся мантиссы, чтобы она не стала нулевой. */
+static inline guint16
+hyscan_buffer_encode_bfloat16 (gfloat value)
+{
+  union float32int code;
+
+  code.value = value;
+
+  if ((code.code & 0x7fffffff) > 0x7f800000)
+    return (code.code >> 16) | 0x0040;
+
+  return (code.code + 0x7fff + ((code.code >> 16) & 1)) >> 16;
+}
+
+static inline guint16
+hyscan_buffer_encode_adc_14le (gfloat value)
+{
+  return GUINT16_TO_LE (hyscan_buffer_encode_adc_14 (value));
+}
+
+static inline guint16
+hyscan_buffer_encode_adc_16le (gfloat value)
+{
+  return GUINT16_TO_LE (hyscan_buffer_encode_adc_16 (value));
+}
+
+static inline guint32
+hyscan_buffer_encode_adc_24le (gfloat value)
+{
+  return GUINT32_TO_LE (hyscan_buffer_encode_adc_24 (value));
+}
+
+static inline guint16
+hyscan_buffer_encode_int16le (gfloat value)
+{
+  return GUINT16_TO_LE (hyscan_buffer_encode_int16 (value));
+}
+
+static inline guint32
+hyscan_buffer_encode_int24le (gfloat value)
+{
+  return GUINT32_TO_LE (hyscan_buffer_encode_int24 (value));
+}
+
+static inline guint32
+hyscan_buffer_encode_int32le (gfloat value)
+{
+  return GUINT32_TO_LE (hyscan_buffer_encode_int32 (value));
+}
+
+static inline guint16
+hyscan_buffer_encode_float16le (gfloat value)
+{
+  return GUINT16_TO_LE (hyscan_buffer_encode_float16 (value));
+}
+
+static inline guint16
+hyscan_buffer_encode_adc_12le (gfloat value)
+{
+  return GUINT16_TO_LE (hyscan_buffer_encode_adc_12 (value));
+}
+
+static inline guint16
+hyscan_buffer_encode_bfloat16le (gfloat value)
+{
+  return GUINT16_TO_LE (hyscan_buffer_encode_bfloat16 (value));
+}
+
+static inline guint32
+hyscan_buffer_encode_float32le (gfloat value)
+{
+  union float32int code;
+
+  code.value = value;
+
+  return GUINT32_TO_LE (code.code);
+}
+
+
+/* Функции чтения и записи 24-х битных значений, упакованных в 3 байта
+ * в порядке little endian. */
+
+static inline guint32
+hyscan_buffer_read_u24le (const guint8 *raw8)
+{
+  return raw8[0] | ((guint32)raw8[1] << 8) | ((guint32)raw8[2] << 16);
+}
+
+static inline void
+hyscan_buffer_write_u24le (guint8  *raw8,
+                           guint32  code)
+{
+  raw8[0] = code;
+  raw8[1] = code >> 8;
+  raw8[2] = code >> 16;
+}
+
+/* Скалярные функции декодирования массивов. Они являются эталоном для
+ * векторных функций, а также обрабатывают "хвосты" массивов, длина которых
+ * не кратна размеру вектора. */
+
+static void
+hyscan_buffer_decode_float_scalar (gfloat        *values,
+                                   gconstpointer  raw,
+                                   gsize          n_values)
+{
+  memcpy (values, raw, n_values * sizeof (gfloat));
+}
+
+static void
+hyscan_buffer_decode_adc14le_scalar (gfloat        *values,
+                                     gconstpointer  raw,
+                                     gsize          n_values)
+{
+  const guint16 *raw16 = raw;
+  gsize i;
+
+  for (i = 0; i < n_values; i++)
+    values[i] = hyscan_buffer_decode_adc_14le (raw16[i]);
+}
+
+static void
+hyscan_buffer_decode_adc16le_scalar (gfloat        *values,
+                                     gconstpointer  raw,
+                                     gsize          n_values)
+{
+  const guint16 *raw16 = raw;
+  gsize i;
+
+  for (i = 0; i < n_values; i++)
+    values[i] = hyscan_buffer_decode_adc_16le (raw16[i]);
+}
+
+static void
+hyscan_buffer_decode_adc24le_scalar (gfloat        *values,
+                                     gconstpointer  raw,
+                                     gsize          n_values)
+{
+  const guint32 *raw32 = raw;
+  gsize i;
+
+  for (i = 0; i < n_values; i++)
+    values[i] = hyscan_buffer_decode_adc_24le (raw32[i]);
+}
+
+static void
+hyscan_buffer_decode_int8_scalar (gfloat        *values,
+                                  gconstpointer  raw,
+                                  gsize          n_values)
+{
+  const guint8 *raw8 = raw;
+  gsize i;
+
+  for (i = 0; i < n_values; i++)
+    values[i] = hyscan_buffer_decode_int8 (raw8[i]);
+}
+
+static void
+hyscan_buffer_decode_int16le_scalar (gfloat        *values,
+                                     gconstpointer  raw,
+                                     gsize          n_values)
+{
+  const guint16 *raw16 = raw;
+  gsize i;
+
+  for (i = 0; i < n_values; i++)
+    values[i] = hyscan_buffer_decode_int16le (raw16[i]);
+}
+
+static void
+hyscan_buffer_decode_int24le_scalar (gfloat        *values,
+                                     gconstpointer  raw,
+                                     gsize          n_values)
+{
+  const guint32 *raw32 = raw;
+  gsize i;
+
+  for (i = 0; i < n_values; i++)
+    values[i] = hyscan_buffer_decode_int24le (raw32[i]);
+}
+
+static void
+hyscan_buffer_decode_int32le_scalar (gfloat        *values,
+                                     gconstpointer  raw,
+                                     gsize          n_values)
+{
+  const guint32 *raw32 = raw;
+  gsize i;
+
+  for (i = 0; i < n_values; i++)
+    values[i] = hyscan_buffer_decode_int32le (raw32[i]);
+}
+
+static void
+hyscan_buffer_decode_float16le_scalar (gfloat        *values,
+                                       gconstpointer  raw,
+                                       gsize          n_values)
+{
+  const guint16 *raw16 = raw;
+  gsize i;
+
+  for (i = 0; i < n_values; i++)
+    values[i] = hyscan_buffer_decode_float16le (raw16[i]);
+}
+
+static void
+hyscan_buffer_decode_float32le_scalar (gfloat        *values,
+                                       gconstpointer  raw,
+                                       gsize          n_values)
+{
+#if G_BYTE_ORDER == G_LITTLE_ENDIAN
+  memcpy (values, raw, n_values * sizeof (gfloat));
+#else
+  const guint32 *raw32 = raw;
+  gsize i;
+
+  for (i = 0; i < n_values; i++)
+    values[i] = hyscan_buffer_decode_float32le (raw32[i]);
+#endif
+}
+
+
+static void
+hyscan_buffer_decode_adc24le_packed_scalar (gfloat        *values,
+                                            gconstpointer  raw,
+                                            gsize          n_values)
+{
+  const guint8 *raw8 = raw;
+  gsize i;
+
+  for (i = 0; i < n_values; i++)
+    values[i] = hyscan_buffer_decode_adc_24 (hyscan_buffer_read_u24le (raw8 + 3 * i));
+}
+
+static void
+hyscan_buffer_decode_int24le_packed_scalar (gfloat        *values,
+                                            gconstpointer  raw,
+                                            gsize          n_values)
+{
+  const guint8 *raw8 = raw;
+  gsize i;
+
+  for (i = 0; i < n_values; i++)
+    values[i] = hyscan_buffer_decode_int24 (hyscan_buffer_read_u24le (raw8 + 3 * i));
+}
+
+static void
+hyscan_buffer_decode_adc12le_scalar (gfloat        *values,
+                                     gconstpointer  raw,
+                                     gsize          n_values)
+{
+  const guint16 *raw16 = raw;
+  gsize i;
+
+  for (i = 0; i < n_values; i++)
+    values[i] = hyscan_buffer_decode_adc_12le (raw16[i]);
+}
+
+/* Два 12-ти битных значения упакованы в 3 байта: первое занимает младшие
+ * 12 бит, второе - старшие 12 бит 24-х битного числа. Число значений
+ * должно быть чётным. */
+static void
+hyscan_buffer_decode_adc12le_packed_scalar (gfloat        *values,
+                                            gconstpointer  raw,
+                                            gsize          n_values)
+{
+  const guint8 *raw8 = raw;
+  gsize i;
+
+  for (i = 0; i + 2 <= n_values; i += 2)
+    {
+      guint32 code = hyscan_buffer_read_u24le (raw8 + 3 * (i / 2));
+
+      values[i] = hyscan_buffer_decode_adc_12 (code);
+      values[i + 1] = hyscan_buffer_decode_adc_12 (code >> 12);
+    }
+}
+
+static void
+hyscan_buffer_decode_bfloat16le_scalar (gfloat        *values,
+                                        gconstpointer  raw,
+                                        gsize          n_values)
+{
+  const guint16 *raw16 = raw;
+  gsize i;
+
+  for (i = 0; i < n_values; i++)
+    values[i] = hyscan_buffer_decode_bfloat16le (raw16[i]);
+}
+
+/* Скалярные функции кодирования массивов. */
+
+static void
+hyscan_buffer_encode_float_scalar (gpointer      raw,
+                                   const gfloat *values,
+                                   gsize         n_values)
+{
+  memcpy (raw, values, n_values * sizeof (gfloat));
+}
+
+static void
+hyscan_buffer_encode_adc14le_scalar (gpointer      raw,
+                                     const gfloat *values,
+                                     gsize         n_values)
+{
+  guint16 *raw16 = raw;
+  gsize i;
+
+  for (i = 0; i < n_values; i++)
+    raw16[i] = hyscan_buffer_encode_adc_14le (values[i]);
+}
+
+static void
+hyscan_buffer_encode_adc16le_scalar (gpointer      raw,
+                                     const gfloat *values,
+                                     gsize         n_values)
+{
+  guint16 *raw16 = raw;
+  gsize i;
+
+  for (i = 0; i < n_values; i++)
+    raw16[i] = hyscan_buffer_encode_adc_16le (values[i]);
+}
+
+static void
+hyscan_buffer_encode_adc24le_scalar (gpointer      raw,
+                                     const gfloat *values,
+                                     gsize         n_values)
+{
+  guint32 *raw32 = raw;
+  gsize i;
+
+  for (i = 0; i < n_values; i++)
+    raw32[i] = hyscan_buffer_encode_adc_24le (values[i]);
+}
+
+static void
+hyscan_buffer_encode_int8_scalar (gpointer      raw,
+                                  const gfloat *values,
+                                  gsize         n_values)
+{
+  guint8 *raw8 = raw;
+  gsize i;
+
+  for (i = 0; i < n_values; i++)
+    raw8[i] = hyscan_buffer_encode_int8 (values[i]);
+}
+
+static void
+hyscan_buffer_encode_int16le_scalar (gpointer      raw,
+                                     const gfloat *values,
+                                     gsize         n_values)
+{
+  guint16 *raw16 = raw;
+  gsize i;
+
+  for (i = 0; i < n_values; i++)
+    raw16[i] = hyscan_buffer_encode_int16le (values[i]);
+}
+
+static void
+hyscan_buffer_encode_int24le_scalar (gpointer      raw,
+                                     const gfloat *values,
+                                     gsize         n_values)
+{
+  guint32 *raw32 = raw;
+  gsize i;
+
+  for (i = 0; i < n_values; i++)
+    raw32[i] = hyscan_buffer_encode_int24le (values[i]);
+}
+
+static void
+hyscan_buffer_encode_int32le_scalar (gpointer      raw,
+                                     const gfloat *values,
+                                     gsize         n_values)
+{
+  guint32 *raw32 = raw;
+  gsize i;
+
+  for (i = 0; i < n_values; i++)
+    raw32[i] = hyscan_buffer_encode_int32le (values[i]);
+}
+
+static void
+hyscan_buffer_encode_float16le_scalar (gpointer      raw,
+                                       const gfloat *values,
+                                       gsize         n_values)
+{
+  guint16 *raw16 = raw;
+  gsize i;
+
+  for (i = 0; i < n_values; i++)
+    raw16[i] = hyscan_buffer_encode_float16le (values[i]);
+}
+
+static void
+hyscan_buffer_encode_float32le_scalar (gpointer      raw,
+                                       const gfloat *values,
+                                       gsize         n_values)
+{
+#if G_BYTE_ORDER == G_LITTLE_ENDIAN
+  memcpy (raw, values, n_values * sizeof (gfloat));
+#else
+  guint32 *raw32 = raw;
+  gsize i;
+
+  for (i = 0; i < n_values; i++)
+    raw32[i] = hyscan_buffer_encode_float32le (values[i]);
+#endif
+}
+
+
+static void
+hyscan_buffer_encode_adc24le_packed_scalar (gpointer      raw,
+                                            const gfloat *values,
+                                            gsize         n_values)
+{
+  guint8 *raw8 = raw;
+  gsize i;
+
+  for (i = 0; i < n_values; i++)
+    hyscan_buffer_write_u24le (raw8 + 3 * i, hyscan_buffer_encode_adc_24 (values[i]));
+}
+
+static void
+hyscan_buffer_encode_int24le_packed_scalar (gpointer      raw,
+                                            const gfloat *values,
+                                            gsize         n_values)
+{
+  guint8 *raw8 = raw;
+  gsize i;
+
+  for (i = 0; i < n_values; i++)
+    hyscan_buffer_write_u24le (raw8 + 3 * i, hyscan_buffer_encode_int24 (values[i]));
+}
+
+static void
+hyscan_buffer_encode_adc12le_scalar (gpointer      raw,
+                                     const gfloat *values,
+                                     gsize         n_values)
+{
+  guint16 *raw16 = raw;
+  gsize i;
+
+  for (i = 0; i < n_values; i++)
+    raw16[i] = hyscan_buffer_encode_adc_12le (values[i]);
+}
+
+static void
+hyscan_buffer_encode_adc12le_packed_scalar (gpointer      raw,
+                                            const gfloat *values,
+                                            gsize         n_values)
+{
+  guint8 *raw8 = raw;
+  gsize i;
+
+  for (i = 0; i + 2 <= n_values; i += 2)
+    {
+      guint32 code = hyscan_buffer_encode_adc_12 (values[i]);
+
+      code |= (guint32)hyscan_buffer_encode_adc_12 (values[i + 1]) << 12;
+      hyscan_buffer_write_u24le (raw8 + 3 * (i / 2), code);
+    }
+}
+
+static void
+hyscan_buffer_encode_bfloat16le_scalar (gpointer      raw,
+                                        const gfloat *values,
+                                        gsize         n_values)
+{
+  guint16 *raw16 = raw;
+  gsize i;
+
+  for (i = 0; i < n_values; i++)
+    raw16[i] = hyscan_buffer_encode_bfloat16le (values[i]);
+}
+
+/* Скалярная функция вычисления амплитуды комплексных значений. Значения
+ * обрабатываются по порядку, поэтому результат можно записывать на место
+ * исходных данных. Векторные функции вычисляют амплитуду теми же
+ * операциями, квадратный корень во всех наборах инструкций вычисляется
+ * с правильным округлением, поэтому результаты совпадают побитно. */
+static void
+hyscan_buffer_amplitude_scalar (gfloat       *amplitude,
+                                const gfloat *values,
+                                gsize         n_points)
+{
+  gsize i;
+
+  for (i = 0; i < n_points; i++)
+    {
+      gfloat re = values[2 * i];
+      gfloat im = values[2 * i + 1];
+
+      amplitude[i] = sqrtf (re * re + im * im);
+    }
+}
+
+#ifdef HYSCAN_BUFFER_SWAP
+
+/* Функции перестановки байт блоков значений для платформ big endian. Массив
+ * codes может совпадать с raw. Перестановка в векторных регистрах AltiVec
+ * выполняется, если массив codes выровнен на 16 байт, а невыровненные
+ * исходные данные загружаются той же инструкцией vec_perm, что переставляет
+ * байты. Остальные значения переставляются сдвигами внутри 64-х битных
+ * слов. */
+
+#ifdef HYSCAN_BUFFER_ALTIVEC
+static const __vector unsigned char hyscan_buffer_swap16_mask =
+  { 1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14 };
+
+static const __vector unsigned char hyscan_buffer_swap32_mask =
+  { 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12 };
+
+/* Функция переставляет байты и возвращает число обработанных байт. */
+static gsize
+hyscan_buffer_swap_altivec (gpointer                     codes,
+                            gconstpointer                raw,
+                            gsize                        n_bytes,
+                            __vector unsigned char       mask)
+{
+  const guint8 *src = raw;
+  guint8 *dst = codes;
+  __vector unsigned char align;
+  __vector unsigned char perm;
+  gsize i;
+
+  if (((gsize)dst & 15) != 0)
+    return 0;
+
+  /* Перестановка для загрузки невыровненных данных, объединённая
+   * с перестановкой байт значений. */
+  align = vec_lvsl (0, src);
+  perm = vec_perm (align, align, mask);
+
+  for (i = 0; i + 16 <= n_bytes; i += 16)
+    {
+      __vector unsigned char lo = vec_ld (i, src);
+      __vector unsigned char hi = vec_ld (i + 15, src);
+
+      vec_st (vec_perm (lo, hi, perm), i, dst);
+    }
+
+  return i;
+}
+#endif
+
+static void
+hyscan_buffer_swap16 (guint16       *codes,
+                      gconstpointer  raw,
+                      gsize          n_values)
+{
+  const guint16 *raw16 = raw;
+  gsize i = 0;
+
+#ifdef HYSCAN_BUFFER_ALTIVEC
+  i = hyscan_buffer_swap_altivec (codes, raw, n_values * sizeof (guint16),
+                                  hyscan_buffer_swap16_mask) / sizeof (guint16);
+#endif
+
+  for (; i + 4 <= n_values; i += 4)
+    {
+      guint64 block;
+
+      memcpy (&block, raw16 + i, sizeof (block));
+      block = ((block & G_GUINT64_CONSTANT (0x00ff00ff00ff00ff)) << 8) |
+              ((block >> 8) & G_GUINT64_CONSTANT (0x00ff00ff00ff00ff));
+      memcpy (codes + i, &block, sizeof (block));
+    }
+
+  for (; i < n_values; i++)
+    codes[i] = GUINT16_SWAP_LE_BE (raw16[i]);
+}
+
+static void
+hyscan_buffer_swap32 (guint32       *codes,
+                      gconstpointer  raw,
+                      gsize          n_values)
+{
+  const guint32 *raw32 = raw;
+  gsize i = 0;
+
+#ifdef HYSCAN_BUFFER_ALTIVEC
+  i = hyscan_buffer_swap_altivec (codes, raw, n_values * sizeof (guint32),
+                                  hyscan_buffer_swap32_mask) / sizeof (guint32);
+#endif
+
+  for (; i + 2 <= n_values; i += 2)
+    {
+      guint64 block;
+
+      memcpy (&block, raw32 + i, sizeof (block));
+      block = ((block & G_GUINT64_CONSTANT (0x0000ffff0000ffff)) << 16) |
+              ((block >> 16) & G_GUINT64_CONSTANT (0x0000ffff0000ffff));
+      block = ((block & G_GUINT64_CONSTANT (0x00ff00ff00ff00ff)) << 8) |
+              ((block >> 8) & G_GUINT64_CONSTANT (0x00ff00ff00ff00ff));
+      memcpy (codes + i, &block, sizeof (block));
+    }
+
+  for (; i < n_values; i++)
+    codes[i] = GUINT32_SWAP_LE_BE (raw32[i]);
+}
+
+/* Функции декодирования для платформ big endian. Значения обрабатываются
+ * блоками: байты блока переставляются в промежуточный массив, который затем
+ * преобразуется функциями для порядка байт платформы. */
+
+static void
+hyscan_buffer_decode_adc14le_swap (gfloat        *values,
+                                   gconstpointer  raw,
+                                   gsize          n_values)
+{
+  const guint16 *raw16 = raw;
+  guint16 codes[HYSCAN_BUFFER_SWAP_SIZE] HYSCAN_BUFFER_SWAP_ALIGNED;
+  gsize i, j, n;
+
+  for (i = 0; i < n_values; i += n)
+    {
+      n = MIN (n_values - i, HYSCAN_BUFFER_SWAP_SIZE);
+      hyscan_buffer_swap16 (codes, raw16 + i, n);
+      for (j = 0; j < n; j++)
+        values[i + j] = hyscan_buffer_decode_adc_14 (codes[j]);
+    }
+}
+
+static void
+hyscan_buffer_decode_adc16le_swap (gfloat        *values,
+                                   gconstpointer  raw,
+                                   gsize          n_values)
+{
+  const guint16 *raw16 = raw;
+  guint16 codes[HYSCAN_BUFFER_SWAP_SIZE] HYSCAN_BUFFER_SWAP_ALIGNED;
+  gsize i, j, n;
+
+  for (i = 0; i < n_values; i += n)
+    {
+      n = MIN (n_values - i, HYSCAN_BUFFER_SWAP_SIZE);
+      hyscan_buffer_swap16 (codes, raw16 + i, n);
+      for (j = 0; j < n; j++)
+        values[i + j] = hyscan_buffer_decode_adc_16 (codes[j]);
+    }
+}
+
+static void
+hyscan_buffer_decode_adc24le_swap (gfloat        *values,
+                                   gconstpointer  raw,
+                                   gsize          n_values)
+{
+  const guint32 *raw32 = raw;
+  guint32 codes[HYSCAN_BUFFER_SWAP_SIZE] HYSCAN_BUFFER_SWAP_ALIGNED;
+  gsize i, j, n;
+
+  for (i = 0; i < n_values; i += n)
+    {
+      n = MIN (n_values - i, HYSCAN_BUFFER_SWAP_SIZE);
+      hyscan_buffer_swap32 (codes, raw32 + i, n);
+      for (j = 0; j < n; j++)
+        values[i + j] = hyscan_buffer_decode_adc_24 (codes[j]);
+    }
+}
+
+static void
+hyscan_buffer_decode_int16le_swap (gfloat        *values,
+                                   gconstpointer  raw,
+                                   gsize          n_values)
+{
+  const guint16 *raw16 = raw;
+  guint16 codes[HYSCAN_BUFFER_SWAP_SIZE] HYSCAN_BUFFER_SWAP_ALIGNED;
+  gsize i, j, n;
+
+  for (i = 0; i < n_values; i += n)
+    {
+      n = MIN (n_values - i, HYSCAN_BUFFER_SWAP_SIZE);
+      hyscan_buffer_swap16 (codes, raw16 + i, n);
+      for (j = 0; j < n; j++)
+        values[i + j] = hyscan_buffer_decode_int16 (codes[j]);
+    }
+}
+
+static void
+hyscan_buffer_decode_int24le_swap (gfloat        *values,
+                                   gconstpointer  raw,
+                                   gsize          n_values)
+{
+  const guint32 *raw32 = raw;
+  guint32 codes[HYSCAN_BUFFER_SWAP_SIZE] HYSCAN_BUFFER_SWAP_ALIGNED;
+  gsize i, j, n;
+
+  for (i = 0; i < n_values; i += n)
+    {
+      n = MIN (n_values - i, HYSCAN_BUFFER_SWAP_SIZE);
+      hyscan_buffer_swap32 (codes, raw32 + i, n);
+      for (j = 0; j < n; j++)
+        values[i + j] = hyscan_buffer_decode_int24 (codes[j]);
+    }
+}
+
+static void
+hyscan_buffer_decode_int32le_swap (gfloat        *values,
+                                   gconstpointer  raw,
+                                   gsize          n_values)
+{
+  const guint32 *raw32 = raw;
+  guint32 codes[HYSCAN_BUFFER_SWAP_SIZE] HYSCAN_BUFFER_SWAP_ALIGNED;
+  gsize i, j, n;
+
+  for (i = 0; i < n_values; i += n)
+    {
+      n = MIN (n_values - i, HYSCAN_BUFFER_SWAP_SIZE);
+      hyscan_buffer_swap32 (codes, raw32 + i, n);
+      for (j = 0; j < n; j++)
+        values[i + j] = hyscan_buffer_decode_int32 (codes[j]);
+    }
+}
+
+static void
+hyscan_buffer_decode_float16le_swap (gfloat        *values,
+                                     gconstpointer  raw,
+                                     gsize          n_values)
+{
+  const guint16 *raw16 = raw;
+  guint16 codes[HYSCAN_BUFFER_SWAP_SIZE] HYSCAN_BUFFER_SWAP_ALIGNED;
+  gsize i, j, n;
+
+  for (i = 0; i < n_values; i += n)
+    {
+      n = MIN (n_values - i, HYSCAN_BUFFER_SWAP_SIZE);
+      hyscan_buffer_swap16 (codes, raw16 + i, n);
+      for (j = 0; j < n; j++)
+        values[i + j] = hyscan_buffer_decode_float16 (codes[j]);
+    }
+}
+
+static void
+hyscan_buffer_decode_float32le_swap (gfloat        *values,
+                                     gconstpointer  raw,
+                                     gsize          n_values)
+{
+  hyscan_buffer_swap32 ((guint32 *)values, raw, n_values);
+}
+
+static void
+hyscan_buffer_decode_adc12le_swap (gfloat        *values,
+                                   gconstpointer  raw,
+                                   gsize          n_values)
+{
+  const guint16 *raw16 = raw;
+  guint16 codes[HYSCAN_BUFFER_SWAP_SIZE] HYSCAN_BUFFER_SWAP_ALIGNED;
+  gsize i, j, n;
+
+  for (i = 0; i < n_values; i += n)
+    {
+      n = MIN (n_values - i, HYSCAN_BUFFER_SWAP_SIZE);
+      hyscan_buffer_swap16 (codes, raw16 + i, n);
+      for (j = 0; j < n; j++)
+        values[i + j] = hyscan_buffer_decode_adc_12 (codes[j]);
+    }
+}
+
+static void
+hyscan_buffer_decode_bfloat16le_swap (gfloat        *values,
+                                      gconstpointer  raw,
+                                      gsize          n_values)
+{
+  const guint16 *raw16 = raw;
+  guint16 codes[HYSCAN_BUFFER_SWAP_SIZE] HYSCAN_BUFFER_SWAP_ALIGNED;
+  gsize i, j, n;
+
+  for (i = 0; i < n_values; i += n)
+    {
+      n = MIN (n_values - i, HYSCAN_BUFFER_SWAP_SIZE);
+      hyscan_buffer_swap16 (codes, raw16 + i, n);
+      for (j = 0; j < n; j++)
+        values[i + j] = hyscan_buffer_decode_bfloat16 (codes[j]);
+    }
+}
+
+/* Функции кодирования для платформ big endian. Блок значений кодируется
+ * в промежуточный массив, байты которого переставляются на месте перед
+ * копированием в результат. */
+
+static void
+hyscan_buffer_encode_adc14le_swap (gpointer      raw,
+                                   const gfloat *values,
+                                   gsize         n_values)
+{
+  guint16 *raw16 = raw;
+  guint16 codes[HYSCAN_BUFFER_SWAP_SIZE] HYSCAN_BUFFER_SWAP_ALIGNED;
+  gsize i, j, n;
+
+  for (i = 0; i < n_values; i += n)
+    {
+      n = MIN (n_values - i, HYSCAN_BUFFER_SWAP_SIZE);
+      for (j = 0; j < n; j++)
+        codes[j] = hyscan_buffer_encode_adc_14 (values[i + j]);
+      hyscan_buffer_swap16 (codes, codes, n);
+      memcpy (raw16 + i, codes, n * sizeof (guint16));
+    }
+}
+
+static void
+hyscan_buffer_encode_adc16le_swap (gpointer      raw,
+                                   const gfloat *values,
+                                   gsize         n_values)
+{
+  guint16 *raw16 = raw;
+  guint16 codes[HYSCAN_BUFFER_SWAP_SIZE] HYSCAN_BUFFER_SWAP_ALIGNED;
+  gsize i, j, n;
+
+  for (i = 0; i < n_values; i += n)
+    {
+      n = MIN (n_values - i, HYSCAN_BUFFER_SWAP_SIZE);
+      for (j = 0; j < n; j++)
+        codes[j] = hyscan_buffer_encode_adc_16 (values[i + j]);
+      hyscan_buffer_swap16 (codes, codes, n);
+      memcpy (raw16 + i, codes, n * sizeof (guint16));
+    }
+}
+
+static void
+hyscan_buffer_encode_adc24le_swap (gpointer      raw,
+                                   const gfloat *values,
+                                   gsize         n_values)
+{
+  guint32 *raw32 = raw;
+  guint32 codes[HYSCAN_BUFFER_SWAP_SIZE] HYSCAN_BUFFER_SWAP_ALIGNED;
+  gsize i, j, n;
+
+  for (i = 0; i < n_values; i += n)
+    {
+      n = MIN (n_values - i, HYSCAN_BUFFER_SWAP_SIZE);
+      for (j = 0; j < n; j++)
+        codes[j] = hyscan_buffer_encode_adc_24 (values[i + j]);
+      hyscan_buffer_swap32 (codes, codes, n);
+      memcpy (raw32 + i, codes, n * sizeof (guint32));
+    }
+}
+
+static void
+hyscan_buffer_encode_int16le_swap (gpointer      raw,
+                                   const gfloat *values,
+                                   gsize         n_values)
+{
+  guint16 *raw16 = raw;
+  guint16 codes[HYSCAN_BUFFER_SWAP_SIZE] HYSCAN_BUFFER_SWAP_ALIGNED;
+  gsize i, j, n;
+
+  for (i = 0; i < n_values; i += n)
+    {
+      n = MIN (n_values - i, HYSCAN_BUFFER_SWAP_SIZE);
+      for (j = 0; j < n; j++)
+        codes[j] = hyscan_buffer_encode_int16 (values[i + j]);
+      hyscan_buffer_swap16 (codes, codes, n);
+      memcpy (raw16 + i, codes, n * sizeof (guint16));
+    }
+}
+
+static void
+hyscan_buffer_encode_int24le_swap (gpointer      raw,
+                                   const gfloat *values,
+                                   gsize         n_values)
+{
+  guint32 *raw32 = raw;
+  guint32 codes[HYSCAN_BUFFER_SWAP_SIZE] HYSCAN_BUFFER_SWAP_ALIGNED;
+  gsize i, j, n;
+
+  for (i = 0; i < n_values; i += n)
+    {
+      n = MIN (n_values - i, HYSCAN_BUFFER_SWAP_SIZE);
+      for (j = 0; j < n; j++)
+        codes[j] = hyscan_buffer_encode_int24 (values[i + j]);
+      hyscan_buffer_swap32 (codes, codes, n);
+      memcpy (raw32 + i, codes, n * sizeof (guint32));
+    }
+}
+
+static void
+hyscan_buffer_encode_int32le_swap (gpointer      raw,
+                                   const gfloat *values,
+                                   gsize         n_values)
+{
+  guint32 *raw32 = raw;
+  guint32 codes[HYSCAN_BUFFER_SWAP_SIZE] HYSCAN_BUFFER_SWAP_ALIGNED;
+  gsize i, j, n;
+
+  for (i = 0; i < n_values; i += n)
+    {
+      n = MIN (n_values - i, HYSCAN_BUFFER_SWAP_SIZE);
+      for (j = 0; j < n; j++)
+        codes[j] = hyscan_buffer_encode_int32 (values[i + j]);
+      hyscan_buffer_swap32 (codes, codes, n);
+      memcpy (raw32 + i, codes, n * sizeof (guint32));
+    }
+}
+
+static void
+hyscan_buffer_encode_float16le_swap (gpointer      raw,
+                                     const gfloat *values,
+                                     gsize         n_values)
+{
+  guint16 *raw16 = raw;
+  guint16 codes[HYSCAN_BUFFER_SWAP_SIZE] HYSCAN_BUFFER_SWAP_ALIGNED;
+  gsize i, j, n;
+
+  for (i = 0; i < n_values; i += n)
+    {
+      n = MIN (n_values - i, HYSCAN_BUFFER_SWAP_SIZE);
+      for (j = 0; j < n; j++)
+        codes[j] = hyscan_buffer_encode_float16 (values[i + j]);
+      hyscan_buffer_swap16 (codes, codes, n);
+      memcpy (raw16 + i, codes, n * sizeof (guint16));
+    }
+}
+
+static void
+hyscan_buffer_encode_float32le_swap (gpointer      raw,
+                                     const gfloat *values,
+                                     gsize         n_values)
+{
+  hyscan_buffer_swap32 (raw, values, n_values);
+}
+
+static void
+hyscan_buffer_encode_adc12le_swap (gpointer      raw,
+                                   const gfloat *values,
+                                   gsize         n_values)
+{
+  guint16 *raw16 = raw;
+  guint16 codes[HYSCAN_BUFFER_SWAP_SIZE] HYSCAN_BUFFER_SWAP_ALIGNED;
+  gsize i, j, n;
+
+  for (i = 0; i < n_values; i += n)
+    {
+      n = MIN (n_values - i, HYSCAN_BUFFER_SWAP_SIZE);
+      for (j = 0; j < n; j++)
+        codes[j] = hyscan_buffer_encode_adc_12 (values[i + j]);
+      hyscan_buffer_swap16 (codes, codes, n);
+      memcpy (raw16 + i, codes, n * sizeof (guint16));
+    }
+}
+
+static void
+hyscan_buffer_encode_bfloat16le_swap (gpointer      raw,
+                                      const gfloat *values,
+                                      gsize         n_values)
+{
+  guint16 *raw16 = raw;
+  guint16 codes[HYSCAN_BUFFER_SWAP_SIZE] HYSCAN_BUFFER_SWAP_ALIGNED;
+  gsize i, j, n;
+
+  for (i = 0; i < n_values; i += n)
+    {
+      n = MIN (n_values - i, HYSCAN_BUFFER_SWAP_SIZE);
+      for (j = 0; j < n; j++)
+        codes[j] = hyscan_buffer_encode_bfloat16 (values[i + j]);
+      hyscan_buffer_swap16 (codes, codes, n);
+      memcpy (raw16 + i, codes, n * sizeof (guint16));
+    }
+}
+
+#endif /* HYSCAN_BUFFER_SWAP */
+
+#ifdef HYSCAN_BUFFER_X86
+
+/* Функции декодирования SSE2. Целочисленные отсчёты преобразуются в gfloat
+ * без потери точности, после чего выполняются те же операции умножения и
+ * вычитания, что и в скалярных функциях. Поэтому результат совпадает
+ * с эталоном побитно. */
+
+static inline gsize HYSCAN_BUFFER_SSE2
+hyscan_buffer_decode_u16_sse2 (gfloat         *values,
+                               const guint16  *raw16,
+                               gsize           n_values,
+                               guint16         mask,
+                               gfloat          scale,
+                               gfloat          offset)
+{
+  const __m128i vmask = _mm_set1_epi16 (mask);
+  const __m128i vzero = _mm_setzero_si128 ();
+  const __m128 vscale = _mm_set1_ps (scale);
+  const __m128 voffset = _mm_set1_ps (offset);
+  gsize i;
+
+  for (i = 0; i + 8 <= n_values; i += 8)
+    {
+      __m128i codes = _mm_and_si128 (_mm_loadu_si128 ((const __m128i *)(raw16 + i)), vmask);
+      __m128 lo = _mm_cvtepi32_ps (_mm_unpacklo_epi16 (codes, vzero));
+      __m128 hi = _mm_cvtepi32_ps (_mm_unpackhi_epi16 (codes, vzero));
+
+      _mm_storeu_ps (values + i,     _mm_sub_ps (_mm_mul_ps (vscale, lo), voffset));
+      _mm_storeu_ps (values + i + 4, _mm_sub_ps (_mm_mul_ps (vscale, hi), voffset));
+    }
+
+  return i;
+}
+
+static inline gsize HYSCAN_BUFFER_SSE2
+hyscan_buffer_decode_u24_sse2 (gfloat         *values,
+                               const guint32  *raw32,
+                               gsize           n_values,
+                               gfloat          scale,
+                               gfloat          offset)
+{
+  const __m128i vmask = _mm_set1_epi32 (0x00ffffff);
+  const __m128 vscale = _mm_set1_ps (scale);
+  const __m128 voffset = _mm_set1_ps (offset);
+  gsize i;
+
+  for (i = 0; i + 4 <= n_values; i += 4)
+    {
+      __m128i codes = _mm_and_si128 (_mm_loadu_si128 ((const __m128i *)(raw32 + i)), vmask);
+
+      _mm_storeu_ps (values + i, _mm_sub_ps (_mm_mul_ps (vscale, _mm_cvtepi32_ps (codes)), voffset));
+    }
+
+  return i;
+}
+
+static void HYSCAN_BUFFER_SSE2
+hyscan_buffer_decode_adc14le_sse2 (gfloat        *values,
+                                   gconstpointer  raw,
+                                   gsize          n_values)
+{
+  const guint16 *raw16 = raw;
+  gsize i;
+
+  i = hyscan_buffer_decode_u16_sse2 (values, raw16, n_values, 0x3fff, 2.0f / 16383.0f, 1.0f);
+  hyscan_buffer_decode_adc14le_scalar (values + i, raw16 + i, n_values - i);
+}
+
+static void HYSCAN_BUFFER_SSE2
+hyscan_buffer_decode_adc16le_sse2 (gfloat        *values,
+                                   gconstpointer  raw,
+                                   gsize          n_values)
+{
+  const guint16 *raw16 = raw;
+  gsize i;
+
+  i = hyscan_buffer_decode_u16_sse2 (values, raw16, n_values, 0xffff, 2.0f / 65535.0f, 1.0f);
+  hyscan_buffer_decode_adc16le_scalar (values + i, raw16 + i, n_values - i);
+}
+
+static void HYSCAN_BUFFER_SSE2
+hyscan_buffer_decode_adc24le_sse2 (gfloat        *values,
+                                   gconstpointer  raw,
+                                   gsize          n_values)
+{
+  const guint32 *raw32 = raw;
+  gsize i;
+
+  i = hyscan_buffer_decode_u24_sse2 (values, raw32, n_values, 2.0f / 16777215.0f, 1.0f);
+  hyscan_buffer_decode_adc24le_scalar (values + i, raw32 + i, n_values - i);
+}
+
+static void HYSCAN_BUFFER_SSE2
+hyscan_buffer_decode_int8_sse2 (gfloat        *values,
+                                gconstpointer  raw,
+                                gsize          n_values)
+{
+  const guint8 *raw8 = raw;
+  const __m128i vzero = _mm_setzero_si128 ();
+  const __m128 vscale = _mm_set1_ps (1.0f / 255.0f);
+  gsize i;
+
+  for (i = 0; i + 16 <= n_values; i += 16)
+    {
+      __m128i codes = _mm_loadu_si128 ((const __m128i *)(raw8 + i));
+      __m128i lo16 = _mm_unpacklo_epi8 (codes, vzero);
+      __m128i hi16 = _mm_unpackhi_epi8 (codes, vzero);
+
+      _mm_storeu_ps (values + i,      _mm_mul_ps (vscale, _mm_cvtepi32_ps (_mm_unpacklo_epi16 (lo16, vzero))));
+      _mm_storeu_ps (values + i + 4,  _mm_mul_ps (vscale, _mm_cvtepi32_ps (_mm_unpackhi_epi16 (lo16, vzero))));
+      _mm_storeu_ps (values + i + 8,  _mm_mul_ps (vscale, _mm_cvtepi32_ps (_mm_unpacklo_epi16 (hi16, vzero))));
+      _mm_storeu_ps (values + i + 12, _mm_mul_ps (vscale, _mm_cvtepi32_ps (_mm_unpackhi_epi16 (hi16, vzero))));
+    }
+
+  hyscan_buffer_decode_int8_scalar (values + i, raw8 + i, n_values - i);
+}
+
+static void HYSCAN_BUFFER_SSE2
+hyscan_buffer_decode_int16le_sse2 (gfloat        *values,
+                                   gconstpointer  raw,
+                                   gsize          n_values)
+{
+  const guint16 *raw16 = raw;
+  gsize i;
+
+  i = hyscan_buffer_decode_u16_sse2 (values, raw16, n_values, 0xffff, 1.0f / 65536.0f, 0.0f);
+  hyscan_buffer_decode_int16le_scalar (values + i, raw16 + i, n_values - i);
+}
+
+static void HYSCAN_BUFFER_SSE2
+hyscan_buffer_decode_int24le_sse2 (gfloat        *values,
+                                   gconstpointer  raw,
+                                   gsize          n_values)
+{
+  const guint32 *raw32 = raw;
+  gsize i;
+
+  i = hyscan_buffer_decode_u24_sse2 (values, raw32, n_values, 1.0f / 16777215.0f, 0.0f);
+  hyscan_buffer_decode_int24le_scalar (values + i, raw32 + i, n_values - i);
+}
+
+
+/* Четыре упакованных 24-х битных числа загружаются двумя 64-х битными
+ * словами со смещениями 0 и 6 байт, в каждом слове числа занимают биты 0-23
+ * и 24-47. Второе слово захватывает два байта за последним числом, поэтому
+ * векторные циклы останавливаются на одно число раньше. */
+static inline __m128i HYSCAN_BUFFER_SSE2
+hyscan_buffer_load_u24_sse2 (const guint8 *src)
+{
+  const __m128i vmask = _mm_set_epi32 (0, 0x00ffffff, 0, 0x00ffffff);
+  __m128i words = _mm_unpacklo_epi64 (_mm_loadl_epi64 ((const __m128i *)src),
+                                      _mm_loadl_epi64 ((const __m128i *)(src + 6)));
+  __m128i lo = _mm_and_si128 (words, vmask);
+  __m128i hi = _mm_and_si128 (_mm_srli_epi64 (words, 24), vmask);
+
+  return _mm_or_si128 (lo, _mm_slli_epi64 (hi, 32));
+}
+
+static inline gsize HYSCAN_BUFFER_SSE2
+hyscan_buffer_decode_u24_packed_sse2 (gfloat         *values,
+                                      const guint8   *raw8,
+                                      gsize           n_values,
+                                      gfloat          scale,
+                                      gfloat          offset)
+{
+  const __m128 vscale = _mm_set1_ps (scale);
+  const __m128 voffset = _mm_set1_ps (offset);
+  gsize i;
+
+  for (i = 0; i + 5 <= n_values; i += 4)
+    {
+      __m128i codes = hyscan_buffer_load_u24_sse2 (raw8 + 3 * i);
+
+      _mm_storeu_ps (values + i, _mm_sub_ps (_mm_mul_ps (vscale, _mm_cvtepi32_ps (codes)), voffset));
+    }
+
+  return i;
+}
+
+static void HYSCAN_BUFFER_SSE2
+hyscan_buffer_decode_adc24le_packed_sse2 (gfloat        *values,
+                                          gconstpointer  raw,
+                                          gsize          n_values)
+{
+  const guint8 *raw8 = raw;
+  gsize i;
+
+  i = hyscan_buffer_decode_u24_packed_sse2 (values, raw8, n_values, 2.0f / 16777215.0f, 1.0f);
+  hyscan_buffer_decode_adc24le_packed_scalar (values + i, raw8 + 3 * i, n_values - i);
+}
+
+static void HYSCAN_BUFFER_SSE2
+hyscan_buffer_decode_int24le_packed_sse2 (gfloat        *values,
+                                          gconstpointer  raw,
+                                          gsize          n_values)
+{
+  const guint8 *raw8 = raw;
+  gsize i;
+
+  i = hyscan_buffer_decode_u24_packed_sse2 (values, raw8, n_values, 1.0f / 16777215.0f, 0.0f);
+  hyscan_buffer_decode_int24le_packed_scalar (values + i, raw8 + 3 * i, n_values - i);
+}
+
+static void HYSCAN_BUFFER_SSE2
+hyscan_buffer_decode_adc12le_sse2 (gfloat        *values,
+                                   gconstpointer  raw,
+                                   gsize          n_values)
+{
+  const guint16 *raw16 = raw;
+  gsize i;
+
+  i = hyscan_buffer_decode_u16_sse2 (values, raw16, n_values, 0x0fff, 2.0f / 4095.0f, 1.0f);
+  hyscan_buffer_decode_adc12le_scalar (values + i, raw16 + i, n_values - i);
+}
+
+/* Пары 12-ти битных значений загружаются как 24-х битные числа, из которых
+ * выделяются младшие и старшие 12 бит. */
+static void HYSCAN_BUFFER_SSE2
+hyscan_buffer_decode_adc12le_packed_sse2 (gfloat        *values,
+                                          gconstpointer  raw,
+                                          gsize          n_values)
+{
+  const guint8 *raw8 = raw;
+  const __m128i vmask = _mm_set1_epi32 (0x0fff);
+  const __m128 vscale = _mm_set1_ps (2.0f / 4095.0f);
+  const __m128 voffset = _mm_set1_ps (1.0f);
+  gsize i;
+
+  for (i = 0; i + 10 <= n_values; i += 8)
+    {
+      __m128i words = hyscan_buffer_load_u24_sse2 (raw8 + 3 * (i / 2));
+      __m128i first = _mm_and_si128 (words, vmask);
+      __m128i second = _mm_srli_epi32 (words, 12);
+      __m128 lo = _mm_cvtepi32_ps (_mm_unpacklo_epi32 (first, second));
+      __m128 hi = _mm_cvtepi32_ps (_mm_unpackhi_epi32 (first, second));
+
+      _mm_storeu_ps (values + i,     _mm_sub_ps (_mm_mul_ps (vscale, lo), voffset));
+      _mm_storeu_ps (values + i + 4, _mm_sub_ps (_mm_mul_ps (vscale, hi), voffset));
+    }
+
+  hyscan_buffer_decode_adc12le_packed_scalar (values + i, raw8 + 3 * (i / 2), n_values - i);
+}
+
+/* Значение bfloat16 - старшие 16 бит float32. */
+static void HYSCAN_BUFFER_SSE2
+hyscan_buffer_decode_bfloat16le_sse2 (gfloat        *values,
+                                      gconstpointer  raw,
+                                      gsize          n_values)
+{
+  const guint16 *raw16 = raw;
+  const __m128i vzero = _mm_setzero_si128 ();
+  gsize i;
+
+  for (i = 0; i + 8 <= n_values; i += 8)
+    {
+      __m128i codes = _mm_loadu_si128 ((const __m128i *)(raw16 + i));
+
+      _mm_storeu_si128 ((__m128i *)(values + i),     _mm_unpacklo_epi16 (vzero, codes));
+      _mm_storeu_si128 ((__m128i *)(values + i + 4), _mm_unpackhi_epi16 (vzero, codes));
+    }
+
+  hyscan_buffer_decode_bfloat16le_scalar (values + i, raw16 + i, n_values - i);
+}
+
+/* Беззнаковое 32-х битное число преобразуется в gfloat по частям: старшие
+ * и младшие 16 бит переводятся точно, а их сумма округляется один раз, так
+ * же как при скалярном преобразовании. */
+static void HYSCAN_BUFFER_SSE2
+hyscan_buffer_decode_int32le_sse2 (gfloat        *values,
+                                   gconstpointer  raw,
+                                   gsize          n_values)
+{
+  const guint32 *raw32 = raw;
+  const __m128i vmask = _mm_set1_epi32 (0x0000ffff);
+  const __m128 vshift = _mm_set1_ps (65536.0f);
+  const __m128 vscale = _mm_set1_ps (1.0f / 4294967295.0f);
+  gsize i;
+
+  for (i = 0; i + 4 <= n_values; i += 4)
+    {
+      __m128i codes = _mm_loadu_si128 ((const __m128i *)(raw32 + i));
+      __m128 hi = _mm_cvtepi32_ps (_mm_srli_epi32 (codes, 16));
+      __m128 lo = _mm_cvtepi32_ps (_mm_and_si128 (codes, vmask));
+      __m128 value = _mm_add_ps (_mm_mul_ps (hi, vshift), lo);
+
+      _mm_storeu_ps (values + i, _mm_mul_ps (vscale, value));
+    }
+
+  hyscan_buffer_decode_int32le_scalar (values + i, raw32 + i, n_values - i);
+}
+
+/* Преобразование float16 -> float32 без таблиц. Экспонента и мантисса
+ * сдвигаются на место float32 и умножаются на 2^112, что корректно
+ * обрабатывает как нормализованные, так и денормализованные числа.
+ * Для бесконечности и NaN экспонента устанавливается в максимальное значение. */
+static inline __m128i HYSCAN_BUFFER_SSE2
+hyscan_buffer_half_to_float_sse2 (__m128i codes)
+{
+  const __m128i vnosign = _mm_set1_epi32 (0x7fff);
+  const __m128i vinfnan = _mm_set1_epi32 (0x7bff);
+  const __m128i vexpmax = _mm_set1_epi32 (0x7f800000);
+  const __m128 vmagic = _mm_castsi128_ps (_mm_set1_epi32 ((254 - 15) << 23));
+  __m128i expmant, sign, scaled, infnan;
+
+  expmant = _mm_and_si128 (codes, vnosign);
+  sign = _mm_slli_epi32 (_mm_xor_si128 (codes, expmant), 16);
+  scaled = _mm_castps_si128 (_mm_mul_ps (_mm_castsi128_ps (_mm_slli_epi32 (expmant, 13)), vmagic));
+  infnan = _mm_and_si128 (_mm_cmpgt_epi32 (expmant, vinfnan), vexpmax);
+
+  return _mm_or_si128 (_mm_or_si128 (scaled, sign), infnan);
+}
+
+static void HYSCAN_BUFFER_SSE2
+hyscan_buffer_decode_float16le_sse2 (gfloat        *values,
+                                     gconstpointer  raw,
+                                     gsize          n_values)
+{
+  const guint16 *raw16 = raw;
+  const __m128i vzero = _mm_setzero_si128 ();
+  gsize i;
+
+  for (i = 0; i + 8 <= n_values; i += 8)
+    {
+      __m128i codes = _mm_loadu_si128 ((const __m128i *)(raw16 + i));
+      __m128i lo = hyscan_buffer_half_to_float_sse2 (_mm_unpacklo_epi16 (codes, vzero));
+      __m128i hi = hyscan_buffer_half_to_float_sse2 (_mm_unpackhi_epi16 (codes, vzero));
+
+      _mm_storeu_si128 ((__m128i *)(values + i), lo);
+      _mm_storeu_si128 ((__m128i *)(values + i + 4), hi);
+    }
+
+  hyscan_buffer_decode_float16le_scalar (values + i, raw16 + i, n_values - i);
+}
+
+/* Функции декодирования AVX2. */
+
+static inline gsize HYSCAN_BUFFER_AVX2
+hyscan_buffer_decode_u16_avx2 (gfloat         *values,
+                               const guint16  *raw16,
+                               gsize           n_values,
+                               guint16         mask,
+                               gfloat          scale,
+                               gfloat          offset)
+{
+  const __m256i vmask = _mm256_set1_epi16 (mask);
+  const __m256 vscale = _mm256_set1_ps (scale);
+  const __m256 voffset = _mm256_set1_ps (offset);
+  gsize i;
+
+  for (i = 0; i + 16 <= n_values; i += 16)
+    {
+      __m256i codes = _mm256_and_si256 (_mm256_loadu_si256 ((const __m256i *)(raw16 + i)), vmask);
+      __m256 lo = _mm256_cvtepi32_ps (_mm256_cvtepu16_epi32 (_mm256_castsi256_si128 (codes)));
+      __m256 hi = _mm256_cvtepi32_ps (_mm256_cvtepu16_epi32 (_mm256_extracti128_si256 (codes, 1)));
+
+      _mm256_storeu_ps (values + i,     _mm256_sub_ps (_mm256_mul_ps (vscale, lo), voffset));
+      _mm256_storeu_ps (values + i + 8, _mm256_sub_ps (_mm256_mul_ps (vscale, hi), voffset));
+    }
+
+  return i;
+}
+
+static inline gsize HYSCAN_BUFFER_AVX2
+hyscan_buffer_decode_u24_avx2 (gfloat         *values,
+                               const guint32  *raw32,
+                               gsize           n_values,
+                               gfloat          scale,
+                               gfloat          offset)
+{
+  const __m256i vmask = _mm256_set1_epi32 (0x00ffffff);
+  const __m256 vscale = _mm256_set1_ps (scale);
+  const __m256 voffset = _mm256_set1_ps (offset);
+  gsize i;
+
+  for (i = 0; i + 8 <= n_values; i += 8)
+    {
+      __m256i codes = _mm256_and_si256 (_mm256_loadu_si256 ((const __m256i *)(raw32 + i)), vmask);
+
+      _mm256_storeu_ps (values + i, _mm256_sub_ps (_mm256_mul_ps (vscale, _mm256_cvtepi32_ps (codes)), voffset));
+    }
+
+  return i;
+}
+
+static void HYSCAN_BUFFER_AVX2
+hyscan_buffer_decode_adc14le_avx2 (gfloat        *values,
+                                   gconstpointer  raw,
+                                   gsize          n_values)
+{
+  const guint16 *raw16 = raw;
+  gsize i;
+
+  i = hyscan_buffer_decode_u16_avx2 (values, raw16, n_values, 0x3fff, 2.0f / 16383.0f, 1.0f);
+  hyscan_buffer_decode_adc14le_scalar (values + i, raw16 + i, n_values - i);
+}
+
+static void HYSCAN_BUFFER_AVX2
+hyscan_buffer_decode_adc16le_avx2 (gfloat        *values,
+                                   gconstpointer  raw,
+                                   gsize          n_values)
+{
+  const guint16 *raw16 = raw;
+  gsize i;
+
+  i = hyscan_buffer_decode_u16_avx2 (values, raw16, n_values, 0xffff, 2.0f / 65535.0f, 1.0f);
+  hyscan_buffer_decode_adc16le_scalar (values + i, raw16 + i, n_values - i);
+}
+
+static void HYSCAN_BUFFER_AVX2
+hyscan_buffer_decode_adc24le_avx2 (gfloat        *values,
+                                   gconstpointer  raw,
+                                   gsize          n_values)
+{
+  const guint32 *raw32 = raw;
+  gsize i;
+
+  i = hyscan_buffer_decode_u24_avx2 (values, raw32, n_values, 2.0f / 16777215.0f, 1.0f);
+  hyscan_buffer_decode_adc24le_scalar (values + i, raw32 + i, n_values - i);
+}
+
+static void HYSCAN_BUFFER_AVX2
+hyscan_buffer_decode_int8_avx2 (gfloat        *values,
+                                gconstpointer  raw,
+                                gsize          n_values)
+{
+  const guint8 *raw8 = raw;
+  const __m256 vscale = _mm256_set1_ps (1.0f / 255.0f);
+  gsize i;
+
+  for (i = 0; i + 16 <= n_values; i += 16)
+    {
+      __m128i codes = _mm_loadu_si128 ((const __m128i *)(raw8 + i));
+      __m256 lo = _mm256_cvtepi32_ps (_mm256_cvtepu8_epi32 (codes));
+      __m256 hi = _mm256_cvtepi32_ps (_mm256_cvtepu8_epi32 (_mm_srli_si128 (codes, 8)));
+
+      _mm256_storeu_ps (values + i,     _mm256_mul_ps (vscale, lo));
+      _mm256_storeu_ps (values + i + 8, _mm256_mul_ps (vscale, hi));
+    }
+
+  hyscan_buffer_decode_int8_scalar (values + i, raw8 + i, n_values - i);
+}
+
+static void HYSCAN_BUFFER_AVX2
+hyscan_buffer_decode_int16le_avx2 (gfloat        *values,
+                                   gconstpointer  raw,
+                                   gsize          n_values)
+{
+  const guint16 *raw16 = raw;
+  gsize i;
+
+  i = hyscan_buffer_decode_u16_avx2 (values, raw16, n_values, 0xffff, 1.0f / 65536.0f, 0.0f);
+  hyscan_buffer_decode_int16le_scalar (values + i, raw16 + i, n_values - i);
+}
+
+static void HYSCAN_BUFFER_AVX2
+hyscan_buffer_decode_int24le_avx2 (gfloat        *values,
+                                   gconstpointer  raw,
+                                   gsize          n_values)
+{
+  const guint32 *raw32 = raw;
+  gsize i;
+
+  i = hyscan_buffer_decode_u24_avx2 (values, raw32, n_values, 1.0f / 16777215.0f, 0.0f);
+  hyscan_buffer_decode_int24le_scalar (values + i, raw32 + i, n_values - i);
+}
+
+
+/* Восемь упакованных 24-х битных чисел (24 байта) загружаются в вектор,
+ * после чего в каждую половину вектора переносятся по 12 байт, которые
+ * раскладываются по 32-х битным числам. */
+static inline __m256i HYSCAN_BUFFER_AVX2
+hyscan_buffer_load_u24_avx2 (const guint8 *src)
+{
+  const __m256i vperm = _mm256_setr_epi32 (0, 1, 2, 3, 3, 4, 5, 6);
+  const __m256i vshuffle = _mm256_setr_epi8 (0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+                                             0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+  __m256i bytes = _mm256_inserti128_si256 (_mm256_castsi128_si256 (_mm_loadu_si128 ((const __m128i *)src)),
+                                           _mm_loadl_epi64 ((const __m128i *)(src + 16)), 1);
+
+  return _mm256_shuffle_epi8 (_mm256_permutevar8x32_epi32 (bytes, vperm), vshuffle);
+}
+
+static inline gsize HYSCAN_BUFFER_AVX2
+hyscan_buffer_decode_u24_packed_avx2 (gfloat         *values,
+                                      const guint8   *raw8,
+                                      gsize           n_values,
+                                      gfloat          scale,
+                                      gfloat          offset)
+{
+  const __m256 vscale = _mm256_set1_ps (scale);
+  const __m256 voffset = _mm256_set1_ps (offset);
+  gsize i;
+
+  for (i = 0; i + 8 <= n_values; i += 8)
+    {
+      __m256i codes = hyscan_buffer_load_u24_avx2 (raw8 + 3 * i);
+
+      _mm256_storeu_ps (values + i, _mm256_sub_ps (_mm256_mul_ps (vscale, _mm256_cvtepi32_ps (codes)), voffset));
+    }
+
+  return i;
+}
+
+static void HYSCAN_BUFFER_AVX2
+hyscan_buffer_decode_adc24le_packed_avx2 (gfloat        *values,
+                                          gconstpointer  raw,
+                                          gsize          n_values)
+{
+  const guint8 *raw8 = raw;
+  gsize i;
+
+  i = hyscan_buffer_decode_u24_packed_avx2 (values, raw8, n_values, 2.0f / 16777215.0f, 1.0f);
+  hyscan_buffer_decode_adc24le_packed_scalar (values + i, raw8 + 3 * i, n_values - i);
+}
+
+static void HYSCAN_BUFFER_AVX2
+hyscan_buffer_decode_int24le_packed_avx2 (gfloat        *values,
+                                          gconstpointer  raw,
+                                          gsize          n_values)
+{
+  const guint8 *raw8 = raw;
+  gsize i;
+
+  i = hyscan_buffer_decode_u24_packed_avx2 (values, raw8, n_values, 1.0f / 16777215.0f, 0.0f);
+  hyscan_buffer_decode_int24le_packed_scalar (values + i, raw8 + 3 * i, n_values - i);
+}
+
+static void HYSCAN_BUFFER_AVX2
+hyscan_buffer_decode_adc12le_avx2 (gfloat        *values,
+                                   gconstpointer  raw,
+                                   gsize          n_values)
+{
+  const guint16 *raw16 = raw;
+  gsize i;
+
+  i = hyscan_buffer_decode_u16_avx2 (values, raw16, n_values, 0x0fff, 2.0f / 4095.0f, 1.0f);
+  hyscan_buffer_decode_adc12le_scalar (values + i, raw16 + i, n_values - i);
+}
+
+/* Чередование значений внутри 128-ми битных половин восстанавливается
+ * перестановкой половин. */
+static void HYSCAN_BUFFER_AVX2
+hyscan_buffer_decode_adc12le_packed_avx2 (gfloat        *values,
+                                          gconstpointer  raw,
+                                          gsize          n_values)
+{
+  const guint8 *raw8 = raw;
+  const __m256i vmask = _mm256_set1_epi32 (0x0fff);
+  const __m256 vscale = _mm256_set1_ps (2.0f / 4095.0f);
+  const __m256 voffset = _mm256_set1_ps (1.0f);
+  gsize i;
+
+  for (i = 0; i + 16 <= n_values; i += 16)
+    {
+      __m256i words = hyscan_buffer_load_u24_avx2 (raw8 + 3 * (i / 2));
+      __m256i first = _mm256_and_si256 (words, vmask);
+      __m256i second = _mm256_srli_epi32 (words, 12);
+      __m256i lo = _mm256_unpacklo_epi32 (first, second);
+      __m256i hi = _mm256_unpackhi_epi32 (first, second);
+      __m256 v0 = _mm256_cvtepi32_ps (_mm256_permute2x128_si256 (lo, hi, 0x20));
+      __m256 v1 = _mm256_cvtepi32_ps (_mm256_permute2x128_si256 (lo, hi, 0x31));
+
+      _mm256_storeu_ps (values + i,     _mm256_sub_ps (_mm256_mul_ps (vscale, v0), voffset));
+      _mm256_storeu_ps (values + i + 8, _mm256_sub_ps (_mm256_mul_ps (vscale, v1), voffset));
+    }
+
+  hyscan_buffer_decode_adc12le_packed_scalar (values + i, raw8 + 3 * (i / 2), n_values - i);
+}
+
+static void HYSCAN_BUFFER_AVX2
+hyscan_buffer_decode_bfloat16le_avx2 (gfloat        *values,
+                                      gconstpointer  raw,
+                                      gsize          n_values)
+{
+  const guint16 *raw16 = raw;
+  gsize i;
+
+  for (i = 0; i + 8 <= n_values; i += 8)
+    {
+      __m256i codes = _mm256_cvtepu16_epi32 (_mm_loadu_si128 ((const __m128i *)(raw16 + i)));
+
+      _mm256_storeu_si256 ((__m256i *)(values + i), _mm256_slli_epi32 (codes, 16));
+    }
+
+  hyscan_buffer_decode_bfloat16le_scalar (values + i, raw16 + i, n_values - i);
+}
+
+static void HYSCAN_BUFFER_AVX2
+hyscan_buffer_decode_int32le_avx2 (gfloat        *values,
+                                   gconstpointer  raw,
+                                   gsize          n_values)
+{
+  const guint32 *raw32 = raw;
+  const __m256i vmask = _mm256_set1_epi32 (0x0000ffff);
+  const __m256 vshift = _mm256_set1_ps (65536.0f);
+  const __m256 vscale = _mm256_set1_ps (1.0f / 4294967295.0f);
+  gsize i;
+
+  for (i = 0; i + 8 <= n_values; i += 8)
+    {
+      __m256i codes = _mm256_loadu_si256 ((const __m256i *)(raw32 + i));
+      __m256 hi = _mm256_cvtepi32_ps (_mm256_srli_epi32 (codes, 16));
+      __m256 lo = _mm256_cvtepi32_ps (_mm256_and_si256 (codes, vmask));
+      __m256 value = _mm256_add_ps (_mm256_mul_ps (hi, vshift), lo);
+
+      _mm256_storeu_ps (values + i, _mm256_mul_ps (vscale, value));
+    }
+
+  hyscan_buffer_decode_int32le_scalar (values + i, raw32 + i, n_values - i);
+}
+
+static inline __m256i HYSCAN_BUFFER_AVX2
+hyscan_buffer_half_to_float_avx2 (__m256i codes)
+{
+  const __m256i vnosign = _mm256_set1_epi32 (0x7fff);
+  const __m256i vinfnan = _mm256_set1_epi32 (0x7bff);
+  const __m256i vexpmax = _mm256_set1_epi32 (0x7f800000);
+  const __m256 vmagic = _mm256_castsi256_ps (_mm256_set1_epi32 ((254 - 15) << 23));
+  __m256i expmant, sign, scaled, infnan;
+
+  expmant = _mm256_and_si256 (codes, vnosign);
+  sign = _mm256_slli_epi32 (_mm256_xor_si256 (codes, expmant), 16);
+  scaled = _mm256_castps_si256 (_mm256_mul_ps (_mm256_castsi256_ps (_mm256_slli_epi32 (expmant, 13)), vmagic));
+  infnan = _mm256_and_si256 (_mm256_cmpgt_epi32 (expmant, vinfnan), vexpmax);
+
+  return _mm256_or_si256 (_mm256_or_si256 (scaled, sign), infnan);
+}
+
+static void HYSCAN_BUFFER_AVX2
+hyscan_buffer_decode_float16le_avx2 (gfloat        *values,
+                                     gconstpointer  raw,
+                                     gsize          n_values)
+{
+  const guint16 *raw16 = raw;
+  gsize i;
+
+  for (i = 0; i + 16 <= n_values; i += 16)
+    {
+      __m256i codes = _mm256_loadu_si256 ((const __m256i *)(raw16 + i));
+      __m256i lo = _mm256_cvtepu16_epi32 (_mm256_castsi256_si128 (codes));
+      __m256i hi = _mm256_cvtepu16_epi32 (_mm256_extracti128_si256 (codes, 1));
+
+      _mm256_storeu_si256 ((__m256i *)(values + i),     hyscan_buffer_half_to_float_avx2 (lo));
+      _mm256_storeu_si256 ((__m256i *)(values + i + 8), hyscan_buffer_half_to_float_avx2 (hi));
+    }
+
+  hyscan_buffer_decode_float16le_scalar (values + i, raw16 + i, n_values - i);
+}
+
+/* Функции кодирования SSE2. Значение масштабируется так же, как в скалярных
+ * функциях, ограничивается диапазоном [0, high] и преобразуется в целое
+ * число с отбрасыванием дробной части. Значение NaN кодируется нулём. */
+
+static inline __m128i HYSCAN_BUFFER_SSE2
+hyscan_buffer_encode_i32_sse2 (__m128 values,
+                               __m128 vscale,
+                               __m128 voffset,
+                               __m128 vhigh)
+{
+  __m128 value = _mm_mul_ps (vscale, _mm_add_ps (values, voffset));
+
+  value = _mm_min_ps (_mm_max_ps (value, _mm_setzero_ps ()), vhigh);
+
+  return _mm_cvttps_epi32 (value);
+}
+
+/* Упаковка двух векторов 32-х битных чисел из диапазона [0, 65535] в один
+ * вектор 16-ти битных чисел. */
+static inline __m128i HYSCAN_BUFFER_SSE2
+hyscan_buffer_pack_u16_sse2 (__m128i lo,
+                             __m128i hi)
+{
+  const __m128i vbias32 = _mm_set1_epi32 (32768);
+  const __m128i vbias16 = _mm_set1_epi16 ((gint16)0x8000);
+
+  lo = _mm_sub_epi32 (lo, vbias32);
+  hi = _mm_sub_epi32 (hi, vbias32);
+
+  return _mm_xor_si128 (_mm_packs_epi32 (lo, hi), vbias16);
+}
+
+static inline gsize HYSCAN_BUFFER_SSE2
+hyscan_buffer_encode_u16_sse2 (guint16       *raw16,
+                               const gfloat  *values,
+                               gsize          n_values,
+                               gfloat         scale,
+                               gfloat         offset,
+                               gfloat         high)
+{
+  const __m128 vscale = _mm_set1_ps (scale);
+  const __m128 voffset = _mm_set1_ps (offset);
+  const __m128 vhigh = _mm_set1_ps (high);
+  gsize i;
+
+  for (i = 0; i + 8 <= n_values; i += 8)
+    {
+      __m128i lo = hyscan_buffer_encode_i32_sse2 (_mm_loadu_ps (values + i), vscale, voffset, vhigh);
+      __m128i hi = hyscan_buffer_encode_i32_sse2 (_mm_loadu_ps (values + i + 4), vscale, voffset, vhigh);
+
+      _mm_storeu_si128 ((__m128i *)(raw16 + i), hyscan_buffer_pack_u16_sse2 (lo, hi));
+    }
+
+  return i;
+}
+
+static inline gsize HYSCAN_BUFFER_SSE2
+hyscan_buffer_encode_u24_sse2 (guint32       *raw32,
+                               const gfloat  *values,
+                               gsize          n_values,
+                               gfloat         scale,
+                               gfloat         offset)
+{
+  const __m128 vscale = _mm_set1_ps (scale);
+  const __m128 voffset = _mm_set1_ps (offset);
+  const __m128 vhigh = _mm_set1_ps (16777215.0f);
+  gsize i;
+
+  for (i = 0; i + 4 <= n_values; i += 4)
+    {
+      __m128i codes = hyscan_buffer_encode_i32_sse2 (_mm_loadu_ps (values + i), vscale, voffset, vhigh);
+
+      _mm_storeu_si128 ((__m128i *)(raw32 + i), codes);
+    }
+
+  return i;
+}
+
+static void HYSCAN_BUFFER_SSE2
+hyscan_buffer_encode_adc14le_sse2 (gpointer      raw,
+                                   const gfloat *values,
+                                   gsize         n_values)
+{
+  guint16 *raw16 = raw;
+  gsize i;
+
+  i = hyscan_buffer_encode_u16_sse2 (raw16, values, n_values, 8192.0f, 1.0f, 16383.0f);
+  hyscan_buffer_encode_adc14le_scalar (raw16 + i, values + i, n_values - i);
+}
+
+static void HYSCAN_BUFFER_SSE2
+hyscan_buffer_encode_adc16le_sse2 (gpointer      raw,
+                                   const gfloat *values,
+                                   gsize         n_values)
+{
+  guint16 *raw16 = raw;
+  gsize i;
+
+  i = hyscan_buffer_encode_u16_sse2 (raw16, values, n_values, 32768.0f, 1.0f, 65535.0f);
+  hyscan_buffer_encode_adc16le_scalar (raw16 + i, values + i, n_values - i);
+}
+
+static void HYSCAN_BUFFER_SSE2
+hyscan_buffer_encode_adc24le_sse2 (gpointer      raw,
+                                   const gfloat *values,
+                                   gsize         n_values)
+{
+  guint32 *raw32 = raw;
+  gsize i;
+
+  i = hyscan_buffer_encode_u24_sse2 (raw32, values, n_values, 8388608.0f, 1.0f);
+  hyscan_buffer_encode_adc24le_scalar (raw32 + i, values + i, n_values - i);
+}
+
+static void HYSCAN_BUFFER_SSE2
+hyscan_buffer_encode_int8_sse2 (gpointer      raw,
+                                const gfloat *values,
+                                gsize         n_values)
+{
+  guint8 *raw8 = raw;
+  const __m128 vscale = _mm_set1_ps (256.0f);
+  const __m128 voffset = _mm_setzero_ps ();
+  const __m128 vhigh = _mm_set1_ps (255.0f);
+  gsize i;
+
+  for (i = 0; i + 16 <= n_values; i += 16)
+    {
+      __m128i c0 = hyscan_buffer_encode_i32_sse2 (_mm_loadu_ps (values + i),      vscale, voffset, vhigh);
+      __m128i c1 = hyscan_buffer_encode_i32_sse2 (_mm_loadu_ps (values + i + 4),  vscale, voffset, vhigh);
+      __m128i c2 = hyscan_buffer_encode_i32_sse2 (_mm_loadu_ps (values + i + 8),  vscale, voffset, vhigh);
+      __m128i c3 = hyscan_buffer_encode_i32_sse2 (_mm_loadu_ps (values + i + 12), vscale, voffset, vhigh);
+
+      _mm_storeu_si128 ((__m128i *)(raw8 + i), _mm_packus_epi16 (_mm_packs_epi32 (c0, c1),
+                                                                 _mm_packs_epi32 (c2, c3)));
+    }
+
+  hyscan_buffer_encode_int8_scalar (raw8 + i, values + i, n_values - i);
+}
+
+static void HYSCAN_BUFFER_SSE2
+hyscan_buffer_encode_int16le_sse2 (gpointer      raw,
+                                   const gfloat *values,
+                                   gsize         n_values)
+{
+  guint16 *raw16 = raw;
+  gsize i;
+
+  i = hyscan_buffer_encode_u16_sse2 (raw16, values, n_values, 65536.0f, 0.0f, 65535.0f);
+  hyscan_buffer_encode_int16le_scalar (raw16 + i, values + i, n_values - i);
+}
+
+static void HYSCAN_BUFFER_SSE2
+hyscan_buffer_encode_int24le_sse2 (gpointer      raw,
+                                   const gfloat *values,
+                                   gsize         n_values)
+{
+  guint32 *raw32 = raw;
+  gsize i;
+
+  i = hyscan_buffer_encode_u24_sse2 (raw32, values, n_values, 16777215.0f, 0.0f);
+  hyscan_buffer_encode_int24le_scalar (raw32 + i, values + i, n_values - i);
+}
+
+
+/* Запись обратна загрузке в hyscan_buffer_load_u24_sse2: второе 64-х
+ * битное слово записывается со смещением 6 байт и затирает два байта за
+ * последним числом, которые записываются позже. */
+static inline void HYSCAN_BUFFER_SSE2
+hyscan_buffer_store_u24_sse2 (guint8  *dst,
+                              __m128i  codes)
+{
+  const __m128i vmask = _mm_set_epi32 (0, -1, 0, -1);
+  __m128i words = _mm_or_si128 (_mm_and_si128 (codes, vmask),
+                                _mm_slli_epi64 (_mm_srli_epi64 (codes, 32), 24));
+
+  _mm_storel_epi64 ((__m128i *)dst, words);
+  _mm_storel_epi64 ((__m128i *)(dst + 6), _mm_unpackhi_epi64 (words, words));
+}
+
+static inline gsize HYSCAN_BUFFER_SSE2
+hyscan_buffer_encode_u24_packed_sse2 (guint8        *raw8,
+                                      const gfloat  *values,
+                                      gsize          n_values,
+                                      gfloat         scale,
+                                      gfloat         offset)
+{
+  const __m128 vscale = _mm_set1_ps (scale);
+  const __m128 voffset = _mm_set1_ps (offset);
+  const __m128 vhigh = _mm_set1_ps (16777215.0f);
+  gsize i;
+
+  for (i = 0; i + 5 <= n_values; i += 4)
+    {
+      __m128i codes = hyscan_buffer_encode_i32_sse2 (_mm_loadu_ps (values + i), vscale, voffset, vhigh);
+
+      hyscan_buffer_store_u24_sse2 (raw8 + 3 * i, codes);
+    }
+
+  return i;
+}
+
+static void HYSCAN_BUFFER_SSE2
+hyscan_buffer_encode_adc24le_packed_sse2 (gpointer      raw,
+                                          const gfloat *values,
+                                          gsize         n_values)
+{
+  guint8 *raw8 = raw;
+  gsize i;
+
+  i = hyscan_buffer_encode_u24_packed_sse2 (raw8, values, n_values, 8388608.0f, 1.0f);
+  hyscan_buffer_encode_adc24le_packed_scalar (raw8 + 3 * i, values + i, n_values - i);
+}
+
+static void HYSCAN_BUFFER_SSE2
+hyscan_buffer_encode_int24le_packed_sse2 (gpointer      raw,
+                                          const gfloat *values,
+                                          gsize         n_values)
+{
+  guint8 *raw8 = raw;
+  gsize i;
+
+  i = hyscan_buffer_encode_u24_packed_sse2 (raw8, values, n_values, 16777215.0f, 0.0f);
+  hyscan_buffer_encode_int24le_packed_scalar (raw8 + 3 * i, values + i, n_values - i);
+}
+
+static void HYSCAN_BUFFER_SSE2
+hyscan_buffer_encode_adc12le_sse2 (gpointer      raw,
+                                   const gfloat *values,
+                                   gsize         n_values)
+{
+  guint16 *raw16 = raw;
+  gsize i;
+
+  i = hyscan_buffer_encode_u16_sse2 (raw16, values, n_values, 2048.0f, 1.0f, 4095.0f);
+  hyscan_buffer_encode_adc12le_scalar (raw16 + i, values + i, n_values - i);
+}
+
+/* Чётные и нечётные значения разделяются и объединяются в 24-х битные
+ * числа, которые записываются так же, как упакованные 24-х битные данные. */
+static void HYSCAN_BUFFER_SSE2
+hyscan_buffer_encode_adc12le_packed_sse2 (gpointer      raw,
+                                          const gfloat *values,
+                                          gsize         n_values)
+{
+  guint8 *raw8 = raw;
+  const __m128 vscale = _mm_set1_ps (2048.0f);
+  const __m128 voffset = _mm_set1_ps (1.0f);
+  const __m128 vhigh = _mm_set1_ps (4095.0f);
+  gsize i;
+
+  for (i = 0; i + 10 <= n_values; i += 8)
+    {
+      __m128 lo = _mm_castsi128_ps (hyscan_buffer_encode_i32_sse2 (_mm_loadu_ps (values + i), vscale, voffset, vhigh));
+      __m128 hi = _mm_castsi128_ps (hyscan_buffer_encode_i32_sse2 (_mm_loadu_ps (values + i + 4), vscale, voffset, vhigh));
+      __m128i first = _mm_castps_si128 (_mm_shuffle_ps (lo, hi, _MM_SHUFFLE (2, 0, 2, 0)));
+      __m128i second = _mm_castps_si128 (_mm_shuffle_ps (lo, hi, _MM_SHUFFLE (3, 1, 3, 1)));
+
+      hyscan_buffer_store_u24_sse2 (raw8 + 3 * (i / 2), _mm_or_si128 (first, _mm_slli_epi32 (second, 12)));
+    }
+
+  hyscan_buffer_encode_adc12le_packed_scalar (raw8 + 3 * (i / 2), values + i, n_values - i);
+}
+
+/* Преобразование float32 -> bfloat16 с округлением, повторяющее скалярную
+ * функцию. Результат - 32-х битные числа из диапазона [0, 65535]. */
+static inline __m128i HYSCAN_BUFFER_SSE2
+hyscan_buffer_float_to_bfloat_sse2 (__m128 values)
+{
+  const __m128i vabsmask = _mm_set1_epi32 (0x7fffffff);
+  const __m128i vinf = _mm_set1_epi32 (0x7f800000);
+  const __m128i vround = _mm_set1_epi32 (0x7fff);
+  const __m128i vone = _mm_set1_epi32 (1);
+  const __m128i vquiet = _mm_set1_epi32 (0x0040);
+  __m128i bits = _mm_castps_si128 (values);
+  __m128i high = _mm_srli_epi32 (bits, 16);
+  __m128i nan = _mm_cmpgt_epi32 (_mm_and_si128 (bits, vabsmask), vinf);
+  __m128i rounded = _mm_srli_epi32 (_mm_add_epi32 (bits, _mm_add_epi32 (vround, _mm_and_si128 (high, vone))), 16);
+
+  return _mm_or_si128 (_mm_and_si128 (nan, _mm_or_si128 (high, vquiet)), _mm_andnot_si128 (nan, rounded));
+}
+
+static void HYSCAN_BUFFER_SSE2
+hyscan_buffer_encode_bfloat16le_sse2 (gpointer      raw,
+                                      const gfloat *values,
+                                      gsize         n_values)
+{
+  guint16 *raw16 = raw;
+  gsize i;
+
+  for (i = 0; i + 8 <= n_values; i += 8)
+    {
+      __m128i lo = hyscan_buffer_float_to_bfloat_sse2 (_mm_loadu_ps (values + i));
+      __m128i hi = hyscan_buffer_float_to_bfloat_sse2 (_mm_loadu_ps (values + i + 4));
+
+      _mm_storeu_si128 ((__m128i *)(raw16 + i), hyscan_buffer_pack_u16_sse2 (lo, hi));
+    }
+
+  hyscan_buffer_encode_bfloat16le_scalar (raw16 + i, values + i, n_values - i);
+}
+
+/* Значения из диапазона [2^31, 2^32) не помещаются в знаковое целое, поэтому
+ * из них вычитается 2^31, а после преобразования старший бит восстанавливается.
+ * Значения не меньше 2^32 кодируются максимальным числом. */
+static void HYSCAN_BUFFER_SSE2
+hyscan_buffer_encode_int32le_sse2 (gpointer      raw,
+                                   const gfloat *values,
+                                   gsize         n_values)
+{
+  guint32 *raw32 = raw;
+  const __m128 vscale = _mm_set1_ps (4294967296.0f);
+  const __m128 vtwo31 = _mm_set1_ps (2147483648.0f);
+  const __m128 vtwo32 = _mm_set1_ps (4294967296.0f);
+  gsize i;
+
+  for (i = 0; i + 4 <= n_values; i += 4)
+    {
+      __m128 value = _mm_max_ps (_mm_mul_ps (vscale, _mm_loadu_ps (values + i)), _mm_setzero_ps ());
+      __m128 big = _mm_cmpge_ps (value, vtwo32);
+      __m128 high = _mm_cmpge_ps (value, vtwo31);
+      __m128i codes;
+
+      codes = _mm_cvttps_epi32 (_mm_sub_ps (value, _mm_and_ps (high, vtwo31)));
+      codes = _mm_xor_si128 (codes, _mm_slli_epi32 (_mm_castps_si128 (high), 31));
+      codes = _mm_or_si128 (codes, _mm_castps_si128 (big));
+
+      _mm_storeu_si128 ((__m128i *)(raw32 + i), codes);
+    }
+
+  hyscan_buffer_encode_int32le_scalar (raw32 + i, values + i, n_values - i);
+}
+
+/* Преобразование float32 -> float16 без таблиц, повторяющее табличный
+ * алгоритм: мантисса отбрасывается, числа больше 65535 и бесконечность
+ * становятся бесконечностью, у NaN сохраняются старшие биты мантиссы.
+ * Денормализованные значения вычисляются умножением на 2^24. */
+static inline __m128i HYSCAN_BUFFER_SSE2
+hyscan_buffer_float_to_half_sse2 (__m128 values)
+{
+  const __m128i vabsmask = _mm_set1_epi32 (0x7fffffff);
+  const __m128i vbias = _mm_set1_epi32 (112 << 10);
+  const __m128i vmant = _mm_set1_epi32 (0x3ff);
+  const __m128i vinf = _mm_set1_epi32 (0x7c00);
+  const __m128i vmin_normal = _mm_set1_epi32 (0x38800000);
+  const __m128i vmax_normal = _mm_set1_epi32 (0x477fffff);
+  const __m128i vmax_finite = _mm_set1_epi32 (0x7f7fffff);
+  const __m128 vdenormal_scale = _mm_set1_ps (16777216.0f);
+  __m128i bits, abs, sign, normal, denormal, nan;
+  __m128i is_denormal, is_big, is_nan, codes;
+
+  bits = _mm_castps_si128 (values);
+  abs = _mm_and_si128 (bits, vabsmask);
+  sign = _mm_srli_epi32 (_mm_andnot_si128 (vabsmask, bits), 16);
+
+  normal = _mm_sub_epi32 (_mm_srli_epi32 (abs, 13), vbias);
+  denormal = _mm_cvttps_epi32 (_mm_mul_ps (_mm_castsi128_ps (abs), vdenormal_scale));
+  nan = _mm_or_si128 (vinf, _mm_and_si128 (_mm_srli_epi32 (abs, 13), vmant));
+
+  is_denormal = _mm_cmplt_epi32 (abs, vmin_normal);
+  is_big = _mm_cmpgt_epi32 (abs, vmax_normal);
+  is_nan = _mm_cmpgt_epi32 (abs, vmax_finite);
+
+  codes = _mm_or_si128 (_mm_and_si128 (is_denormal, denormal), _mm_andnot_si128 (is_denormal, normal));
+  codes = _mm_or_si128 (_mm_and_si128 (is_big, vinf), _mm_andnot_si128 (is_big, codes));
+  codes = _mm_or_si128 (_mm_and_si128 (is_nan, nan), _mm_andnot_si128 (is_nan, codes));
+
+  return _mm_or_si128 (codes, sign);
+}
+
+static void HYSCAN_BUFFER_SSE2
+hyscan_buffer_encode_float16le_sse2 (gpointer      raw,
+                                     const gfloat *values,
+                                     gsize         n_values)
+{
+  guint16 *raw16 = raw;
+  gsize i;
+
+  for (i = 0; i + 8 <= n_values; i += 8)
+    {
+      __m128i lo = hyscan_buffer_float_to_half_sse2 (_mm_loadu_ps (values + i));
+      __m128i hi = hyscan_buffer_float_to_half_sse2 (_mm_loadu_ps (values + i + 4));
+
+      _mm_storeu_si128 ((__m128i *)(raw16 + i), hyscan_buffer_pack_u16_sse2 (lo, hi));
+    }
+
+  hyscan_buffer_encode_float16le_scalar (raw16 + i, values + i, n_values - i);
+}
+
+/* Функции кодирования AVX2. */
+
+static inline __m256i HYSCAN_BUFFER_AVX2
+hyscan_buffer_encode_i32_avx2 (__m256 values,
+                               __m256 vscale,
+                               __m256 voffset,
+                               __m256 vhigh)
+{
+  __m256 value = _mm256_mul_ps (vscale, _mm256_add_ps (values, voffset));
+
+  value = _mm256_min_ps (_mm256_max_ps (value, _mm256_setzero_ps ()), vhigh);
+
+  return _mm256_cvttps_epi32 (value);
+}
+
+/* Упаковка с восстановлением порядка, нарушенного упаковкой внутри
+ * 128-ми битных половин. */
+static inline __m256i HYSCAN_BUFFER_AVX2
+hyscan_buffer_pack_u16_avx2 (__m256i lo,
+                             __m256i hi)
+{
+  return _mm256_permute4x64_epi64 (_mm256_packus_epi32 (lo, hi), 0xd8);
+}
+
+static inline gsize HYSCAN_BUFFER_AVX2
+hyscan_buffer_encode_u16_avx2 (guint16       *raw16,
+                               const gfloat  *values,
+                               gsize          n_values,
+                               gfloat         scale,
+                               gfloat         offset,
+                               gfloat         high)
+{
+  const __m256 vscale = _mm256_set1_ps (scale);
+  const __m256 voffset = _mm256_set1_ps (offset);
+  const __m256 vhigh = _mm256_set1_ps (high);
+  gsize i;
+
+  for (i = 0; i + 16 <= n_values; i += 16)
+    {
+      __m256i lo = hyscan_buffer_encode_i32_avx2 (_mm256_loadu_ps (values + i), vscale, voffset, vhigh);
+      __m256i hi = hyscan_buffer_encode_i32_avx2 (_mm256_loadu_ps (values + i + 8), vscale, voffset, vhigh);
+
+      _mm256_storeu_si256 ((__m256i *)(raw16 + i), hyscan_buffer_pack_u16_avx2 (lo, hi));
+    }
+
+  return i;
+}
+
+static inline gsize HYSCAN_BUFFER_AVX2
+hyscan_buffer_encode_u24_avx2 (guint32       *raw32,
+                               const gfloat  *values,
+                               gsize          n_values,
+                               gfloat         scale,
+                               gfloat         offset)
+{
+  const __m256 vscale = _mm256_set1_ps (scale);
+  const __m256 voffset = _mm256_set1_ps (offset);
+  const __m256 vhigh = _mm256_set1_ps (16777215.0f);
+  gsize i;
+
+  for (i = 0; i + 8 <= n_values; i += 8)
+    {
+      __m256i codes = hyscan_buffer_encode_i32_avx2 (_mm256_loadu_ps (values + i), vscale, voffset, vhigh);
+
+      _mm256_storeu_si256 ((__m256i *)(raw32 + i), codes);
+    }
+
+  return i;
+}
+
+static void HYSCAN_BUFFER_AVX2
+hyscan_buffer_encode_adc14le_avx2 (gpointer      raw,
+                                   const gfloat *values,
+                                   gsize         n_values)
+{
+  guint16 *raw16 = raw;
+  gsize i;
+
+  i = hyscan_buffer_encode_u16_avx2 (raw16, values, n_values, 8192.0f, 1.0f, 16383.0f);
+  hyscan_buffer_encode_adc14le_scalar (raw16 + i, values + i, n_values - i);
+}
+
+static void HYSCAN_BUFFER_AVX2
+hyscan_buffer_encode_adc16le_avx2 (gpointer      raw,
+                                   const gfloat *values,
+                                   gsize         n_values)
+{
+  guint16 *raw16 = raw;
+  gsize i;
+
+  i = hyscan_buffer_encode_u16_avx2 (raw16, values, n_values, 32768.0f, 1.0f, 65535.0f);
+  hyscan_buffer_encode_adc16le_scalar (raw16 + i, values + i, n_values - i);
+}
+
+static void HYSCAN_BUFFER_AVX2
+hyscan_buffer_encode_adc24le_avx2 (gpointer      raw,
+                                   const gfloat *values,
+                                   gsize         n_values)
+{
+  guint32 *raw32 = raw;
+  gsize i;
+
+  i = hyscan_buffer_encode_u24_avx2 (raw32, values, n_values, 8388608.0f, 1.0f);
+  hyscan_buffer_encode_adc24le_scalar (raw32 + i, values + i, n_values - i);
+}
+
+static void HYSCAN_BUFFER_AVX2
+hyscan_buffer_encode_int8_avx2 (gpointer      raw,
+                                const gfloat *values,
+                                gsize         n_values)
+{
+  guint8 *raw8 = raw;
+  const __m256 vscale = _mm256_set1_ps (256.0f);
+  const __m256 voffset = _mm256_setzero_ps ();
+  const __m256 vhigh = _mm256_set1_ps (255.0f);
+  gsize i;
+
+  for (i = 0; i + 16 <= n_values; i += 16)
+    {
+      __m256i lo = hyscan_buffer_encode_i32_avx2 (_mm256_loadu_ps (values + i), vscale, voffset, vhigh);
+      __m256i hi = hyscan_buffer_encode_i32_avx2 (_mm256_loadu_ps (values + i + 8), vscale, voffset, vhigh);
+      __m256i codes = hyscan_buffer_pack_u16_avx2 (lo, hi);
+
+      _mm_storeu_si128 ((__m128i *)(raw8 + i), _mm_packus_epi16 (_mm256_castsi256_si128 (codes),
+                                                                 _mm256_extracti128_si256 (codes, 1)));
+    }
+
+  hyscan_buffer_encode_int8_scalar (raw8 + i, values + i, n_values - i);
+}
+
+static void HYSCAN_BUFFER_AVX2
+hyscan_buffer_encode_int16le_avx2 (gpointer      raw,
+                                   const gfloat *values,
+                                   gsize         n_values)
+{
+  guint16 *raw16 = raw;
+  gsize i;
+
+  i = hyscan_buffer_encode_u16_avx2 (raw16, values, n_values, 65536.0f, 0.0f, 65535.0f);
+  hyscan_buffer_encode_int16le_scalar (raw16 + i, values + i, n_values - i);
+}
+
+static void HYSCAN_BUFFER_AVX2
+hyscan_buffer_encode_int24le_avx2 (gpointer      raw,
+                                   const gfloat *values,
+                                   gsize         n_values)
+{
+  guint32 *raw32 = raw;
+  gsize i;
+
+  i = hyscan_buffer_encode_u24_avx2 (raw32, values, n_values, 16777215.0f, 0.0f);
+  hyscan_buffer_encode_int24le_scalar (raw32 + i, values + i, n_values - i);
+}
+
+
+/* Младшие 3 байта каждого числа собираются в начале половин вектора, после
+ * чего половины сдвигаются друг к другу и записываются 24 байтами. */
+static inline void HYSCAN_BUFFER_AVX2
+hyscan_buffer_store_u24_avx2 (guint8  *dst,
+                              __m256i  codes)
+{
+  const __m256i vshuffle = _mm256_setr_epi8 (0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+                                             0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+  const __m256i vperm = _mm256_setr_epi32 (0, 1, 2, 4, 5, 6, 7, 7);
+  __m256i bytes = _mm256_permutevar8x32_epi32 (_mm256_shuffle_epi8 (codes, vshuffle), vperm);
+
+  _mm_storeu_si128 ((__m128i *)dst, _mm256_castsi256_si128 (bytes));
+  _mm_storel_epi64 ((__m128i *)(dst + 16), _mm256_extracti128_si256 (bytes, 1));
+}
+
+static inline gsize HYSCAN_BUFFER_AVX2
+hyscan_buffer_encode_u24_packed_avx2 (guint8        *raw8,
+                                      const gfloat  *values,
+                                      gsize          n_values,
+                                      gfloat         scale,
+                                      gfloat         offset)
+{
+  const __m256 vscale = _mm256_set1_ps (scale);
+  const __m256 voffset = _mm256_set1_ps (offset);
+  const __m256 vhigh = _mm256_set1_ps (16777215.0f);
+  gsize i;
+
+  for (i = 0; i + 8 <= n_values; i += 8)
+    {
+      __m256i codes = hyscan_buffer_encode_i32_avx2 (_mm256_loadu_ps (values + i), vscale, voffset, vhigh);
+
+      hyscan_buffer_store_u24_avx2 (raw8 + 3 * i, codes);
+    }
+
+  return i;
+}
+
+static void HYSCAN_BUFFER_AVX2
+hyscan_buffer_encode_adc24le_packed_avx2 (gpointer      raw,
+                                          const gfloat *values,
+                                          gsize         n_values)
+{
+  guint8 *raw8 = raw;
+  gsize i;
+
+  i = hyscan_buffer_encode_u24_packed_avx2 (raw8, values, n_values, 8388608.0f, 1.0f);
+  hyscan_buffer_encode_adc24le_packed_scalar (raw8 + 3 * i, values + i, n_values - i);
+}
+
+static void HYSCAN_BUFFER_AVX2
+hyscan_buffer_encode_int24le_packed_avx2 (gpointer      raw,
+                                          const gfloat *values,
+                                          gsize         n_values)
+{
+  guint8 *raw8 = raw;
+  gsize i;
+
+  i = hyscan_buffer_encode_u24_packed_avx2 (raw8, values, n_values, 16777215.0f, 0.0f);
+  hyscan_buffer_encode_int24le_packed_scalar (raw8 + 3 * i, values + i, n_values - i);
+}
+
+static void HYSCAN_BUFFER_AVX2
+hyscan_buffer_encode_adc12le_avx2 (gpointer      raw,
+                                   const gfloat *values,
+                                   gsize         n_values)
+{
+  guint16 *raw16 = raw;
+  gsize i;
+
+  i = hyscan_buffer_encode_u16_avx2 (raw16, values, n_values, 2048.0f, 1.0f, 4095.0f);
+  hyscan_buffer_encode_adc12le_scalar (raw16 + i, values + i, n_values - i);
+}
+
+/* Разделение чётных и нечётных значений выполняется внутри 128-ми битных
+ * половин, после чего 64-х битные части переставляются по порядку. */
+static void HYSCAN_BUFFER_AVX2
+hyscan_buffer_encode_adc12le_packed_avx2 (gpointer      raw,
+                                          const gfloat *values,
+                                          gsize         n_values)
+{
+  guint8 *raw8 = raw;
+  const __m256 vscale = _mm256_set1_ps (2048.0f);
+  const __m256 voffset = _mm256_set1_ps (1.0f);
+  const __m256 vhigh = _mm256_set1_ps (4095.0f);
+  gsize i;
+
+  for (i = 0; i + 16 <= n_values; i += 16)
+    {
+      __m256 lo = _mm256_castsi256_ps (hyscan_buffer_encode_i32_avx2 (_mm256_loadu_ps (values + i), vscale, voffset, vhigh));
+      __m256 hi = _mm256_castsi256_ps (hyscan_buffer_encode_i32_avx2 (_mm256_loadu_ps (values + i + 8), vscale, voffset, vhigh));
+      __m256i first = _mm256_castps_si256 (_mm256_shuffle_ps (lo, hi, _MM_SHUFFLE (2, 0, 2, 0)));
+      __m256i second = _mm256_castps_si256 (_mm256_shuffle_ps (lo, hi, _MM_SHUFFLE (3, 1, 3, 1)));
+      __m256i words = _mm256_or_si256 (first, _mm256_slli_epi32 (second, 12));
+
+      hyscan_buffer_store_u24_avx2 (raw8 + 3 * (i / 2), _mm256_permute4x64_epi64 (words, 0xd8));
+    }
+
+  hyscan_buffer_encode_adc12le_packed_scalar (raw8 + 3 * (i / 2), values + i, n_values - i);
+}
+
+static inline __m256i HYSCAN_BUFFER_AVX2
+hyscan_buffer_float_to_bfloat_avx2 (__m256 values)
+{
+  const __m256i vabsmask = _mm256_set1_epi32 (0x7fffffff);
+  const __m256i vinf = _mm256_set1_epi32 (0x7f800000);
+  const __m256i vround = _mm256_set1_epi32 (0x7fff);
+  const __m256i vone = _mm256_set1_epi32 (1);
+  const __m256i vquiet = _mm256_set1_epi32 (0x0040);
+  __m256i bits = _mm256_castps_si256 (values);
+  __m256i high = _mm256_srli_epi32 (bits, 16);
+  __m256i nan = _mm256_cmpgt_epi32 (_mm256_and_si256 (bits, vabsmask), vinf);
+  __m256i rounded = _mm256_srli_epi32 (_mm256_add_epi32 (bits, _mm256_add_epi32 (vround, _mm256_and_si256 (high, vone))), 16);
+
+  return _mm256_blendv_epi8 (rounded, _mm256_or_si256 (high, vquiet), nan);
+}
+
+static void HYSCAN_BUFFER_AVX2
+hyscan_buffer_encode_bfloat16le_avx2 (gpointer      raw,
+                                      const gfloat *values,
+                                      gsize         n_values)
+{
+  guint16 *raw16 = raw;
+  gsize i;
+
+  for (i = 0; i + 16 <= n_values; i += 16)
+    {
+      __m256i lo = hyscan_buffer_float_to_bfloat_avx2 (_mm256_loadu_ps (values + i));
+      __m256i hi = hyscan_buffer_float_to_bfloat_avx2 (_mm256_loadu_ps (values + i + 8));
+
+      _mm256_storeu_si256 ((__m256i *)(raw16 + i), hyscan_buffer_pack_u16_avx2 (lo, hi));
+    }
+
+  hyscan_buffer_encode_bfloat16le_scalar (raw16 + i, values + i, n_values - i);
+}
+
+static void HYSCAN_BUFFER_AVX2
+hyscan_buffer_encode_int32le_avx2 (gpointer      raw,
+                                   const gfloat *values,
+                                   gsize         n_values)
+{
+  guint32 *raw32 = raw;
+  const __m256 vscale = _mm256_set1_ps (4294967296.0f);
+  const __m256 vtwo31 = _mm256_set1_ps (2147483648.0f);
+  const __m256 vtwo32 = _mm256_set1_ps (4294967296.0f);
+  gsize i;
+
+  for (i = 0; i + 8 <= n_values; i += 8)
+    {
+      __m256 value = _mm256_max_ps (_mm256_mul_ps (vscale, _mm256_loadu_ps (values + i)), _mm256_setzero_ps ());
+      __m256 big = _mm256_cmp_ps (value, vtwo32, _CMP_GE_OQ);
+      __m256 high = _mm256_cmp_ps (value, vtwo31, _CMP_GE_OQ);
+      __m256i codes;
+
+      codes = _mm256_cvttps_epi32 (_mm256_sub_ps (value, _mm256_and_ps (high, vtwo31)));
+      codes = _mm256_xor_si256 (codes, _mm256_slli_epi32 (_mm256_castps_si256 (high), 31));
+      codes = _mm256_or_si256 (codes, _mm256_castps_si256 (big));
+
+      _mm256_storeu_si256 ((__m256i *)(raw32 + i), codes);
+    }
+
+  hyscan_buffer_encode_int32le_scalar (raw32 + i, values + i, n_values - i);
+}
+
+static inline __m256i HYSCAN_BUFFER_AVX2
+hyscan_buffer_float_to_half_avx2 (__m256 values)
+{
+  const __m256i vabsmask = _mm256_set1_epi32 (0x7fffffff);
+  const __m256i vbias = _mm256_set1_epi32 (112 << 10);
+  const __m256i vmant = _mm256_set1_epi32 (0x3ff);
+  const __m256i vinf = _mm256_set1_epi32 (0x7c00);
+  const __m256i vmin_normal = _mm256_set1_epi32 (0x38800000);
+  const __m256i vmax_normal = _mm256_set1_epi32 (0x477fffff);
+  const __m256i vmax_finite = _mm256_set1_epi32 (0x7f7fffff);
+  const __m256 vdenormal_scale = _mm256_set1_ps (16777216.0f);
+  __m256i bits, abs, sign, normal, denormal, nan;
+  __m256i is_denormal, is_big, is_nan, codes;
+
+  bits = _mm256_castps_si256 (values);
+  abs = _mm256_and_si256 (bits, vabsmask);
+  sign = _mm256_srli_epi32 (_mm256_andnot_si256 (vabsmask, bits), 16);
+
+  normal = _mm256_sub_epi32 (_mm256_srli_epi32 (abs, 13), vbias);
+  denormal = _mm256_cvttps_epi32 (_mm256_mul_ps (_mm256_castsi256_ps (abs), vdenormal_scale));
+  nan = _mm256_or_si256 (vinf, _mm256_and_si256 (_mm256_srli_epi32 (abs, 13), vmant));
+
+  is_denormal = _mm256_cmpgt_epi32 (vmin_normal, abs);
+  is_big = _mm256_cmpgt_epi32 (abs, vmax_normal);
+  is_nan = _mm256_cmpgt_epi32 (abs, vmax_finite);
+
+  codes = _mm256_blendv_epi8 (normal, denormal, is_denormal);
+  codes = _mm256_blendv_epi8 (codes, vinf, is_big);
+  codes = _mm256_blendv_epi8 (codes, nan, is_nan);
+
+  return _mm256_or_si256 (codes, sign);
+}
+
+static void HYSCAN_BUFFER_AVX2
+hyscan_buffer_encode_float16le_avx2 (gpointer      raw,
+                                     const gfloat *values,
+                                     gsize         n_values)
+{
+  guint16 *raw16 = raw;
+  gsize i;
+
+  for (i = 0; i + 16 <= n_values; i += 16)
+    {
+      __m256i lo = hyscan_buffer_float_to_half_avx2 (_mm256_loadu_ps (values + i));
+      __m256i hi = hyscan_buffer_float_to_half_avx2 (_mm256_loadu_ps (values + i + 8));
+
+      _mm256_storeu_si256 ((__m256i *)(raw16 + i), hyscan_buffer_pack_u16_avx2 (lo, hi));
+    }
+
+  hyscan_buffer_encode_float16le_scalar (raw16 + i, values + i, n_values - i);
+}
+
+/* Функции преобразования float16 с использованием инструкций F16C.
+ *
+ * Аппаратное преобразование отличается от табличного в нескольких случаях,
+ * которые исправляются после преобразования:
+ * - при декодировании сигнальный NaN становится тихим (устанавливается
+ *   старший бит мантиссы);
+ * - при кодировании с отбрасыванием дробной части числа больше 65504
+ *   становятся максимальным конечным числом, а не бесконечностью;
+ * - при кодировании NaN становится тихим.
+ * Для всех остальных значений, включая денормализованные, результат совпадает. */
+
+static void HYSCAN_BUFFER_F16C
+hyscan_buffer_decode_float16le_f16c (gfloat        *values,
+                                     gconstpointer  raw,
+                                     gsize          n_values)
+{
+  const guint16 *raw16 = raw;
+  const __m256i vnosign = _mm256_set1_epi32 (0x7fff);
+  const __m256i vinf = _mm256_set1_epi32 (0x7c00);
+  const __m256i vqnan = _mm256_set1_epi32 (0x7e00);
+  const __m256i vquiet = _mm256_set1_epi32 (0x00400000);
+  gsize i;
+
+  for (i = 0; i + 8 <= n_values; i += 8)
+    {
+      __m128i codes = _mm_loadu_si128 ((const __m128i *)(raw16 + i));
+      __m256i expmant = _mm256_and_si256 (_mm256_cvtepu16_epi32 (codes), vnosign);
+      __m256i snan = _mm256_and_si256 (_mm256_cmpgt_epi32 (expmant, vinf), _mm256_cmpgt_epi32 (vqnan, expmant));
+      __m256 value = _mm256_cvtph_ps (codes);
+
+      value = _mm256_andnot_ps (_mm256_castsi256_ps (_mm256_and_si256 (snan, vquiet)), value);
+
+      _mm256_storeu_ps (values + i, value);
+    }
+
+  hyscan_buffer_decode_float16le_scalar (values + i, raw16 + i, n_values - i);
+}
+
+static inline __m256i HYSCAN_BUFFER_F16C
+hyscan_buffer_float_to_half_f16c (__m256 values)
+{
+  const __m256i vabsmask = _mm256_set1_epi32 (0x7fffffff);
+  const __m256i vmant = _mm256_set1_epi32 (0x3ff);
+  const __m256i vinf = _mm256_set1_epi32 (0x7c00);
+  const __m256i vmax_normal = _mm256_set1_epi32 (0x477fffff);
+  const __m256i vmax_finite = _mm256_set1_epi32 (0x7f7fffff);
+  __m256i bits, abs, sign, nan, big, codes;
+
+  bits = _mm256_castps_si256 (values);
+  abs = _mm256_and_si256 (bits, vabsmask);
+  sign = _mm256_srli_epi32 (_mm256_andnot_si256 (vabsmask, bits), 16);
+
+  codes = _mm256_cvtepu16_epi32 (_mm256_cvtps_ph (values, _MM_FROUND_TO_ZERO));
+
+  nan = _mm256_and_si256 (_mm256_cmpgt_epi32 (abs, vmax_finite), _mm256_srli_epi32 (abs, 13));
+  big = _mm256_or_si256 (_mm256_or_si256 (vinf, sign), _mm256_and_si256 (nan, vmant));
+
+  return _mm256_blendv_epi8 (codes, big, _mm256_cmpgt_epi32 (abs, vmax_normal));
+}
+
+static void HYSCAN_BUFFER_F16C
+hyscan_buffer_encode_float16le_f16c (gpointer      raw,
+                                     const gfloat *values,
+                                     gsize         n_values)
+{
+  guint16 *raw16 = raw;
+  gsize i;
+
+  for (i = 0; i + 16 <= n_values; i += 16)
+    {
+      __m256i lo = hyscan_buffer_float_to_half_f16c (_mm256_loadu_ps (values + i));
+      __m256i hi = hyscan_buffer_float_to_half_f16c (_mm256_loadu_ps (values + i + 8));
+
+      _mm256_storeu_si256 ((__m256i *)(raw16 + i), hyscan_buffer_pack_u16_avx2 (lo, hi));
+    }
+
+  hyscan_buffer_encode_float16le_scalar (raw16 + i, values + i, n_values - i);
+}
+
+/* Функции вычисления амплитуды. Действительные и мнимые части разделяются
+ * перестановкой, результат записывается не раньше, чем прочитаны исходные
+ * данные, поэтому массивы могут совпадать. */
+
+static void HYSCAN_BUFFER_SSE2
+hyscan_buffer_amplitude_sse2 (gfloat       *amplitude,
+                              const gfloat *values,
+                              gsize         n_points)
+{
+  gsize i;
+
+  for (i = 0; i + 4 <= n_points; i += 4)
+    {
+      __m128 lo = _mm_loadu_ps (values + 2 * i);
+      __m128 hi = _mm_loadu_ps (values + 2 * i + 4);
+      __m128 re = _mm_shuffle_ps (lo, hi, _MM_SHUFFLE (2, 0, 2, 0));
+      __m128 im = _mm_shuffle_ps (lo, hi, _MM_SHUFFLE (3, 1, 3, 1));
+
+      re = _mm_add_ps (_mm_mul_ps (re, re), _mm_mul_ps (im, im));
+      _mm_storeu_ps (amplitude + i, _mm_sqrt_ps (re));
+    }
+
+  hyscan_buffer_amplitude_scalar (amplitude + i, values + 2 * i, n_points - i);
+}
+
+static void HYSCAN_BUFFER_AVX2
+hyscan_buffer_amplitude_avx2 (gfloat       *amplitude,
+                              const gfloat *values,
+                              gsize         n_points)
+{
+  gsize i;
+
+  for (i = 0; i + 8 <= n_points; i += 8)
+    {
+      __m256 lo = _mm256_loadu_ps (values + 2 * i);
+      __m256 hi = _mm256_loadu_ps (values + 2 * i + 8);
+      __m256 re = _mm256_shuffle_ps (lo, hi, _MM_SHUFFLE (2, 0, 2, 0));
+      __m256 im = _mm256_shuffle_ps (lo, hi, _MM_SHUFFLE (3, 1, 3, 1));
+      __m256 sum;
+
+      sum = _mm256_add_ps (_mm256_mul_ps (re, re), _mm256_mul_ps (im, im));
+      sum = _mm256_castpd_ps (_mm256_permute4x64_pd (_mm256_castps_pd (sum), 0xd8));
+      _mm256_storeu_ps (amplitude + i, _mm256_sqrt_ps (sum));
+    }
+
+  hyscan_buffer_amplitude_scalar (amplitude + i, values + 2 * i, n_points - i);
+}
+
+#endif /* HYSCAN_BUFFER_X86 */
+
+#ifdef HYSCAN_BUFFER_NEON
+
+/* Функции декодирования NEON. */
+
+static inline gsize
+hyscan_buffer_decode_u16_neon (gfloat         *values,
+                               const guint16  *raw16,
+                               gsize           n_values,
+                               guint16         mask,
+                               gfloat          scale,
+                               gfloat          offset)
+{
+  const uint16x8_t vmask = vdupq_n_u16 (mask);
+  const float32x4_t vscale = vdupq_n_f32 (scale);
+  const float32x4_t voffset = vdupq_n_f32 (offset);
+  gsize i;
+
+  for (i = 0; i + 8 <= n_values; i += 8)
+    {
+      uint16x8_t codes = vandq_u16 (vld1q_u16 (raw16 + i), vmask);
+      float32x4_t lo = vcvtq_f32_u32 (vmovl_u16 (vget_low_u16 (codes)));
+      float32x4_t hi = vcvtq_f32_u32 (vmovl_u16 (vget_high_u16 (codes)));
+
+      vst1q_f32 (values + i,     vsubq_f32 (vmulq_f32 (vscale, lo), voffset));
+      vst1q_f32 (values + i + 4, vsubq_f32 (vmulq_f32 (vscale, hi), voffset));
+    }
+
+  return i;
+}
+
+static inline gsize
+hyscan_buffer_decode_u32_neon (gfloat         *values,
+                               const guint32  *raw32,
+                               gsize           n_values,
+                               guint32         mask,
+                               gfloat          scale,
+                               gfloat          offset)
+{
+  const uint32x4_t vmask = vdupq_n_u32 (mask);
+  const float32x4_t vscale = vdupq_n_f32 (scale);
+  const float32x4_t voffset = vdupq_n_f32 (offset);
+  gsize i;
+
+  for (i = 0; i + 4 <= n_values; i += 4)
+    {
+      float32x4_t value = vcvtq_f32_u32 (vandq_u32 (vld1q_u32 (raw32 + i), vmask));
+
+      vst1q_f32 (values + i, vsubq_f32 (vmulq_f32 (vscale, value), voffset));
+    }
+
+  return i;
+}
+
+static void
+hyscan_buffer_decode_adc14le_neon (gfloat        *values,
+                                   gconstpointer  raw,
+                                   gsize          n_values)
+{
+  const guint16 *raw16 = raw;
+  gsize i;
+
+  i = hyscan_buffer_decode_u16_neon (values, raw16, n_values, 0x3fff, 2.0f / 16383.0f, 1.0f);
+  hyscan_buffer_decode_adc14le_scalar (values + i, raw16 + i, n_values - i);
+}
+
+static void
+hyscan_buffer_decode_adc16le_neon (gfloat        *values,
+                                   gconstpointer  raw,
+                                   gsize          n_values)
+{
+  const guint16 *raw16 = raw;
+  gsize i;
+
+  i = hyscan_buffer_decode_u16_neon (values, raw16, n_values, 0xffff, 2.0f / 65535.0f, 1.0f);
+  hyscan_buffer_decode_adc16le_scalar (values + i, raw16 + i, n_values - i);
+}
+
+static void
+hyscan_buffer_decode_adc24le_neon (gfloat        *values,
+                                   gconstpointer  raw,
+                                   gsize          n_values)
+{
+  const guint32 *raw32 = raw;
+  gsize i;
+
+  i = hyscan_buffer_decode_u32_neon (values, raw32, n_values, 0x00ffffff, 2.0f / 16777215.0f, 1.0f);
+  hyscan_buffer_decode_adc24le_scalar (values + i, raw32 + i, n_values - i);
+}
+
+static void
+hyscan_buffer_decode_int8_neon (gfloat        *values,
+                                gconstpointer  raw,
+                                gsize          n_values)
+{
+  const guint8 *raw8 = raw;
+  const float32x4_t vscale = vdupq_n_f32 (1.0f / 255.0f);
+  gsize i;
+
+  for (i = 0; i + 16 <= n_values; i += 16)
+    {
+      uint8x16_t codes = vld1q_u8 (raw8 + i);
+      uint16x8_t lo16 = vmovl_u8 (vget_low_u8 (codes));
+      uint16x8_t hi16 = vmovl_u8 (vget_high_u8 (codes));
+
+      vst1q_f32 (values + i,      vmulq_f32 (vscale, vcvtq_f32_u32 (vmovl_u16 (vget_low_u16 (lo16)))));
+      vst1q_f32 (values + i + 4,  vmulq_f32 (vscale, vcvtq_f32_u32 (vmovl_u16 (vget_high_u16 (lo16)))));
+      vst1q_f32 (values + i + 8,  vmulq_f32 (vscale, vcvtq_f32_u32 (vmovl_u16 (vget_low_u16 (hi16)))));
+      vst1q_f32 (values + i + 12, vmulq_f32 (vscale, vcvtq_f32_u32 (vmovl_u16 (vget_high_u16 (hi16)))));
+    }
+
+  hyscan_buffer_decode_int8_scalar (values + i, raw8 + i, n_values - i);
+}
+
+static void
+hyscan_buffer_decode_int16le_neon (gfloat        *values,
+                                   gconstpointer  raw,
+                                   gsize          n_values)
+{
+  const guint16 *raw16 = raw;
+  gsize i;
+
+  i = hyscan_buffer_decode_u16_neon (values, raw16, n_values, 0xffff, 1.0f / 65536.0f, 0.0f);
+  hyscan_buffer_decode_int16le_scalar (values + i, raw16 + i, n_values - i);
+}
+
+static void
+hyscan_buffer_decode_int24le_neon (gfloat        *values,
+                                   gconstpointer  raw,
+                                   gsize          n_values)
+{
+  const guint32 *raw32 = raw;
+  gsize i;
+
+  i = hyscan_buffer_decode_u32_neon (values, raw32, n_values, 0x00ffffff, 1.0f / 16777215.0f, 0.0f);
+  hyscan_buffer_decode_int24le_scalar (values + i, raw32 + i, n_values - i);
+}
+
+
+/* Упакованные значения загружаются с разделением байт по трём векторам. */
+static inline gsize
+hyscan_buffer_decode_u24_packed_neon (gfloat         *values,
+                                      const guint8   *raw8,
+                                      gsize           n_values,
+                                      gfloat          scale,
+                                      gfloat          offset)
+{
+  const float32x4_t vscale = vdupq_n_f32 (scale);
+  const float32x4_t voffset = vdupq_n_f32 (offset);
+  gsize i;
+
+  for (i = 0; i + 8 <= n_values; i += 8)
+    {
+      uint8x8x3_t bytes = vld3_u8 (raw8 + 3 * i);
+      uint16x8_t low16 = vorrq_u16 (vmovl_u8 (bytes.val[0]), vshlq_n_u16 (vmovl_u8 (bytes.val[1]), 8));
+      uint16x8_t high16 = vmovl_u8 (bytes.val[2]);
+      uint32x4_t lo = vorrq_u32 (vmovl_u16 (vget_low_u16 (low16)), vshlq_n_u32 (vmovl_u16 (vget_low_u16 (high16)), 16));
+      uint32x4_t hi = vorrq_u32 (vmovl_u16 (vget_high_u16 (low16)), vshlq_n_u32 (vmovl_u16 (vget_high_u16 (high16)), 16));
+
+      vst1q_f32 (values + i,     vsubq_f32 (vmulq_f32 (vscale, vcvtq_f32_u32 (lo)), voffset));
+      vst1q_f32 (values + i + 4, vsubq_f32 (vmulq_f32 (vscale, vcvtq_f32_u32 (hi)), voffset));
+    }
+
+  return i;
+}
+
+static void
+hyscan_buffer_decode_adc24le_packed_neon (gfloat        *values,
+                                          gconstpointer  raw,
+                                          gsize          n_values)
+{
+  const guint8 *raw8 = raw;
+  gsize i;
+
+  i = hyscan_buffer_decode_u24_packed_neon (values, raw8, n_values, 2.0f / 16777215.0f, 1.0f);
+  hyscan_buffer_decode_adc24le_packed_scalar (values + i, raw8 + 3 * i, n_values - i);
+}
+
+static void
+hyscan_buffer_decode_int24le_packed_neon (gfloat        *values,
+                                          gconstpointer  raw,
+                                          gsize          n_values)
+{
+  const guint8 *raw8 = raw;
+  gsize i;
+
+  i = hyscan_buffer_decode_u24_packed_neon (values, raw8, n_values, 1.0f / 16777215.0f, 0.0f);
+  hyscan_buffer_decode_int24le_packed_scalar (values + i, raw8 + 3 * i, n_values - i);
+}
+
+static void
+hyscan_buffer_decode_adc12le_neon (gfloat        *values,
+                                   gconstpointer  raw,
+                                   gsize          n_values)
+{
+  const guint16 *raw16 = raw;
+  gsize i;
+
+  i = hyscan_buffer_decode_u16_neon (values, raw16, n_values, 0x0fff, 2.0f / 4095.0f, 1.0f);
+  hyscan_buffer_decode_adc12le_scalar (values + i, raw16 + i, n_values - i);
+}
+
+/* Байты пар значений разделяются по трём векторам, значения собираются из
+ * них сдвигами и записываются с чередованием. */
+static void
+hyscan_buffer_decode_adc12le_packed_neon (gfloat        *values,
+                                          gconstpointer  raw,
+                                          gsize          n_values)
+{
+  const guint8 *raw8 = raw;
+  const uint16x8_t vmask = vdupq_n_u16 (0x0f);
+  const float32x4_t vscale = vdupq_n_f32 (2.0f / 4095.0f);
+  const float32x4_t voffset = vdupq_n_f32 (1.0f);
+  gsize i;
+
+  for (i = 0; i + 16 <= n_values; i += 16)
+    {
+      uint8x8x3_t bytes = vld3_u8 (raw8 + 3 * (i / 2));
+      uint16x8_t b0 = vmovl_u8 (bytes.val[0]);
+      uint16x8_t b1 = vmovl_u8 (bytes.val[1]);
+      uint16x8_t b2 = vmovl_u8 (bytes.val[2]);
+      uint16x8_t first = vorrq_u16 (b0, vshlq_n_u16 (vandq_u16 (b1, vmask), 8));
+      uint16x8_t second = vorrq_u16 (vshrq_n_u16 (b1, 4), vshlq_n_u16 (b2, 4));
+      float32x4x2_t lo;
+      float32x4x2_t hi;
+
+      lo.val[0] = vsubq_f32 (vmulq_f32 (vscale, vcvtq_f32_u32 (vmovl_u16 (vget_low_u16 (first)))), voffset);
+      lo.val[1] = vsubq_f32 (vmulq_f32 (vscale, vcvtq_f32_u32 (vmovl_u16 (vget_low_u16 (second)))), voffset);
+      hi.val[0] = vsubq_f32 (vmulq_f32 (vscale, vcvtq_f32_u32 (vmovl_u16 (vget_high_u16 (first)))), voffset);
+      hi.val[1] = vsubq_f32 (vmulq_f32 (vscale, vcvtq_f32_u32 (vmovl_u16 (vget_high_u16 (second)))), voffset);
+
+      vst2q_f32 (values + i, lo);
+      vst2q_f32 (values + i + 8, hi);
+    }
+
+  hyscan_buffer_decode_adc12le_packed_scalar (values + i, raw8 + 3 * (i / 2), n_values - i);
+}
+
+static void
+hyscan_buffer_decode_bfloat16le_neon (gfloat        *values,
+                                      gconstpointer  raw,
+                                      gsize          n_values)
+{
+  const guint16 *raw16 = raw;
+  gsize i;
+
+  for (i = 0; i + 8 <= n_values; i += 8)
+    {
+      uint16x8_t codes = vld1q_u16 (raw16 + i);
+
+      vst1q_f32 (values + i,     vreinterpretq_f32_u32 (vshlq_n_u32 (vmovl_u16 (vget_low_u16 (codes)), 16)));
+      vst1q_f32 (values + i + 4, vreinterpretq_f32_u32 (vshlq_n_u32 (vmovl_u16 (vget_high_u16 (codes)), 16)));
+    }
+
+  hyscan_buffer_decode_bfloat16le_scalar (values + i, raw16 + i, n_values - i);
+}
+
+/* В отличие от SSE2 и AVX2, в NEON есть преобразование беззнаковых
+ * 32-х битных чисел с округлением до ближайшего. */
+static void
+hyscan_buffer_decode_int32le_neon (gfloat        *values,
+                                   gconstpointer  raw,
+                                   gsize          n_values)
+{
+  const guint32 *raw32 = raw;
+  const float32x4_t vscale = vdupq_n_f32 (1.0f / 4294967295.0f);
+  gsize i;
+
+  for (i = 0; i + 4 <= n_values; i += 4)
+    vst1q_f32 (values + i, vmulq_f32 (vscale, vcvtq_f32_u32 (vld1q_u32 (raw32 + i))));
+
+  hyscan_buffer_decode_int32le_scalar (values + i, raw32 + i, n_values - i);
+}
+
+#ifdef __aarch64__
+/* В AArch64 преобразование float16 <-> float32 выполняется аппаратно. Как и в
+ * F16C, сигнальный NaN при декодировании становится тихим, что исправляется
+ * после преобразования. В режиме AArch32 NEON всегда обнуляет
+ * денормализованные числа, поэтому используются таблицы. */
+static void
+hyscan_buffer_decode_float16le_fp16 (gfloat        *values,
+                                     gconstpointer  raw,
+                                     gsize          n_values)
+{
+  const guint16 *raw16 = raw;
+  const uint32x4_t vnosign = vdupq_n_u32 (0x7fff);
+  const uint32x4_t vinf = vdupq_n_u32 (0x7c00);
+  const uint32x4_t vqnan = vdupq_n_u32 (0x7e00);
+  const uint32x4_t vquiet = vdupq_n_u32 (0x00400000);
+  gsize i;
+
+  for (i = 0; i + 4 <= n_values; i += 4)
+    {
+      uint16x4_t codes = vld1_u16 (raw16 + i);
+      uint32x4_t expmant = vandq_u32 (vmovl_u16 (codes), vnosign);
+      uint32x4_t snan = vandq_u32 (vcgtq_u32 (expmant, vinf), vcgtq_u32 (vqnan, expmant));
+      uint32x4_t value = vreinterpretq_u32_f32 (vcvt_f32_f16 (vreinterpret_f16_u16 (codes)));
+
+      vst1q_u32 ((guint32 *)(values + i), vbicq_u32 (value, vandq_u32 (snan, vquiet)));
+    }
+
+  hyscan_buffer_decode_float16le_scalar (values + i, raw16 + i, n_values - i);
+}
+#endif /* __aarch64__ */
+
+/* Функции кодирования NEON. Преобразование в беззнаковое целое в NEON
+ * выполняется с насыщением: отрицательные значения и NaN становятся нулём,
+ * значения не меньше 2^32 - максимальным числом. Поэтому достаточно
+ * ограничить значение сверху. */
+
+static inline uint32x4_t
+hyscan_buffer_encode_u32_neon (float32x4_t values,
+                               float32x4_t vscale,
+                               float32x4_t voffset,
+                               float32x4_t vhigh)
+{
+  float32x4_t value = vmulq_f32 (vscale, vaddq_f32 (values, voffset));
+
+  return vcvtq_u32_f32 (vminq_f32 (value, vhigh));
+}
+
+static inline gsize
+hyscan_buffer_encode_u16_neon (guint16       *raw16,
+                               const gfloat  *values,
+                               gsize          n_values,
+                               gfloat         scale,
+                               gfloat         offset,
+                               gfloat         high)
+{
+  const float32x4_t vscale = vdupq_n_f32 (scale);
+  const float32x4_t voffset = vdupq_n_f32 (offset);
+  const float32x4_t vhigh = vdupq_n_f32 (high);
+  gsize i;
+
+  for (i = 0; i + 8 <= n_values; i += 8)
+    {
+      uint32x4_t lo = hyscan_buffer_encode_u32_neon (vld1q_f32 (values + i), vscale, voffset, vhigh);
+      uint32x4_t hi = hyscan_buffer_encode_u32_neon (vld1q_f32 (values + i + 4), vscale, voffset, vhigh);
+
+      vst1q_u16 (raw16 + i, vcombine_u16 (vmovn_u32 (lo), vmovn_u32 (hi)));
+    }
+
+  return i;
+}
+
+static inline gsize
+hyscan_buffer_encode_u32_array_neon (guint32       *raw32,
+                                     const gfloat  *values,
+                                     gsize          n_values,
+                                     gfloat         scale,
+                                     gfloat         offset,
+                                     gfloat         high)
+{
+  const float32x4_t vscale = vdupq_n_f32 (scale);
+  const float32x4_t voffset = vdupq_n_f32 (offset);
+  const float32x4_t vhigh = vdupq_n_f32 (high);
+  gsize i;
+
+  for (i = 0; i + 4 <= n_values; i += 4)
+    vst1q_u32 (raw32 + i, hyscan_buffer_encode_u32_neon (vld1q_f32 (values + i), vscale, voffset, vhigh));
+
+  return i;
+}
+
+static void
+hyscan_buffer_encode_adc14le_neon (gpointer      raw,
+                                   const gfloat *values,
+                                   gsize         n_values)
+{
+  guint16 *raw16 = raw;
+  gsize i;
+
+  i = hyscan_buffer_encode_u16_neon (raw16, values, n_values, 8192.0f, 1.0f, 16383.0f);
+  hyscan_buffer_encode_adc14le_scalar (raw16 + i, values + i, n_values - i);
+}
+
+static void
+hyscan_buffer_encode_adc16le_neon (gpointer      raw,
+                                   const gfloat *values,
+                                   gsize         n_values)
+{
+  guint16 *raw16 = raw;
+  gsize i;
+
+  i = hyscan_buffer_encode_u16_neon (raw16, values, n_values, 32768.0f, 1.0f, 65535.0f);
+  hyscan_buffer_encode_adc16le_scalar (raw16 + i, values + i, n_values - i);
+}
+
+static void
+hyscan_buffer_encode_adc24le_neon (gpointer      raw,
+                                   const gfloat *values,
+                                   gsize         n_values)
+{
+  guint32 *raw32 = raw;
+  gsize i;
+
+  i = hyscan_buffer_encode_u32_array_neon (raw32, values, n_values, 8388608.0f, 1.0f, 16777215.0f);
+  hyscan_buffer_encode_adc24le_scalar (raw32 + i, values + i, n_values - i);
+}
+
+static void
+hyscan_buffer_encode_int8_neon (gpointer      raw,
+                                const gfloat *values,
+                                gsize         n_values)
+{
+  guint8 *raw8 = raw;
+  const float32x4_t vscale = vdupq_n_f32 (256.0f);
+  const float32x4_t voffset = vdupq_n_f32 (0.0f);
+  const float32x4_t vhigh = vdupq_n_f32 (255.0f);
+  gsize i;
+
+  for (i = 0; i + 16 <= n_values; i += 16)
+    {
+      uint32x4_t c0 = hyscan_buffer_encode_u32_neon (vld1q_f32 (values + i),      vscale, voffset, vhigh);
+      uint32x4_t c1 = hyscan_buffer_encode_u32_neon (vld1q_f32 (values + i + 4),  vscale, voffset, vhigh);
+      uint32x4_t c2 = hyscan_buffer_encode_u32_neon (vld1q_f32 (values + i + 8),  vscale, voffset, vhigh);
+      uint32x4_t c3 = hyscan_buffer_encode_u32_neon (vld1q_f32 (values + i + 12), vscale, voffset, vhigh);
+      uint16x8_t lo = vcombine_u16 (vmovn_u32 (c0), vmovn_u32 (c1));
+      uint16x8_t hi = vcombine_u16 (vmovn_u32 (c2), vmovn_u32 (c3));
+
+      vst1q_u8 (raw8 + i, vcombine_u8 (vmovn_u16 (lo), vmovn_u16 (hi)));
+    }
+
+  hyscan_buffer_encode_int8_scalar (raw8 + i, values + i, n_values - i);
+}
+
+static void
+hyscan_buffer_encode_int16le_neon (gpointer      raw,
+                                   const gfloat *values,
+                                   gsize         n_values)
+{
+  guint16 *raw16 = raw;
+  gsize i;
+
+  i = hyscan_buffer_encode_u16_neon (raw16, values, n_values, 65536.0f, 0.0f, 65535.0f);
+  hyscan_buffer_encode_int16le_scalar (raw16 + i, values + i, n_values - i);
+}
+
+static void
+hyscan_buffer_encode_int24le_neon (gpointer      raw,
+                                   const gfloat *values,
+                                   gsize         n_values)
+{
+  guint32 *raw32 = raw;
+  gsize i;
+
+  i = hyscan_buffer_encode_u32_array_neon (raw32, values, n_values, 16777215.0f, 0.0f, 16777215.0f);
+  hyscan_buffer_encode_int24le_scalar (raw32 + i, values + i, n_values - i);
+}
+
+
+/* Байты значений разделяются по трём векторам и записываются с чередованием. */
+static inline gsize
+hyscan_buffer_encode_u24_packed_neon (guint8        *raw8,
+                                      const gfloat  *values,
+                                      gsize          n_values,
+                                      gfloat         scale,
+                                      gfloat         offset)
+{
+  const float32x4_t vscale = vdupq_n_f32 (scale);
+  const float32x4_t voffset = vdupq_n_f32 (offset);
+  const float32x4_t vhigh = vdupq_n_f32 (16777215.0f);
+  gsize i;
+
+  for (i = 0; i + 8 <= n_values; i += 8)
+    {
+      uint32x4_t lo = hyscan_buffer_encode_u32_neon (vld1q_f32 (values + i), vscale, voffset, vhigh);
+      uint32x4_t hi = hyscan_buffer_encode_u32_neon (vld1q_f32 (values + i + 4), vscale, voffset, vhigh);
+      uint16x8_t low16 = vcombine_u16 (vmovn_u32 (lo), vmovn_u32 (hi));
+      uint16x8_t high16 = vcombine_u16 (vmovn_u32 (vshrq_n_u32 (lo, 16)), vmovn_u32 (vshrq_n_u32 (hi, 16)));
+      uint8x8x3_t bytes;
+
+      bytes.val[0] = vmovn_u16 (low16);
+      bytes.val[1] = vmovn_u16 (vshrq_n_u16 (low16, 8));
+      bytes.val[2] = vmovn_u16 (high16);
+      vst3_u8 (raw8 + 3 * i, bytes);
+    }
+
+  return i;
+}
+
+static void
+hyscan_buffer_encode_adc24le_packed_neon (gpointer      raw,
+                                          const gfloat *values,
+                                          gsize         n_values)
+{
+  guint8 *raw8 = raw;
+  gsize i;
+
+  i = hyscan_buffer_encode_u24_packed_neon (raw8, values, n_values, 8388608.0f, 1.0f);
+  hyscan_buffer_encode_adc24le_packed_scalar (raw8 + 3 * i, values + i, n_values - i);
+}
+
+static void
+hyscan_buffer_encode_int24le_packed_neon (gpointer      raw,
+                                          const gfloat *values,
+                                          gsize         n_values)
+{
+  guint8 *raw8 = raw;
+  gsize i;
+
+  i = hyscan_buffer_encode_u24_packed_neon (raw8, values, n_values, 16777215.0f, 0.0f);
+  hyscan_buffer_encode_int24le_packed_scalar (raw8 + 3 * i, values + i, n_values - i);
+}
+
+static void
+hyscan_buffer_encode_adc12le_neon (gpointer      raw,
+                                   const gfloat *values,
+                                   gsize         n_values)
+{
+  guint16 *raw16 = raw;
+  gsize i;
+
+  i = hyscan_buffer_encode_u16_neon (raw16, values, n_values, 2048.0f, 1.0f, 4095.0f);
+  hyscan_buffer_encode_adc12le_scalar (raw16 + i, values + i, n_values - i);
+}
+
+static void
+hyscan_buffer_encode_adc12le_packed_neon (gpointer      raw,
+                                          const gfloat *values,
+                                          gsize         n_values)
+{
+  guint8 *raw8 = raw;
+  const float32x4_t vscale = vdupq_n_f32 (2048.0f);
+  const float32x4_t voffset = vdupq_n_f32 (1.0f);
+  const float32x4_t vhigh = vdupq_n_f32 (4095.0f);
+  gsize i;
+
+  for (i = 0; i + 16 <= n_values; i += 16)
+    {
+      float32x4x2_t lo = vld2q_f32 (values + i);
+      float32x4x2_t hi = vld2q_f32 (values + i + 8);
+      uint16x8_t first = vcombine_u16 (vmovn_u32 (hyscan_buffer_encode_u32_neon (lo.val[0], vscale, voffset, vhigh)),
+                                       vmovn_u32 (hyscan_buffer_encode_u32_neon (hi.val[0], vscale, voffset, vhigh)));
+      uint16x8_t second = vcombine_u16 (vmovn_u32 (hyscan_buffer_encode_u32_neon (lo.val[1], vscale, voffset, vhigh)),
+                                        vmovn_u32 (hyscan_buffer_encode_u32_neon (hi.val[1], vscale, voffset, vhigh)));
+      uint8x8x3_t bytes;
+
+      bytes.val[0] = vmovn_u16 (first);
+      bytes.val[1] = vmovn_u16 (vorrq_u16 (vshrq_n_u16 (first, 8), vshlq_n_u16 (second, 4)));
+      bytes.val[2] = vmovn_u16 (vshrq_n_u16 (second, 4));
+      vst3_u8 (raw8 + 3 * (i / 2), bytes);
+    }
+
+  hyscan_buffer_encode_adc12le_packed_scalar (raw8 + 3 * (i / 2), values + i, n_values - i);
+}
+
+static void
+hyscan_buffer_encode_bfloat16le_neon (gpointer      raw,
+                                      const gfloat *values,
+                                      gsize         n_values)
+{
+  guint16 *raw16 = raw;
+  const uint32x4_t vabsmask = vdupq_n_u32 (0x7fffffff);
+  const uint32x4_t vinf = vdupq_n_u32 (0x7f800000);
+  const uint32x4_t vround = vdupq_n_u32 (0x7fff);
+  const uint32x4_t vone = vdupq_n_u32 (1);
+  const uint32x4_t vquiet = vdupq_n_u32 (0x0040);
+  gsize i;
+
+  for (i = 0; i + 4 <= n_values; i += 4)
+    {
+      uint32x4_t bits = vreinterpretq_u32_f32 (vld1q_f32 (values + i));
+      uint32x4_t high = vshrq_n_u32 (bits, 16);
+      uint32x4_t nan = vcgtq_u32 (vandq_u32 (bits, vabsmask), vinf);
+      uint32x4_t rounded = vshrq_n_u32 (vaddq_u32 (bits, vaddq_u32 (vround, vandq_u32 (high, vone))), 16);
+
+      vst1_u16 (raw16 + i, vmovn_u32 (vbslq_u32 (nan, vorrq_u32 (high, vquiet), rounded)));
+    }
+
+  hyscan_buffer_encode_bfloat16le_scalar (raw16 + i, values + i, n_values - i);
+}
+
+static void
+hyscan_buffer_encode_int32le_neon (gpointer      raw,
+                                   const gfloat *values,
+                                   gsize         n_values)
+{
+  guint32 *raw32 = raw;
+  gsize i;
+
+  i = hyscan_buffer_encode_u32_array_neon (raw32, values, n_values, 4294967296.0f, 0.0f, 4294967296.0f);
+  hyscan_buffer_encode_int32le_scalar (raw32 + i, values + i, n_values - i);
+}
+
+/* Преобразование float32 -> float16 аналогично SSE2. */
+static inline uint32x4_t
+hyscan_buffer_float_to_half_neon (float32x4_t values)
+{
+  const uint32x4_t vabsmask = vdupq_n_u32 (0x7fffffff);
+  const uint32x4_t vbias = vdupq_n_u32 (112 << 10);
+  const uint32x4_t vmant = vdupq_n_u32 (0x3ff);
+  const uint32x4_t vinf = vdupq_n_u32 (0x7c00);
+  const uint32x4_t vmax_denormal = vdupq_n_u32 (0x387fffff);
+  const uint32x4_t vmax_normal = vdupq_n_u32 (0x477fffff);
+  const uint32x4_t vmax_finite = vdupq_n_u32 (0x7f7fffff);
+  const float32x4_t vdenormal_scale = vdupq_n_f32 (16777216.0f);
+  uint32x4_t bits, abs, sign, normal, denormal, nan, codes;
+
+  bits = vreinterpretq_u32_f32 (values);
+  abs = vandq_u32 (bits, vabsmask);
+  sign = vshrq_n_u32 (veorq_u32 (bits, abs), 16);
+
+  normal = vsubq_u32 (vshrq_n_u32 (abs, 13), vbias);
+  denormal = vcvtq_u32_f32 (vmulq_f32 (vreinterpretq_f32_u32 (abs), vdenormal_scale));
+  nan = vorrq_u32 (vinf, vandq_u32 (vshrq_n_u32 (abs, 13), vmant));
+
+  codes = vbslq_u32 (vcgtq_u32 (abs, vmax_denormal), normal, denormal);
+  codes = vbslq_u32 (vcgtq_u32 (abs, vmax_normal), vinf, codes);
+  codes = vbslq_u32 (vcgtq_u32 (abs, vmax_finite), nan, codes);
+
+  return vorrq_u32 (codes, sign);
+}
+
+static void
+hyscan_buffer_encode_float16le_neon (gpointer      raw,
+                                     const gfloat *values,
+                                     gsize         n_values)
+{
+  guint16 *raw16 = raw;
+  gsize i;
+
+  for (i = 0; i + 8 <= n_values; i += 8)
+    {
+      uint32x4_t lo = hyscan_buffer_float_to_half_neon (vld1q_f32 (values + i));
+      uint32x4_t hi = hyscan_buffer_float_to_half_neon (vld1q_f32 (values + i + 4));
+
+      vst1q_u16 (raw16 + i, vcombine_u16 (vmovn_u32 (lo), vmovn_u32 (hi)));
+    }
+
+  hyscan_buffer_encode_float16le_scalar (raw16 + i, values + i, n_values - i);
+}
+
+#ifdef __aarch64__
+/* Аппаратное преобразование float32 -> float16 в NEON использует режим
+ * округления из FPCR, поэтому на время преобразования выбирается округление
+ * к нулю. Исправления результата такие же, как для F16C. */
+static void
+hyscan_buffer_encode_float16le_fp16 (gpointer      raw,
+                                     const gfloat *values,
+                                     gsize         n_values)
+{
+  guint16 *raw16 = raw;
+  const uint32x4_t vabsmask = vdupq_n_u32 (0x7fffffff);
+  const uint32x4_t vmant = vdupq_n_u32 (0x3ff);
+  const uint32x4_t vinf = vdupq_n_u32 (0x7c00);
+  const uint32x4_t vmax_normal = vdupq_n_u32 (0x477fffff);
+  const uint32x4_t vmax_finite = vdupq_n_u32 (0x7f7fffff);
+  gint round;
+  gsize i;
+
+  round = fegetround ();
+  fesetround (FE_TOWARDZERO);
+
+  for (i = 0; i + 4 <= n_values; i += 4)
+    {
+      float32x4_t value = vld1q_f32 (values + i);
+      uint32x4_t bits = vreinterpretq_u32_f32 (value);
+      uint32x4_t abs = vandq_u32 (bits, vabsmask);
+      uint32x4_t sign = vshrq_n_u32 (veorq_u32 (bits, abs), 16);
+      uint32x4_t codes, nan, big;
+
+      codes = vmovl_u16 (vreinterpret_u16_f16 (vcvt_f16_f32 (value)));
+
+      nan = vandq_u32 (vcgtq_u32 (abs, vmax_finite), vshrq_n_u32 (abs, 13));
+      big = vorrq_u32 (vorrq_u32 (vinf, sign), vandq_u32 (nan, vmant));
+      codes = vbslq_u32 (vcgtq_u32 (abs, vmax_normal), big, codes);
+
+      vst1_u16 (raw16 + i, vmovn_u32 (codes));
+    }
+
+  fesetround (round);
+
+  hyscan_buffer_encode_float16le_scalar (raw16 + i, values + i, n_values - i);
+}
+#endif /* __aarch64__ */
+
+/* Функция вычисления амплитуды. Квадратный корень в NEON есть только
+ * в AArch64. */
+#ifdef __aarch64__
+static void
+hyscan_buffer_amplitude_neon (gfloat       *amplitude,
+                              const gfloat *values,
+                              gsize         n_points)
+{
+  gsize i;
+
+  for (i = 0; i + 4 <= n_points; i += 4)
+    {
+      float32x4x2_t complex = vld2q_f32 (values + 2 * i);
+      float32x4_t re = complex.val[0];
+      float32x4_t im = complex.val[1];
+
+      vst1q_f32 (amplitude + i, vsqrtq_f32 (vaddq_f32 (vmulq_f32 (re, re), vmulq_f32 (im, im))));
+    }
+
+  hyscan_buffer_amplitude_scalar (amplitude + i, values + 2 * i, n_points - i);
+}
+#endif /* __aarch64__ */
+
+#endif /* HYSCAN_BUFFER_NEON */
+
+/* Функция заполняет таблицу скалярными функциями преобразования. */
+static void
+hyscan_buffer_setup_scalar (HyScanBufferCodecs *codecs)
+{
+  codecs->simd = HYSCAN_BUFFER_SIMD_NONE;
+
+  codecs->decode[HYSCAN_BUFFER_CODEC_FLOAT] = hyscan_buffer_decode_float_scalar;
+  codecs->decode[HYSCAN_BUFFER_CODEC_ADC14LE] = hyscan_buffer_decode_adc14le_scalar;
+  codecs->decode[HYSCAN_BUFFER_CODEC_ADC16LE] = hyscan_buffer_decode_adc16le_scalar;
+  codecs->decode[HYSCAN_BUFFER_CODEC_ADC24LE] = hyscan_buffer_decode_adc24le_scalar;
+  codecs->decode[HYSCAN_BUFFER_CODEC_INT8] = hyscan_buffer_decode_int8_scalar;
+  codecs->decode[HYSCAN_BUFFER_CODEC_INT16LE] = hyscan_buffer_decode_int16le_scalar;
+  codecs->decode[HYSCAN_BUFFER_CODEC_INT24LE] = hyscan_buffer_decode_int24le_scalar;
+  codecs->decode[HYSCAN_BUFFER_CODEC_INT32LE] = hyscan_buffer_decode_int32le_scalar;
+  codecs->decode[HYSCAN_BUFFER_CODEC_FLOAT16LE] = hyscan_buffer_decode_float16le_scalar;
+  codecs->decode[HYSCAN_BUFFER_CODEC_FLOAT32LE] = hyscan_buffer_decode_float32le_scalar;
+  codecs->decode[HYSCAN_BUFFER_CODEC_ADC24LE_PACKED] = hyscan_buffer_decode_adc24le_packed_scalar;
+  codecs->decode[HYSCAN_BUFFER_CODEC_INT24LE_PACKED] = hyscan_buffer_decode_int24le_packed_scalar;
+  codecs->decode[HYSCAN_BUFFER_CODEC_ADC12LE] = hyscan_buffer_decode_adc12le_scalar;
+  codecs->decode[HYSCAN_BUFFER_CODEC_ADC12LE_PACKED] = hyscan_buffer_decode_adc12le_packed_scalar;
+  codecs->decode[HYSCAN_BUFFER_CODEC_BFLOAT16LE] = hyscan_buffer_decode_bfloat16le_scalar;
+
+  codecs->encode[HYSCAN_BUFFER_CODEC_FLOAT] = hyscan_buffer_encode_float_scalar;
+  codecs->encode[HYSCAN_BUFFER_CODEC_ADC14LE] = hyscan_buffer_encode_adc14le_scalar;
+  codecs->encode[HYSCAN_BUFFER_CODEC_ADC16LE] = hyscan_buffer_encode_adc16le_scalar;
+  codecs->encode[HYSCAN_BUFFER_CODEC_ADC24LE] = hyscan_buffer_encode_adc24le_scalar;
+  codecs->encode[HYSCAN_BUFFER_CODEC_INT8] = hyscan_buffer_encode_int8_scalar;
+  codecs->encode[HYSCAN_BUFFER_CODEC_INT16LE] = hyscan_buffer_encode_int16le_scalar;
+  codecs->encode[HYSCAN_BUFFER_CODEC_INT24LE] = hyscan_buffer_encode_int24le_scalar;
+  codecs->encode[HYSCAN_BUFFER_CODEC_INT32LE] = hyscan_buffer_encode_int32le_scalar;
+  codecs->encode[HYSCAN_BUFFER_CODEC_FLOAT16LE] = hyscan_buffer_encode_float16le_scalar;
+  codecs->encode[HYSCAN_BUFFER_CODEC_FLOAT32LE] = hyscan_buffer_encode_float32le_scalar;
+  codecs->encode[HYSCAN_BUFFER_CODEC_ADC24LE_PACKED] = hyscan_buffer_encode_adc24le_packed_scalar;
+  codecs->encode[HYSCAN_BUFFER_CODEC_INT24LE_PACKED] = hyscan_buffer_encode_int24le_packed_scalar;
+  codecs->encode[HYSCAN_BUFFER_CODEC_ADC12LE] = hyscan_buffer_encode_adc12le_scalar;
+  codecs->encode[HYSCAN_BUFFER_CODEC_ADC12LE_PACKED] = hyscan_buffer_encode_adc12le_packed_scalar;
+  codecs->encode[HYSCAN_BUFFER_CODEC_BFLOAT16LE] = hyscan_buffer_encode_bfloat16le_scalar;
+
+  codecs->amplitude = hyscan_buffer_amplitude_scalar;
+
+#ifdef HYSCAN_BUFFER_SWAP
+  codecs->decode[HYSCAN_BUFFER_CODEC_ADC14LE] = hyscan_buffer_decode_adc14le_swap;
+  codecs->decode[HYSCAN_BUFFER_CODEC_ADC16LE] = hyscan_buffer_decode_adc16le_swap;
+  codecs->decode[HYSCAN_BUFFER_CODEC_ADC24LE] = hyscan_buffer_decode_adc24le_swap;
+  codecs->decode[HYSCAN_BUFFER_CODEC_INT16LE] = hyscan_buffer_decode_int16le_swap;
+  codecs->decode[HYSCAN_BUFFER_CODEC_INT24LE] = hyscan_buffer_decode_int24le_swap;
+  codecs->decode[HYSCAN_BUFFER_CODEC_INT32LE] = hyscan_buffer_decode_int32le_swap;
+  codecs->decode[HYSCAN_BUFFER_CODEC_FLOAT16LE] = hyscan_buffer_decode_float16le_swap;
+  codecs->decode[HYSCAN_BUFFER_CODEC_FLOAT32LE] = hyscan_buffer_decode_float32le_swap;
+  codecs->decode[HYSCAN_BUFFER_CODEC_ADC12LE] = hyscan_buffer_decode_adc12le_swap;
+  codecs->decode[HYSCAN_BUFFER_CODEC_BFLOAT16LE] = hyscan_buffer_decode_bfloat16le_swap;
+
+  codecs->encode[HYSCAN_BUFFER_CODEC_ADC14LE] = hyscan_buffer_encode_adc14le_swap;
+  codecs->encode[HYSCAN_BUFFER_CODEC_ADC16LE] = hyscan_buffer_encode_adc16le_swap;
+  codecs->encode[HYSCAN_BUFFER_CODEC_ADC24LE] = hyscan_buffer_encode_adc24le_swap;
+  codecs->encode[HYSCAN_BUFFER_CODEC_INT16LE] = hyscan_buffer_encode_int16le_swap;
+  codecs->encode[HYSCAN_BUFFER_CODEC_INT24LE] = hyscan_buffer_encode_int24le_swap;
+  codecs->encode[HYSCAN_BUFFER_CODEC_INT32LE] = hyscan_buffer_encode_int32le_swap;
+  codecs->encode[HYSCAN_BUFFER_CODEC_FLOAT16LE] = hyscan_buffer_encode_float16le_swap;
+  codecs->encode[HYSCAN_BUFFER_CODEC_FLOAT32LE] = hyscan_buffer_encode_float32le_swap;
+  codecs->encode[HYSCAN_BUFFER_CODEC_ADC12LE] = hyscan_buffer_encode_adc12le_swap;
+  codecs->encode[HYSCAN_BUFFER_CODEC_BFLOAT16LE] = hyscan_buffer_encode_bfloat16le_swap;
+#endif
+}
+
+/* Функция заполняет таблицы векторными функциями преобразования. Функции,
+ * не имеющие векторной реализации, берутся из скалярной таблицы. */
+static void
+hyscan_buffer_setup_simd (void)
+{
+  hyscan_buffer_setup_scalar (&hyscan_buffer_codecs_scalar);
+
+#ifdef HYSCAN_BUFFER_X86
+  hyscan_buffer_codecs_sse2 = hyscan_buffer_codecs_scalar;
+  hyscan_buffer_codecs_sse2.simd = HYSCAN_BUFFER_SIMD_SSE2;
+  hyscan_buffer_codecs_sse2.decode[HYSCAN_BUFFER_CODEC_ADC14LE] = hyscan_buffer_decode_adc14le_sse2;
+  hyscan_buffer_codecs_sse2.decode[HYSCAN_BUFFER_CODEC_ADC16LE] = hyscan_buffer_decode_adc16le_sse2;
+  hyscan_buffer_codecs_sse2.decode[HYSCAN_BUFFER_CODEC_ADC24LE] = hyscan_buffer_decode_adc24le_sse2;
+  hyscan_buffer_codecs_sse2.decode[HYSCAN_BUFFER_CODEC_INT8] = hyscan_buffer_decode_int8_sse2;
+  hyscan_buffer_codecs_sse2.decode[HYSCAN_BUFFER_CODEC_INT16LE] = hyscan_buffer_decode_int16le_sse2;
+  hyscan_buffer_codecs_sse2.decode[HYSCAN_BUFFER_CODEC_INT24LE] = hyscan_buffer_decode_int24le_sse2;
+  hyscan_buffer_codecs_sse2.decode[HYSCAN_BUFFER_CODEC_INT32LE] = hyscan_buffer_decode_int32le_sse2;
+  hyscan_buffer_codecs_sse2.decode[HYSCAN_BUFFER_CODEC_ADC24LE_PACKED] = hyscan_buffer_decode_adc24le_packed_sse2;
+  hyscan_buffer_codecs_sse2.decode[HYSCAN_BUFFER_CODEC_INT24LE_PACKED] = hyscan_buffer_decode_int24le_packed_sse2;
+  hyscan_buffer_codecs_sse2.decode[HYSCAN_BUFFER_CODEC_ADC12LE] = hyscan_buffer_decode_adc12le_sse2;
+  hyscan_buffer_codecs_sse2.decode[HYSCAN_BUFFER_CODEC_ADC12LE_PACKED] = hyscan_buffer_decode_adc12le_packed_sse2;
+  hyscan_buffer_codecs_sse2.decode[HYSCAN_BUFFER_CODEC_BFLOAT16LE] = hyscan_buffer_decode_bfloat16le_sse2;
+  hyscan_buffer_codecs_sse2.decode[HYSCAN_BUFFER_CODEC_FLOAT16LE] = hyscan_buffer_decode_float16le_sse2;
+  hyscan_buffer_codecs_sse2.encode[HYSCAN_BUFFER_CODEC_ADC14LE] = hyscan_buffer_encode_adc14le_sse2;
+  hyscan_buffer_codecs_sse2.encode[HYSCAN_BUFFER_CODEC_ADC16LE] = hyscan_buffer_encode_adc16le_sse2;
+  hyscan_buffer_codecs_sse2.encode[HYSCAN_BUFFER_CODEC_ADC24LE] = hyscan_buffer_encode_adc24le_sse2;
+  hyscan_buffer_codecs_sse2.encode[HYSCAN_BUFFER_CODEC_INT8] = hyscan_buffer_encode_int8_sse2;
+  hyscan_buffer_codecs_sse2.encode[HYSCAN_BUFFER_CODEC_INT16LE] = hyscan_buffer_encode_int16le_sse2;
+  hyscan_buffer_codecs_sse2.encode[HYSCAN_BUFFER_CODEC_INT24LE] = hyscan_buffer_encode_int24le_sse2;
+  hyscan_buffer_codecs_sse2.encode[HYSCAN_BUFFER_CODEC_INT32LE] = hyscan_buffer_encode_int32le_sse2;
+  hyscan_buffer_codecs_sse2.encode[HYSCAN_BUFFER_CODEC_ADC24LE_PACKED] = hyscan_buffer_encode_adc24le_packed_sse2;
+  hyscan_buffer_codecs_sse2.encode[HYSCAN_BUFFER_CODEC_INT24LE_PACKED] = hyscan_buffer_encode_int24le_packed_sse2;
+  hyscan_buffer_codecs_sse2.encode[HYSCAN_BUFFER_CODEC_ADC12LE] = hyscan_buffer_encode_adc12le_sse2;
+  hyscan_buffer_codecs_sse2.encode[HYSCAN_BUFFER_CODEC_ADC12LE_PACKED] = hyscan_buffer_encode_adc12le_packed_sse2;
+  hyscan_buffer_codecs_sse2.encode[HYSCAN_BUFFER_CODEC_BFLOAT16LE] = hyscan_buffer_encode_bfloat16le_sse2;
+  hyscan_buffer_codecs_sse2.encode[HYSCAN_BUFFER_CODEC_FLOAT16LE] = hyscan_buffer_encode_float16le_sse2;
+  hyscan_buffer_codecs_sse2.amplitude = hyscan_buffer_amplitude_sse2;
+
+  hyscan_buffer_codecs_avx2 = hyscan_buffer_codecs_scalar;
+  hyscan_buffer_codecs_avx2.simd = HYSCAN_BUFFER_SIMD_AVX2;
+  hyscan_buffer_codecs_avx2.decode[HYSCAN_BUFFER_CODEC_ADC14LE] = hyscan_buffer_decode_adc14le_avx2;
+  hyscan_buffer_codecs_avx2.decode[HYSCAN_BUFFER_CODEC_ADC16LE] = hyscan_buffer_decode_adc16le_avx2;
+  hyscan_buffer_codecs_avx2.decode[HYSCAN_BUFFER_CODEC_ADC24LE] = hyscan_buffer_decode_adc24le_avx2;
+  hyscan_buffer_codecs_avx2.decode[HYSCAN_BUFFER_CODEC_INT8] = hyscan_buffer_decode_int8_avx2;
+  hyscan_buffer_codecs_avx2.decode[HYSCAN_BUFFER_CODEC_INT16LE] = hyscan_buffer_decode_int16le_avx2;
+  hyscan_buffer_codecs_avx2.decode[HYSCAN_BUFFER_CODEC_INT24LE] = hyscan_buffer_decode_int24le_avx2;
+  hyscan_buffer_codecs_avx2.decode[HYSCAN_BUFFER_CODEC_INT32LE] = hyscan_buffer_decode_int32le_avx2;
+  hyscan_buffer_codecs_avx2.decode[HYSCAN_BUFFER_CODEC_ADC24LE_PACKED] = hyscan_buffer_decode_adc24le_packed_avx2;
+  hyscan_buffer_codecs_avx2.decode[HYSCAN_BUFFER_CODEC_INT24LE_PACKED] = hyscan_buffer_decode_int24le_packed_avx2;
+  hyscan_buffer_codecs_avx2.decode[HYSCAN_BUFFER_CODEC_ADC12LE] = hyscan_buffer_decode_adc12le_avx2;
+  hyscan_buffer_codecs_avx2.decode[HYSCAN_BUFFER_CODEC_ADC12LE_PACKED] = hyscan_buffer_decode_adc12le_packed_avx2;
+  hyscan_buffer_codecs_avx2.decode[HYSCAN_BUFFER_CODEC_BFLOAT16LE] = hyscan_buffer_decode_bfloat16le_avx2;
+  hyscan_buffer_codecs_avx2.decode[HYSCAN_BUFFER_CODEC_FLOAT16LE] = hyscan_buffer_decode_float16le_avx2;
+  hyscan_buffer_codecs_avx2.encode[HYSCAN_BUFFER_CODEC_ADC14LE] = hyscan_buffer_encode_adc14le_avx2;
+  hyscan_buffer_codecs_avx2.encode[HYSCAN_BUFFER_CODEC_ADC16LE] = hyscan_buffer_encode_adc16le_avx2;
+  hyscan_buffer_codecs_avx2.encode[HYSCAN_BUFFER_CODEC_ADC24LE] = hyscan_buffer_encode_adc24le_avx2;
+  hyscan_buffer_codecs_avx2.encode[HYSCAN_BUFFER_CODEC_INT8] = hyscan_buffer_encode_int8_avx2;
+  hyscan_buffer_codecs_avx2.encode[HYSCAN_BUFFER_CODEC_INT16LE] = hyscan_buffer_encode_int16le_avx2;
+  hyscan_buffer_codecs_avx2.encode[HYSCAN_BUFFER_CODEC_INT24LE] = hyscan_buffer_encode_int24le_avx2;
+  hyscan_buffer_codecs_avx2.encode[HYSCAN_BUFFER_CODEC_INT32LE] = hyscan_buffer_encode_int32le_avx2;
+  hyscan_buffer_codecs_avx2.encode[HYSCAN_BUFFER_CODEC_ADC24LE_PACKED] = hyscan_buffer_encode_adc24le_packed_avx2;
+  hyscan_buffer_codecs_avx2.encode[HYSCAN_BUFFER_CODEC_INT24LE_PACKED] = hyscan_buffer_encode_int24le_packed_avx2;
+  hyscan_buffer_codecs_avx2.encode[HYSCAN_BUFFER_CODEC_ADC12LE] = hyscan_buffer_encode_adc12le_avx2;
+  hyscan_buffer_codecs_avx2.encode[HYSCAN_BUFFER_CODEC_ADC12LE_PACKED] = hyscan_buffer_encode_adc12le_packed_avx2;
+  hyscan_buffer_codecs_avx2.encode[HYSCAN_BUFFER_CODEC_BFLOAT16LE] = hyscan_buffer_encode_bfloat16le_avx2;
+  hyscan_buffer_codecs_avx2.encode[HYSCAN_BUFFER_CODEC_FLOAT16LE] = hyscan_buffer_encode_float16le_avx2;
+  hyscan_buffer_codecs_avx2.amplitude = hyscan_buffer_amplitude_avx2;
+
+  hyscan_buffer_codecs_f16c = hyscan_buffer_codecs_avx2;
+  hyscan_buffer_codecs_f16c.simd = HYSCAN_BUFFER_SIMD_F16C;
+  hyscan_buffer_codecs_f16c.decode[HYSCAN_BUFFER_CODEC_FLOAT16LE] = hyscan_buffer_decode_float16le_f16c;
+  hyscan_buffer_codecs_f16c.encode[HYSCAN_BUFFER_CODEC_FLOAT16LE] = hyscan_buffer_encode_float16le_f16c;
+#endif
+
+#ifdef HYSCAN_BUFFER_NEON
+  hyscan_buffer_codecs_neon = hyscan_buffer_codecs_scalar;
+  hyscan_buffer_codecs_neon.simd = HYSCAN_BUFFER_SIMD_NEON;
+  hyscan_buffer_codecs_neon.decode[HYSCAN_BUFFER_CODEC_ADC14LE] = hyscan_buffer_decode_adc14le_neon;
+  hyscan_buffer_codecs_neon.decode[HYSCAN_BUFFER_CODEC_ADC16LE] = hyscan_buffer_decode_adc16le_neon;
+  hyscan_buffer_codecs_neon.decode[HYSCAN_BUFFER_CODEC_ADC24LE] = hyscan_buffer_decode_adc24le_neon;
+  hyscan_buffer_codecs_neon.decode[HYSCAN_BUFFER_CODEC_INT8] = hyscan_buffer_decode_int8_neon;
+  hyscan_buffer_codecs_neon.decode[HYSCAN_BUFFER_CODEC_INT16LE] = hyscan_buffer_decode_int16le_neon;
+  hyscan_buffer_codecs_neon.decode[HYSCAN_BUFFER_CODEC_INT24LE] = hyscan_buffer_decode_int24le_neon;
+  hyscan_buffer_codecs_neon.decode[HYSCAN_BUFFER_CODEC_INT32LE] = hyscan_buffer_decode_int32le_neon;
+  hyscan_buffer_codecs_neon.decode[HYSCAN_BUFFER_CODEC_ADC24LE_PACKED] = hyscan_buffer_decode_adc24le_packed_neon;
+  hyscan_buffer_codecs_neon.decode[HYSCAN_BUFFER_CODEC_INT24LE_PACKED] = hyscan_buffer_decode_int24le_packed_neon;
+  hyscan_buffer_codecs_neon.decode[HYSCAN_BUFFER_CODEC_ADC12LE] = hyscan_buffer_decode_adc12le_neon;
+  hyscan_buffer_codecs_neon.decode[HYSCAN_BUFFER_CODEC_ADC12LE_PACKED] = hyscan_buffer_decode_adc12le_packed_neon;
+  hyscan_buffer_codecs_neon.decode[HYSCAN_BUFFER_CODEC_BFLOAT16LE] = hyscan_buffer_decode_bfloat16le_neon;
+#ifdef __aarch64__
+  hyscan_buffer_codecs_neon.decode[HYSCAN_BUFFER_CODEC_FLOAT16LE] = hyscan_buffer_decode_float16le_fp16;
+#endif
+  hyscan_buffer_codecs_neon.encode[HYSCAN_BUFFER_CODEC_ADC14LE] = hyscan_buffer_encode_adc14le_neon;
+  hyscan_buffer_codecs_neon.encode[HYSCAN_BUFFER_CODEC_ADC16LE] = hyscan_buffer_encode_adc16le_neon;
+  hyscan_buffer_codecs_neon.encode[HYSCAN_BUFFER_CODEC_ADC24LE] = hyscan_buffer_encode_adc24le_neon;
+  hyscan_buffer_codecs_neon.encode[HYSCAN_BUFFER_CODEC_INT8] = hyscan_buffer_encode_int8_neon;
+  hyscan_buffer_codecs_neon.encode[HYSCAN_BUFFER_CODEC_INT16LE] = hyscan_buffer_encode_int16le_neon;
+  hyscan_buffer_codecs_neon.encode[HYSCAN_BUFFER_CODEC_INT24LE] = hyscan_buffer_encode_int24le_neon;
+  hyscan_buffer_codecs_neon.encode[HYSCAN_BUFFER_CODEC_INT32LE] = hyscan_buffer_encode_int32le_neon;
+  hyscan_buffer_codecs_neon.encode[HYSCAN_BUFFER_CODEC_ADC24LE_PACKED] = hyscan_buffer_encode_adc24le_packed_neon;
+  hyscan_buffer_codecs_neon.encode[HYSCAN_BUFFER_CODEC_INT24LE_PACKED] = hyscan_buffer_encode_int24le_packed_neon;
+  hyscan_buffer_codecs_neon.encode[HYSCAN_BUFFER_CODEC_ADC12LE] = hyscan_buffer_encode_adc12le_neon;
+  hyscan_buffer_codecs_neon.encode[HYSCAN_BUFFER_CODEC_ADC12LE_PACKED] = hyscan_buffer_encode_adc12le_packed_neon;
+  hyscan_buffer_codecs_neon.encode[HYSCAN_BUFFER_CODEC_BFLOAT16LE] = hyscan_buffer_encode_bfloat16le_neon;
+#ifdef __aarch64__
+  hyscan_buffer_codecs_neon.encode[HYSCAN_BUFFER_CODEC_FLOAT16LE] = hyscan_buffer_encode_float16le_fp16;
+  hyscan_buffer_codecs_neon.amplitude = hyscan_buffer_amplitude_neon;
+#else
+  hyscan_buffer_codecs_neon.encode[HYSCAN_BUFFER_CODEC_FLOAT16LE] = hyscan_buffer_encode_float16le_neon;
+#endif
+#endif
+}
+
+/* Функция возвращает таблицу функций для указанного набора инструкций,
+ * если он поддерживается процессором, иначе NULL. */
+static const HyScanBufferCodecs *
+hyscan_buffer_lookup_codecs (HyScanBufferSimd simd)
+{
+  switch (simd)
+    {
+    case HYSCAN_BUFFER_SIMD_NONE:
+      return &hyscan_buffer_codecs_scalar;
+
+#ifdef HYSCAN_BUFFER_X86
+    case HYSCAN_BUFFER_SIMD_SSE2:
+      __builtin_cpu_init ();
+      return __builtin_cpu_supports ("sse2") ? &hyscan_buffer_codecs_sse2 : NULL;
+
+    case HYSCAN_BUFFER_SIMD_AVX2:
+      __builtin_cpu_init ();
+      return __builtin_cpu_supports ("avx2") ? &hyscan_buffer_codecs_avx2 : NULL;
+
+    case HYSCAN_BUFFER_SIMD_F16C:
+      __builtin_cpu_init ();
+      if (__builtin_cpu_supports ("avx2") && __builtin_cpu_supports ("f16c"))
+        return &hyscan_buffer_codecs_f16c;
+      return NULL;
+#endif
+
+#ifdef HYSCAN_BUFFER_NEON
+    case HYSCAN_BUFFER_SIMD_NEON:
+      return &hyscan_buffer_codecs_neon;
+#endif
+
+    default:
+      return NULL;
+    }
+}
+
+/* Функции операций над значениями при импорте с преобразованием. */
+
+static void
+hyscan_buffer_op_scale (gfloat *values,
+                        gsize   n_values,
+                        gfloat  scale)
+{
+  gsize i;
+
+  for (i = 0; i < n_values; i++)
+    values[i] = values[i] * scale;
+}
+
+static void
+hyscan_buffer_op_offset (gfloat *values,
+                         gsize   n_values,
+                         gfloat  offset)
+{
+  gsize i;
+
+  for (i = 0; i < n_values; i++)
+    values[i] = values[i] + offset;
+}
+
+static void
+hyscan_buffer_op_abs (gfloat *values,
+                      gsize   n_values)
+{
+  gsize i;
+
+  for (i = 0; i < n_values; i++)
+    values[i] = fabsf (values[i]);
+}
+
+static void
+hyscan_buffer_op_db (gfloat *values,
+                     gsize   n_values,
+                     gfloat  scale)
+{
+  gsize i;
+
+  for (i = 0; i < n_values; i++)
+    values[i] = scale * log10f (values[i]);
+}
+
+/* Функция обрабатывает части задачи, пока они не закончатся. */
+static void
+hyscan_buffer_job_run (HyScanBufferJob *job)
+{
+  guint index;
+
+  while ((index = g_atomic_int_add (&job->next, 1)) < job->n_tasks)
+    job->func (job->data, index);
+}
+
+static void
+hyscan_buffer_job_unref (HyScanBufferJob *job)
+{
+  if (!g_atomic_int_dec_and_test (&job->ref_count))
+    return;
+
+  g_mutex_clear (&job->lock);
+  g_cond_clear (&job->cond);
+  g_slice_free (HyScanBufferJob, job);
+}
+
+/* Функция рабочего потока. Если поток запустился после завершения задачи,
+ * например из-за того, что все потоки были заняты, он ничего не делает.
+ * Это позволяет вызывающему потоку не ждать свободные потоки и исключает
+ * взаимную блокировку при вложенных вызовах. */
+static void
+hyscan_buffer_job_worker (gpointer data,
+                          gpointer user_data)
+{
+  HyScanBufferJob *job = data;
+  gboolean closed;
+
+  g_mutex_lock (&job->lock);
+  closed = job->closed;
+  if (!closed)
+    job->n_active += 1;
+  g_mutex_unlock (&job->lock);
+
+  if (!closed)
+    {
+      hyscan_buffer_job_run (job);
+
+      g_mutex_lock (&job->lock);
+      job->n_active -= 1;
+      g_cond_signal (&job->cond);
+      g_mutex_unlock (&job->lock);
+    }
+
+  hyscan_buffer_job_unref (job);
+}
+
+/* Функция вычисляет смещение в байтах до значения с номером offset. Значения
+ * упакованных форматов могут занимать нецелое число байт, поэтому смещение
+ * вычисляется через размер точки. Номер значения должен приходиться на
+ * границу байта, для этого все части данных содержат чётное число значений. */
+static inline gsize
+hyscan_buffer_raw_offset (gsize offset,
+                          gsize point_size,
+                          guint n_values)
+{
+  return offset * point_size / n_values;
+}
+
+/* Функция декодирования части массива. */
+static void
+hyscan_buffer_decode_task (gpointer data,
+                           guint    index)
+{
+  HyScanBufferConvert *convert = data;
+  gsize offset = (gsize)index * HYSCAN_BUFFER_CHUNK_SIZE;
+  gsize n_values = MIN (HYSCAN_BUFFER_CHUNK_SIZE, convert->n_values - offset);
+
+  convert->decode (convert->values + offset, convert->raw + hyscan_buffer_raw_offset (offset, convert->point_size, convert->n_point_values), n_values);
+}
+
+/* Функция кодирования части массива. */
+static void
+hyscan_buffer_encode_task (gpointer data,
+                           guint    index)
+{
+  HyScanBufferConvert *convert = data;
+  gsize offset = (gsize)index * HYSCAN_BUFFER_CHUNK_SIZE;
+  gsize n_values = MIN (HYSCAN_BUFFER_CHUNK_SIZE, convert->n_values - offset);
+
+  convert->encode (convert->raw + hyscan_buffer_raw_offset (offset, convert->point_size, convert->n_point_values), convert->values + offset, n_values);
+}
+
+/* Функция определяет число потоков для преобразования n_points точек. */
+guint
+hyscan_buffer_internal_get_n_threads (guint32 n_points,
+                                      guint   n_threads)
+{
+  if (n_points < (guint32)g_atomic_int_get (&hyscan_buffer_parallel_threshold))
+    return 1;
+
+  if (n_threads == 0)
+    n_threads = g_get_num_processors ();
+
+  return n_threads;
+}
+
+/* Функция инициализирует таблицы преобразования и выбирает наилучший
+ * набор инструкций, поддерживаемый процессором. */
+static void
+hyscan_buffer_internal_init (void)
+{
+  static gsize initialized = 0;
+
+  if (g_once_init_enter (&initialized))
+    {
+      const HyScanBufferSimd simd[] = { HYSCAN_BUFFER_SIMD_F16C,
+                                        HYSCAN_BUFFER_SIMD_AVX2,
+                                        HYSCAN_BUFFER_SIMD_NEON,
+                                        HYSCAN_BUFFER_SIMD_SSE2,
+                                        HYSCAN_BUFFER_SIMD_NONE };
+      const HyScanBufferCodecs *codecs = NULL;
+      guint i;
+
+      hyscan_buffer_setup_table16 ();
+      hyscan_buffer_setup_simd ();
+
+      for (i = 0; (codecs == NULL) && (i < G_N_ELEMENTS (simd)); i++)
+        codecs = hyscan_buffer_lookup_codecs (simd[i]);
+
+      g_atomic_pointer_set (&hyscan_buffer_codecs, codecs);
+
+      /* Общий пул потоков для всех объектов. */
+      hyscan_buffer_pool = g_thread_pool_new (hyscan_buffer_job_worker, NULL,
+                                              g_get_num_processors (), FALSE, NULL);
+
+      g_once_init_leave (&initialized, 1);
+    }
+}
+
+/* Функция возвращает описание типа данных или NULL, если тип не поддерживается. */
+const HyScanBufferFormat *
+hyscan_buffer_internal_get_format (HyScanDataType type)
+{
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (hyscan_buffer_formats); i++)
+    if (hyscan_buffer_formats[i].type == type)
+      return &hyscan_buffer_formats[i];
+
+  return NULL;
+}
+
+/* Функция проверяет, совпадает ли формат хранения с gfloat. */
+gboolean
+hyscan_buffer_internal_is_identity (const HyScanBufferFormat *format)
+{
+#if G_BYTE_ORDER == G_LITTLE_ENDIAN
+  if (format->codec == HYSCAN_BUFFER_CODEC_FLOAT32LE)
+    return TRUE;
+#endif
+
+  return format->codec == HYSCAN_BUFFER_CODEC_FLOAT;
+}
+
+/* Функция возвращает текущий набор функций преобразования. */
+const HyScanBufferCodecs *
+hyscan_buffer_internal_get_codecs (void)
+{
+  hyscan_buffer_internal_init ();
+
+  return g_atomic_pointer_get (&hyscan_buffer_codecs);
+}
+
+/* Функция выбирает набор функций преобразования. */
+gboolean
+hyscan_buffer_internal_set_simd (HyScanBufferSimd simd)
+{
+  const HyScanBufferCodecs *codecs;
+
+  hyscan_buffer_internal_init ();
+
+  codecs = hyscan_buffer_lookup_codecs (simd);
+  if (codecs == NULL)
+    return FALSE;
+
+  g_atomic_pointer_set (&hyscan_buffer_codecs, codecs);
+
+  return TRUE;
+}
+
+/* Функция устанавливает минимальное число точек для параллельного преобразования. */
+void
+hyscan_buffer_internal_set_parallel_threshold (guint32 n_points)
+{
+  g_atomic_int_set (&hyscan_buffer_parallel_threshold, n_points);
+}
+
+/* Функция возвращает минимальное число точек для параллельного преобразования. */
+guint32
+hyscan_buffer_internal_get_parallel_threshold (void)
+{
+  return (guint32)g_atomic_int_get (&hyscan_buffer_parallel_threshold);
+}
+
+/* Функция выполняет n_tasks частей задачи в n_threads потоках, включая вызывающий. */
+void
+hyscan_buffer_internal_parallel (HyScanBufferTaskFunc func,
+                                 gpointer             data,
+                                 guint                n_tasks,
+                                 guint                n_threads)
+{
+  HyScanBufferJob *job;
+  guint i;
+
+  hyscan_buffer_internal_init ();
+
+  n_threads = MIN (n_threads, n_tasks);
+  if (n_threads <= 1)
+    {
+      for (i = 0; i < n_tasks; i++)
+        func (data, i);
+
+      return;
+    }
+
+  job = g_slice_new0 (HyScanBufferJob);
+  job->func = func;
+  job->data = data;
+  job->n_tasks = n_tasks;
+  job->ref_count = n_threads;
+  g_mutex_init (&job->lock);
+  g_cond_init (&job->cond);
+
+  for (i = 1; i < n_threads; i++)
+    g_thread_pool_push (hyscan_buffer_pool, job, NULL);
+
+  hyscan_buffer_job_run (job);
+
+  /* Ожидаем завершения потоков, успевших начать работу. */
+  g_mutex_lock (&job->lock);
+  job->closed = TRUE;
+  while (job->n_active > 0)
+    g_cond_wait (&job->cond, &job->lock);
+  g_mutex_unlock (&job->lock);
+
+  hyscan_buffer_job_unref (job);
+}
+
+/* Функция декодирует n_points точек данных, используя до n_threads потоков. */
+void
+hyscan_buffer_internal_decode (const HyScanBufferFormat *format,
+                               gfloat                   *values,
+                               gconstpointer             raw,
+                               guint32                   n_points,
+                               guint                     n_threads)
+{
+  const HyScanBufferCodecs *codecs = hyscan_buffer_internal_get_codecs ();
+  HyScanBufferConvert convert;
+
+  convert.decode = codecs->decode[format->codec];
+  convert.encode = NULL;
+  convert.values = values;
+  convert.raw = (guint8 *)raw;
+  convert.point_size = hyscan_data_get_point_size (format->type);
+  convert.n_point_values = format->n_values;
+  convert.n_values = (gsize)n_points * format->n_values;
+
+  n_threads = hyscan_buffer_internal_get_n_threads (n_points, n_threads);
+  if (n_threads <= 1)
+    {
+      convert.decode (values, raw, convert.n_values);
+      return;
+    }
+
+  hyscan_buffer_internal_parallel (hyscan_buffer_decode_task, &convert,
+                                   (convert.n_values + HYSCAN_BUFFER_CHUNK_SIZE - 1) / HYSCAN_BUFFER_CHUNK_SIZE,
+                                   n_threads);
+}
+
+/* Функция кодирует n_points точек данных, используя до n_threads потоков. */
+void
+hyscan_buffer_internal_encode (const HyScanBufferFormat *format,
+                               gpointer                  raw,
+                               const gfloat             *values,
+                               guint32                   n_points,
+                               guint                     n_threads)
+{
+  const HyScanBufferCodecs *codecs = hyscan_buffer_internal_get_codecs ();
+  HyScanBufferConvert convert;
+
+  convert.decode = NULL;
+  convert.encode = codecs->encode[format->codec];
+  convert.values = (gfloat *)values;
+  convert.raw = raw;
+  convert.point_size = hyscan_data_get_point_size (format->type);
+  convert.n_point_values = format->n_values;
+  convert.n_values = (gsize)n_points * format->n_values;
+
+  n_threads = hyscan_buffer_internal_get_n_threads (n_points, n_threads);
+  if (n_threads <= 1)
+    {
+      convert.encode (raw, values, convert.n_values);
+      return;
+    }
+
+  hyscan_buffer_internal_parallel (hyscan_buffer_encode_task, &convert,
+                                   (convert.n_values + HYSCAN_BUFFER_CHUNK_SIZE - 1) / HYSCAN_BUFFER_CHUNK_SIZE,
+                                   n_threads);
+}
+
+/* Функция декодирует n_points точек данных и выполняет над значениями
+ * последовательность операций. */
+void
+hyscan_buffer_internal_transform (const HyScanBufferFormat *format,
+                                  gfloat                   *values,
+                                  gconstpointer             raw,
+                                  guint32                   n_points,
+                                  const HyScanBufferOp     *ops,
+                                  guint                     n_ops)
+{
+  const HyScanBufferCodecs *codecs = hyscan_buffer_internal_get_codecs ();
+  HyScanBufferDecodeFunc decode = codecs->decode[format->codec];
+  gfloat tile[HYSCAN_BUFFER_TILE_SIZE];
+  const guint8 *raw8 = raw;
+  gsize point_size;
+  gsize n_values;
+  gsize offset;
+  gboolean collapse;
+  guint i;
+
+  point_size = hyscan_data_get_point_size (format->type);
+  n_values = (gsize)n_points * format->n_values;
+
+  /* Если вычисляется амплитуда комплексных данных, результат занимает
+   * меньше места, чем исходные данные. В этом случае часть декодируется
+   * в tile, а амплитуда записывается сразу в результат. */
+  collapse = FALSE;
+  for (i = 0; i < n_ops; i++)
+    if ((ops[i].type == HYSCAN_BUFFER_OP_AMPLITUDE) && (format->n_values == 2))
+      collapse = TRUE;
+
+  for (offset = 0; offset < n_values; offset += HYSCAN_BUFFER_TILE_SIZE)
+    {
+      gsize n_tile_values = MIN (HYSCAN_BUFFER_TILE_SIZE, n_values - offset);
+      guint n_components = format->n_values;
+      gfloat *work = collapse ? tile : values + offset;
+
+      decode (work, raw8 + hyscan_buffer_raw_offset (offset, point_size, format->n_values), n_tile_values);
+
+      for (i = 0; i < n_ops; i++)
+        {
+          switch (ops[i].type)
+            {
+            case HYSCAN_BUFFER_OP_SCALE:
+              hyscan_buffer_op_scale (work, n_tile_values, ops[i].value);
+              break;
+
+            case HYSCAN_BUFFER_OP_OFFSET:
+              hyscan_buffer_op_offset (work, n_tile_values, ops[i].value);
+              break;
+
+            case HYSCAN_BUFFER_OP_AMPLITUDE:
+              if (n_components == 2)
+                {
+                  n_tile_values /= 2;
+                  n_components = 1;
+                  codecs->amplitude (values + offset / 2, work, n_tile_values);
+                  work = values + offset / 2;
+                }
+              else
+                {
+                  hyscan_buffer_op_abs (work, n_tile_values);
+                }
+              break;
+
+            case HYSCAN_BUFFER_OP_DB:
+              hyscan_buffer_op_db (work, n_tile_values, ops[i].value);
+              break;
+            }
+        }
+    }
+}
+
+/* Функция декодирует n_points точек данных, записывая результат на место
+ * исходных данных. Если размер значения в формате хранения равен размеру
+ * gfloat, функции декодирования работают на месте. Иначе данные декодируются
+ * частями через промежуточный буфер, начиная с конца, чтобы результат не
+ * затирал ещё не декодированные данные. */
+void
+hyscan_buffer_internal_decode_in_place (const HyScanBufferFormat *format,
+                                        gpointer                  data,
+                                        guint32                   n_points)
+{
+  const HyScanBufferCodecs *codecs = hyscan_buffer_internal_get_codecs ();
+  HyScanBufferDecodeFunc decode = codecs->decode[format->codec];
+  gfloat tile[HYSCAN_BUFFER_TILE_SIZE];
+  guint8 *raw8 = data;
+  gfloat *values = data;
+  gsize point_size;
+  gsize n_values;
+  gsize n_tiles;
+
+  if (hyscan_buffer_internal_is_identity (format))
+    return;
+
+  point_size = hyscan_data_get_point_size (format->type);
+  n_values = (gsize)n_points * format->n_values;
+
+  if (point_size == format->n_values * sizeof (gfloat))
+    {
+      decode (values, data, n_values);
+      return;
+    }
+
+  for (n_tiles = (n_values + HYSCAN_BUFFER_TILE_SIZE - 1) / HYSCAN_BUFFER_TILE_SIZE; n_tiles > 0; n_tiles--)
+    {
+      gsize offset = (n_tiles - 1) * HYSCAN_BUFFER_TILE_SIZE;
+      gsize n_tile_values = MIN (HYSCAN_BUFFER_TILE_SIZE, n_values - offset);
+
+      decode (tile, raw8 + hyscan_buffer_raw_offset (offset, point_size, format->n_values), n_tile_values);
+      memcpy (values + offset, tile, n_tile_values * sizeof (gfloat));
+    }
+}
+
+/* Функция кодирует n_points точек данных, записывая результат на место
+ * исходных данных. Размер значения в формате хранения не превышает размер
+ * gfloat, поэтому данные кодируются с начала. */
+void
+hyscan_buffer_internal_encode_in_place (const HyScanBufferFormat *format,
+                                        gpointer                  data,
+                                        guint32                   n_points)
+{
+  const HyScanBufferCodecs *codecs = hyscan_buffer_internal_get_codecs ();
+  HyScanBufferEncodeFunc encode = codecs->encode[format->codec];
+  gfloat tile[HYSCAN_BUFFER_TILE_SIZE];
+  guint8 *raw8 = data;
+  gfloat *values = data;
+  gsize point_size;
+  gsize n_values;
+  gsize offset;
+
+  if (hyscan_buffer_internal_is_identity (format))
+    return;
+
+  point_size = hyscan_data_get_point_size (format->type);
+  n_values = (gsize)n_points * format->n_values;
+
+  if (point_size == format->n_values * sizeof (gfloat))
+    {
+      encode (data, values, n_values);
+      return;
+    }
+
+  for (offset = 0; offset < n_values; offset += HYSCAN_BUFFER_TILE_SIZE)
+    {
+      gsize n_tile_values = MIN (HYSCAN_BUFFER_TILE_SIZE, n_values - offset);
+
+      memcpy (tile, values + offset, n_tile_values * sizeof (gfloat));
+      encode (raw8 + hyscan_buffer_raw_offset (offset, point_size, format->n_values), tile, n_tile_values);
+    }
+}
+
+/* Функция декодирует n_points точек данных и раскладывает значения точек
+ * по отдельным массивам. Данные декодируются частями в промежуточный буфер,
+ * находящийся в кэше, из которого значения распределяются по массивам. */
+void
+hyscan_buffer_internal_decode_planar (const HyScanBufferFormat *format,
+                                      gfloat                  **planes,
+                                      gconstpointer             raw,
+                                      guint32                   n_points)
+{
+  const HyScanBufferCodecs *codecs = hyscan_buffer_internal_get_codecs ();
+  HyScanBufferDecodeFunc decode = codecs->decode[format->codec];
+  gfloat tile[HYSCAN_BUFFER_TILE_SIZE];
+  const guint8 *raw8 = raw;
+  gsize point_size;
+  gsize tile_points;
+  gsize offset;
+
+  point_size = hyscan_data_get_point_size (format->type);
+  tile_points = HYSCAN_BUFFER_TILE_SIZE / format->n_values;
+
+  for (offset = 0; offset < n_points; offset += tile_points)
+    {
+      gsize n_tile_points = MIN (tile_points, n_points - offset);
+      gsize i, j;
+
+      decode (tile, raw8 + offset * point_size, n_tile_points * format->n_values);
+
+      if (format->n_values == 2)
+        {
+          gfloat *re = planes[0] + offset;
+          gfloat *im = planes[1] + offset;
+
+          for (i = 0; i < n_tile_points; i++)
+            {
+              re[i] = tile[2 * i];
+              im[i] = tile[2 * i + 1];
+            }
+        }
+      else
+        {
+          for (j = 0; j < format->n_values; j++)
+            {
+              gfloat *plane = planes[j] + offset;
+
+              for (i = 0; i < n_tile_points; i++)
+                plane[i] = tile[i * format->n_values + j];
+            }
+        }
+    }
+}
+
+/* Функция возвращает величину, по которой выбирается максимальная точка:
+ * модуль значения, квадрат амплитуды комплексного числа или амплитуду цели. */
+static inline gfloat
+hyscan_buffer_decimate_metric (const gfloat *point,
+                               guint         n_values)
+{
+  if (n_values == 2)
+    return point[0] * point[0] + point[1] * point[1];
+
+  if (n_values == 3)
+    return point[2];
+
+  return fabsf (point[0]);
+}
+
+/* Функция декодирует n_points точек данных, прореживая их в factor раз.
+ * Последняя группа может содержать меньше factor точек. */
+void
+hyscan_buffer_internal_decimate (const HyScanBufferFormat *format,
+                                 gfloat                   *values,
+                                 gconstpointer             raw,
+                                 guint32                   n_points,
+                                 guint32                   factor,
+                                 HyScanBufferDecimation    decimation)
+{
+  const HyScanBufferCodecs *codecs = hyscan_buffer_internal_get_codecs ();
+  HyScanBufferDecodeFunc decode = codecs->decode[format->codec];
+  gfloat tile[HYSCAN_BUFFER_TILE_SIZE];
+  const guint8 *raw8 = raw;
+  guint n_values = format->n_values;
+  gsize point_size;
+  gsize tile_points;
+  gsize start;
+
+  gdouble sum[3] = { 0.0, 0.0, 0.0 };
+  gfloat best_metric = 0.0f;
+  guint32 count = 0;
+  gfloat *out = values;
+
+  point_size = hyscan_data_get_point_size (format->type);
+
+  /* Декодируются только первые точки групп. */
+  if (decimation == HYSCAN_BUFFER_DECIMATION_STRIDE)
+    {
+      for (start = 0; start < n_points; start += factor, out += n_values)
+        decode (out, raw8 + start * point_size, n_values);
+
+      return;
+    }
+
+  tile_points = HYSCAN_BUFFER_TILE_SIZE / n_values;
+
+  for (start = 0; start < n_points; start += tile_points)
+    {
+      gsize n_tile_points = MIN (tile_points, n_points - start);
+      gsize i;
+      guint j;
+
+      decode (tile, raw8 + start * point_size, n_tile_points * n_values);
+
+      for (i = 0; i < n_tile_points; i++)
+        {
+          const gfloat *point = tile + i * n_values;
+
+          if (decimation == HYSCAN_BUFFER_DECIMATION_MAX)
+            {
+              gfloat metric = hyscan_buffer_decimate_metric (point, n_values);
+
+              if ((count == 0) || (metric > best_metric))
+                {
+                  best_metric = metric;
+                  for (j = 0; j < n_values; j++)
+                    out[j] = point[j];
+                }
+            }
+          else
+            {
+              for (j = 0; j < n_values; j++)
+                sum[j] += point[j];
+            }
+
+          count += 1;
+
+          /* Завершение группы. */
+          if ((count == factor) || (start + i + 1 == n_points))
+            {
+              if (decimation == HYSCAN_BUFFER_DECIMATION_MEAN)
+                {
+                  for (j = 0; j < n_values; j++)
+                    {
+                      out[j] = sum[j] / count;
+                      sum[j] = 0.0;
+                    }
+                }
+
+              out += n_values;
+              count = 0;
+            }
+        }
+    }
+}
+
+/* Функция преобразовывает n_points точек данных из одного формата хранения
+ * в другой через промежуточный буфер размером в часть данных. */
+void
+hyscan_buffer_internal_transcode (const HyScanBufferFormat *dst_format,
+                                  gpointer                  dst,
+                                  const HyScanBufferFormat *src_format,
+                                  gconstpointer             src,
+                                  guint32                   n_points)
+{
+  const HyScanBufferCodecs *codecs = hyscan_buffer_internal_get_codecs ();
+  HyScanBufferDecodeFunc decode = codecs->decode[src_format->codec];
+  HyScanBufferEncodeFunc encode = codecs->encode[dst_format->codec];
+  gfloat tile[HYSCAN_BUFFER_TILE_SIZE];
+  const guint8 *src8 = src;
+  guint8 *dst8 = dst;
+  gsize src_point_size;
+  gsize dst_point_size;
+  gsize n_values;
+  gsize offset;
+
+  src_point_size = hyscan_data_get_point_size (src_format->type);
+  dst_point_size = hyscan_data_get_point_size (dst_format->type);
+  n_values = (gsize)n_points * src_format->n_values;
+
+  for (offset = 0; offset < n_values; offset += HYSCAN_BUFFER_TILE_SIZE)
+    {
+      gsize n_tile_values = MIN (HYSCAN_BUFFER_TILE_SIZE, n_values - offset);
+
+      decode (tile, src8 + hyscan_buffer_raw_offset (offset, src_point_size, src_format->n_values), n_tile_values);
+      encode (dst8 + hyscan_buffer_raw_offset (offset, dst_point_size, dst_format->n_values), tile, n_tile_values);
+    }
+}
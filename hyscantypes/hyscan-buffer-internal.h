@@ -0,0 +1,199 @@
+/* hyscan-buffer-internal.h
+ *
+ * Copyright 2017-2018 Screen LLC, Andrei Fadeev <andrei@webcontrol.ru>
+ *
+ * This file is part of HyScanTypes.
+ *
+ * HyScanTypes is dual-licensed: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * HyScanTypes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Alternatively, you can license this code under a commercial license.
+ * Contact the Screen LLC in this case - <info@screen-co.ru>.
+ */
+
+/* HyScanTypes имеет двойную лицензию.
+ *
+ * Во-первых, вы можете распространять HyScanTypes на условиях Стандартной
+ * Общественной Лицензии GNU версии 3, либо по любой более поздней версии
+ * лицензии (по вашему выбору). Полные положения лицензии GNU приведены в
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Во-вторых, этот программный код можно использовать по коммерческой
+ * лицензии. Для этого свяжитесь с ООО Экран - <info@screen-co.ru>.
+ */
+
+#ifndef __HYSCAN_BUFFER_INTERNAL_H__
+#define __HYSCAN_BUFFER_INTERNAL_H__
+
+#include "hyscan-buffer.h"
+
+/* Максимальный размер одной точки данных в байтах. */
+#define HYSCAN_BUFFER_MAX_POINT_SIZE   32
+
+/* Форматы хранения отдельных значений. */
+typedef enum
+{
+  HYSCAN_BUFFER_CODEC_INVALID,                                 /* Недопустимый формат. */
+
+  HYSCAN_BUFFER_CODEC_FLOAT,                                   /* gfloat, нативный порядок байт. */
+  HYSCAN_BUFFER_CODEC_ADC14LE,                                 /* Отсчёты АЦП, младшие 14 бит из 16. */
+  HYSCAN_BUFFER_CODEC_ADC16LE,                                 /* Отсчёты АЦП, 16 бит. */
+  HYSCAN_BUFFER_CODEC_ADC24LE,                                 /* Отсчёты АЦП, младшие 24 бит из 32. */
+  HYSCAN_BUFFER_CODEC_INT8,                                    /* Амплитуда, 8 бит. */
+  HYSCAN_BUFFER_CODEC_INT16LE,                                 /* Амплитуда, 16 бит. */
+  HYSCAN_BUFFER_CODEC_INT24LE,                                 /* Амплитуда, младшие 24 бит из 32. */
+  HYSCAN_BUFFER_CODEC_INT32LE,                                 /* Амплитуда, 32 бит. */
+  HYSCAN_BUFFER_CODEC_FLOAT16LE,                               /* Значения с плавающей точкой, 16 бит. */
+  HYSCAN_BUFFER_CODEC_FLOAT32LE,                               /* Значения с плавающей точкой, 32 бит. */
+  HYSCAN_BUFFER_CODEC_ADC24LE_PACKED,                          /* Отсчёты АЦП, 24 бит в 3 байтах. */
+  HYSCAN_BUFFER_CODEC_INT24LE_PACKED,                          /* Амплитуда, 24 бит в 3 байтах. */
+  HYSCAN_BUFFER_CODEC_ADC12LE,                                 /* Отсчёты АЦП, младшие 12 бит из 16. */
+  HYSCAN_BUFFER_CODEC_ADC12LE_PACKED,                          /* Отсчёты АЦП, пары по 12 бит в 3 байтах. */
+  HYSCAN_BUFFER_CODEC_BFLOAT16LE,                              /* Значения с плавающей точкой, bfloat16. */
+
+  HYSCAN_BUFFER_CODEC_LAST
+} HyScanBufferCodec;
+
+/* Функция декодирования n_values значений из формата хранения в gfloat. */
+typedef void (*HyScanBufferDecodeFunc)                         (gfloat                *values,
+                                                                gconstpointer          raw,
+                                                                gsize                  n_values);
+
+/* Функция кодирования n_values значений gfloat в формат хранения. */
+typedef void (*HyScanBufferEncodeFunc)                         (gpointer               raw,
+                                                                const gfloat          *values,
+                                                                gsize                  n_values);
+
+/* Функция вычисления амплитуды n_points комплексных значений. Массивы
+ * amplitude и values могут совпадать. */
+typedef void (*HyScanBufferAmplitudeFunc)                      (gfloat                *amplitude,
+                                                                const gfloat          *values,
+                                                                gsize                  n_points);
+
+/* Описание типа данных, допускающего импорт и экспорт. */
+typedef struct
+{
+  HyScanDataType               type;                           /* Тип данных. */
+  HyScanDataType               float_type;                     /* Тип данных после импорта. */
+  HyScanBufferCodec            codec;                          /* Формат хранения значений. */
+  guint                        n_values;                       /* Число значений в одной точке. */
+} HyScanBufferFormat;
+
+/* Набор функций преобразования для определённого набора инструкций. */
+typedef struct
+{
+  HyScanBufferSimd             simd;                           /* Набор инструкций. */
+  HyScanBufferDecodeFunc       decode[HYSCAN_BUFFER_CODEC_LAST]; /* Функции декодирования. */
+  HyScanBufferEncodeFunc       encode[HYSCAN_BUFFER_CODEC_LAST]; /* Функции кодирования. */
+  HyScanBufferAmplitudeFunc    amplitude;                      /* Функция вычисления амплитуды. */
+} HyScanBufferCodecs;
+
+/* Функция обработки одной части задачи с номером index. */
+typedef void (*HyScanBufferTaskFunc)                           (gpointer               data,
+                                                                guint                  index);
+
+/* Функция возвращает описание типа данных или NULL, если тип не поддерживается. */
+const HyScanBufferFormat *     hyscan_buffer_internal_get_format       (HyScanDataType         type);
+
+/* Функция проверяет, совпадает ли формат хранения значений с gfloat, т.е.
+ * не требует преобразования на текущей платформе. */
+gboolean                       hyscan_buffer_internal_is_identity      (const HyScanBufferFormat *format);
+
+/* Функция возвращает текущий набор функций преобразования. */
+const HyScanBufferCodecs *     hyscan_buffer_internal_get_codecs       (void);
+
+/* Функция выбирает набор функций преобразования. */
+gboolean                       hyscan_buffer_internal_set_simd         (HyScanBufferSimd       simd);
+
+/* Функция устанавливает минимальное число точек для параллельного преобразования. */
+void                           hyscan_buffer_internal_set_parallel_threshold
+                                                                       (guint32                n_points);
+
+/* Функция возвращает минимальное число точек для параллельного преобразования. */
+guint32                        hyscan_buffer_internal_get_parallel_threshold
+                                                                       (void);
+
+/* Функция определяет число потоков для преобразования n_points точек. Если
+ * n_threads равно 0, используется число процессоров. */
+guint                          hyscan_buffer_internal_get_n_threads    (guint32                n_points,
+                                                                        guint                  n_threads);
+
+/* Функция выполняет n_tasks частей задачи в n_threads потоках, включая
+ * вызывающий. Функция возвращает управление после завершения всех частей. */
+void                           hyscan_buffer_internal_parallel         (HyScanBufferTaskFunc   func,
+                                                                        gpointer               data,
+                                                                        guint                  n_tasks,
+                                                                        guint                  n_threads);
+
+/* Функция декодирует n_points точек данных, используя до n_threads потоков. */
+void                           hyscan_buffer_internal_decode           (const HyScanBufferFormat *format,
+                                                                        gfloat                *values,
+                                                                        gconstpointer          raw,
+                                                                        guint32                n_points,
+                                                                        guint                  n_threads);
+
+/* Функция декодирует n_points точек данных и выполняет над значениями
+ * последовательность операций. Преобразование выполняется частями, так что
+ * все операции над частью данных выполняются, пока она находится в кэше.
+ * Если в последовательности есть операция вычисления амплитуды комплексных
+ * данных, число значений в результате уменьшается в два раза. */
+void                           hyscan_buffer_internal_transform        (const HyScanBufferFormat *format,
+                                                                        gfloat                *values,
+                                                                        gconstpointer          raw,
+                                                                        guint32                n_points,
+                                                                        const HyScanBufferOp  *ops,
+                                                                        guint                  n_ops);
+
+/* Функция декодирует n_points точек данных, записывая результат на место
+ * исходных данных. Размер памяти должен быть достаточен для результата. */
+void                           hyscan_buffer_internal_decode_in_place  (const HyScanBufferFormat *format,
+                                                                        gpointer               data,
+                                                                        guint32                n_points);
+
+/* Функция кодирует n_points точек данных, записывая результат на место
+ * исходных данных. */
+void                           hyscan_buffer_internal_encode_in_place  (const HyScanBufferFormat *format,
+                                                                        gpointer               data,
+                                                                        guint32                n_points);
+
+/* Функция декодирует n_points точек данных и раскладывает значения точек
+ * по отдельным массивам, число которых равно числу значений в точке. */
+void                           hyscan_buffer_internal_decode_planar    (const HyScanBufferFormat *format,
+                                                                        gfloat               **planes,
+                                                                        gconstpointer          raw,
+                                                                        guint32                n_points);
+
+/* Функция декодирует n_points точек данных, прореживая их в factor раз. */
+void                           hyscan_buffer_internal_decimate         (const HyScanBufferFormat *format,
+                                                                        gfloat                *values,
+                                                                        gconstpointer          raw,
+                                                                        guint32                n_points,
+                                                                        guint32                factor,
+                                                                        HyScanBufferDecimation decimation);
+
+/* Функция преобразовывает n_points точек данных из одного формата хранения
+ * в другой через промежуточный буфер размером в часть данных. */
+void                           hyscan_buffer_internal_transcode        (const HyScanBufferFormat *dst_format,
+                                                                        gpointer               dst,
+                                                                        const HyScanBufferFormat *src_format,
+                                                                        gconstpointer          src,
+                                                                        guint32                n_points);
+
+/* Функция кодирует n_points точек данных, используя до n_threads потоков. */
+void                           hyscan_buffer_internal_encode           (const HyScanBufferFormat *format,
+                                                                        gpointer               raw,
+                                                                        const gfloat          *values,
+                                                                        guint32                n_points,
+                                                                        guint                  n_threads);
+
+#endif /* __HYSCAN_BUFFER_INTERNAL_H__ */
@@ -0,0 +1,455 @@
+/* hyscan-buffer-pool.c
+ *
+ * Copyright 2019 Screen LLC, Andrei Fadeev <andrei@webcontrol.ru>
+ *
+ * This file is part of HyScanTypes.
+ *
+ * HyScanTypes is dual-licensed: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * HyScanTypes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Alternatively, you can license this code under a commercial license.
+ * Contact the Screen LLC in this case - <info@screen-co.ru>.
+ */
+
+/* HyScanTypes имеет двойную лицензию.
+ *
+ * Во-первых, вы можете распространять HyScanTypes на условиях Стандартной
+ * Общественной Лицензии GNU версии 3, либо по любой более поздней версии
+ * лицензии (по вашему выбору). Полные положения лицензии GNU приведены в
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Во-вторых, этот программный код можно использовать по коммерческой
+ * лицензии. Для этого свяжитесь с ООО Экран - <info@screen-co.ru>.
+ */
+
+/**
+ * SECTION: hyscan-buffer-pool
+ * @Short_description: пул буферов данных
+ * @Title: HyScanBufferPool
+ *
+ * Класс предназначен для повторного использования объектов #HyScanBuffer
+ * вместе с выделенной ими памятью. Это позволяет избежать создания объектов
+ * и выделения памяти при обработке потока данных.
+ *
+ * Создание объекта класса осуществляется функцией #hyscan_buffer_pool_new.
+ * Общий для всего процесса пул можно получить функцией
+ * #hyscan_buffer_pool_get_default.
+ *
+ * Функция #hyscan_buffer_pool_acquire возвращает буфер, размер памяти которого
+ * не меньше запрошенного. Тип и содержимое данных в буфере не определены.
+ * После использования буфер возвращается в пул функцией
+ * #hyscan_buffer_pool_release.
+ *
+ * Буферы хранятся по классам размеров памяти, кратным степени двойки. Кроме
+ * общего для всех потоков списка буферов, каждый поток хранит несколько
+ * буферов каждого класса в собственном кэше. Блокировку кэша использует
+ * только его поток, за исключением очистки пула, поэтому она практически
+ * никогда не ожидает. Кэш потока хранит буферы одного пула: при обращении
+ * потока к другому пулу и при завершении потока буферы кэша возвращаются в
+ * общий список своего пула. Буферы пула удаляются из кэшей всех потоков при
+ * его очистке и удалении.
+ *
+ * Число запросов, обслуженных без создания буфера, и число запросов,
+ * потребовавших создания нового буфера, можно узнать функцией
+ * #hyscan_buffer_pool_get_stats.
+ *
+ * Функции класса могут вызываться из разных потоков одновременно.
+ */
+
+#include "hyscan-buffer-pool.h"
+
+#define HYSCAN_BUFFER_POOL_N_CLASSES       32          /* Число классов размеров памяти. */
+#define HYSCAN_BUFFER_POOL_MIN_CLASS       6           /* Минимальный класс, 64 байта. */
+#define HYSCAN_BUFFER_POOL_MAX_BUFFERS     32          /* Число буферов одного класса в пуле. */
+#define HYSCAN_BUFFER_POOL_CACHE_BUFFERS   4           /* Число буферов одного класса в кэше потока. */
+
+/* Список буферов одного класса размера памяти. */
+typedef struct
+{
+  HyScanBuffer                *buffers[HYSCAN_BUFFER_POOL_MAX_BUFFERS];
+  guint                        n_buffers;
+} HyScanBufferPoolClassList;
+
+/* Кэш буферов потока. */
+typedef struct
+{
+  GMutex                       lock;           /* Блокировка. */
+  HyScanBufferPoolPrivate     *owner;          /* Пул, которому принадлежат буферы. */
+  HyScanBuffer                *buffers[HYSCAN_BUFFER_POOL_N_CLASSES][HYSCAN_BUFFER_POOL_CACHE_BUFFERS];
+  guint                        n_buffers[HYSCAN_BUFFER_POOL_N_CLASSES];
+} HyScanBufferPoolCache;
+
+struct _HyScanBufferPoolPrivate
+{
+  GMutex                       lock;           /* Блокировка. */
+  HyScanBufferPoolClassList    classes[HYSCAN_BUFFER_POOL_N_CLASSES];
+
+  gint                         hits;           /* Число запросов, обслуженных из пула. */
+  gint                         misses;         /* Число созданных буферов. */
+};
+
+static void                    hyscan_buffer_pool_object_finalize      (GObject       *object);
+static void                    hyscan_buffer_pool_cache_free           (gpointer       data);
+
+static GPrivate hyscan_buffer_pool_cache = G_PRIVATE_INIT (hyscan_buffer_pool_cache_free);
+
+/* Список кэшей всех потоков. */
+static GMutex hyscan_buffer_pool_caches_lock;
+static GList *hyscan_buffer_pool_caches = NULL;
+
+G_DEFINE_TYPE_WITH_PRIVATE (HyScanBufferPool, hyscan_buffer_pool, G_TYPE_OBJECT)
+
+static void
+hyscan_buffer_pool_class_init (HyScanBufferPoolClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->finalize = hyscan_buffer_pool_object_finalize;
+}
+
+static void
+hyscan_buffer_pool_init (HyScanBufferPool *pool)
+{
+  pool->priv = hyscan_buffer_pool_get_instance_private (pool);
+
+  g_mutex_init (&pool->priv->lock);
+}
+
+static void
+hyscan_buffer_pool_object_finalize (GObject *object)
+{
+  HyScanBufferPool *pool = HYSCAN_BUFFER_POOL (object);
+  HyScanBufferPoolPrivate *priv = pool->priv;
+
+  hyscan_buffer_pool_clear (pool);
+  g_mutex_clear (&priv->lock);
+
+  G_OBJECT_CLASS (hyscan_buffer_pool_parent_class)->finalize (object);
+}
+
+/* Функция удаляет все буферы из кэша потока. */
+static void
+hyscan_buffer_pool_cache_flush (HyScanBufferPoolCache *cache)
+{
+  guint i, j;
+
+  for (i = 0; i < HYSCAN_BUFFER_POOL_N_CLASSES; i++)
+    {
+      for (j = 0; j < cache->n_buffers[i]; j++)
+        g_object_unref (cache->buffers[i][j]);
+
+      cache->n_buffers[i] = 0;
+    }
+
+  cache->owner = NULL;
+}
+
+/* Функция возвращает буферы кэша потока в общий список пула, которому они
+ * принадлежат. Не поместившиеся в список буферы удаляются. */
+static void
+hyscan_buffer_pool_cache_evict (HyScanBufferPoolCache *cache)
+{
+  HyScanBufferPoolPrivate *owner = cache->owner;
+  guint i;
+
+  if (owner == NULL)
+    return;
+
+  g_mutex_lock (&owner->lock);
+  for (i = 0; i < HYSCAN_BUFFER_POOL_N_CLASSES; i++)
+    {
+      HyScanBufferPoolClassList *list = &owner->classes[i];
+
+      while ((cache->n_buffers[i] > 0) && (list->n_buffers < HYSCAN_BUFFER_POOL_MAX_BUFFERS))
+        list->buffers[list->n_buffers++] = cache->buffers[i][--cache->n_buffers[i]];
+    }
+  g_mutex_unlock (&owner->lock);
+
+  hyscan_buffer_pool_cache_flush (cache);
+}
+
+/* Функция освобождает кэш буферов завершающегося потока. Пул не может быть
+ * удалён, пока удерживается блокировка списка кэшей. */
+static void
+hyscan_buffer_pool_cache_free (gpointer data)
+{
+  HyScanBufferPoolCache *cache = data;
+
+  g_mutex_lock (&hyscan_buffer_pool_caches_lock);
+  hyscan_buffer_pool_caches = g_list_remove (hyscan_buffer_pool_caches, cache);
+  hyscan_buffer_pool_cache_evict (cache);
+  g_mutex_unlock (&hyscan_buffer_pool_caches_lock);
+  g_mutex_clear (&cache->lock);
+
+  g_slice_free (HyScanBufferPoolCache, cache);
+}
+
+/* Функция блокирует кэш буферов текущего потока и возвращает его. Если в
+ * кэше находятся буферы другого пула, они возвращаются в этот пул. */
+static HyScanBufferPoolCache *
+hyscan_buffer_pool_lock_cache (HyScanBufferPoolPrivate *priv)
+{
+  HyScanBufferPoolCache *cache = g_private_get (&hyscan_buffer_pool_cache);
+
+  if (cache == NULL)
+    {
+      cache = g_slice_new0 (HyScanBufferPoolCache);
+      g_mutex_init (&cache->lock);
+      g_private_set (&hyscan_buffer_pool_cache, cache);
+
+      g_mutex_lock (&hyscan_buffer_pool_caches_lock);
+      hyscan_buffer_pool_caches = g_list_prepend (hyscan_buffer_pool_caches, cache);
+      g_mutex_unlock (&hyscan_buffer_pool_caches_lock);
+    }
+
+  g_mutex_lock (&cache->lock);
+
+  if (cache->owner != priv)
+    {
+      hyscan_buffer_pool_cache_evict (cache);
+      cache->owner = priv;
+    }
+
+  return cache;
+}
+
+/**
+ * hyscan_buffer_pool_new:
+ *
+ * Функция создаёт новый объект #HyScanBufferPool.
+ *
+ * Returns: #HyScanBufferPool. Для удаления #g_object_unref.
+ */
+HyScanBufferPool *
+hyscan_buffer_pool_new (void)
+{
+  return g_object_new (HYSCAN_TYPE_BUFFER_POOL, NULL);
+}
+
+/**
+ * hyscan_buffer_pool_get_default:
+ *
+ * Функция возвращает общий для всего процесса пул буферов.
+ *
+ * Returns: (transfer none): #HyScanBufferPool.
+ */
+HyScanBufferPool *
+hyscan_buffer_pool_get_default (void)
+{
+  static HyScanBufferPool *pool = NULL;
+
+  if (g_once_init_enter (&pool))
+    g_once_init_leave (&pool, hyscan_buffer_pool_new ());
+
+  return pool;
+}
+
+/**
+ * hyscan_buffer_pool_acquire:
+ * @pool: указатель на #HyScanBufferPool
+ * @size: размер данных
+ *
+ * Функция возвращает буфер, размер памяти которого не меньше @size байт.
+ * Если подходящего буфера нет в пуле, создаётся новый буфер.
+ *
+ * Returns: (transfer full): #HyScanBuffer. Для возвращения в пул
+ *          #hyscan_buffer_pool_release.
+ */
+HyScanBuffer *
+hyscan_buffer_pool_acquire (HyScanBufferPool *pool,
+                            guint32           size)
+{
+  HyScanBufferPoolPrivate *priv;
+  HyScanBufferPoolClassList *list;
+  HyScanBufferPoolCache *cache;
+  HyScanBuffer *buffer = NULL;
+  guint index;
+
+  g_return_val_if_fail (HYSCAN_IS_BUFFER_POOL (pool), NULL);
+
+  priv = pool->priv;
+
+  /* Класс размера памяти, способный вместить size байт. */
+  index = (size > 1) ? g_bit_storage (size - 1) : 0;
+  index = MAX (index, HYSCAN_BUFFER_POOL_MIN_CLASS);
+
+  /* Слишком большие буферы не хранятся. */
+  if (index >= HYSCAN_BUFFER_POOL_N_CLASSES)
+    {
+      buffer = hyscan_buffer_new ();
+      hyscan_buffer_reserve (buffer, size);
+      g_atomic_int_inc (&priv->misses);
+
+      return buffer;
+    }
+
+  /* Буфер из кэша потока. */
+  cache = hyscan_buffer_pool_lock_cache (priv);
+  if (cache->n_buffers[index] > 0)
+    buffer = cache->buffers[index][--cache->n_buffers[index]];
+  g_mutex_unlock (&cache->lock);
+
+  if (buffer != NULL)
+    {
+      g_atomic_int_inc (&priv->hits);
+
+      return buffer;
+    }
+
+  /* Буфер из общего списка. */
+  list = &priv->classes[index];
+  g_mutex_lock (&priv->lock);
+  if (list->n_buffers > 0)
+    buffer = list->buffers[--list->n_buffers];
+  g_mutex_unlock (&priv->lock);
+
+  if (buffer != NULL)
+    {
+      g_atomic_int_inc (&priv->hits);
+
+      return buffer;
+    }
+
+  /* Новый буфер с памятью, соответствующей классу. */
+  buffer = hyscan_buffer_new ();
+  hyscan_buffer_reserve (buffer, 1u << index);
+  g_atomic_int_inc (&priv->misses);
+
+  return buffer;
+}
+
+/**
+ * hyscan_buffer_pool_release:
+ * @pool: указатель на #HyScanBufferPool
+ * @buffer: (transfer full): указатель на #HyScanBuffer
+ *
+ * Функция возвращает буфер в пул. Пул забирает ссылку на буфер, других
+ * ссылок на него быть не должно. Если пул заполнен, буфер удаляется.
+ */
+void
+hyscan_buffer_pool_release (HyScanBufferPool *pool,
+                            HyScanBuffer     *buffer)
+{
+  HyScanBufferPoolPrivate *priv;
+  HyScanBufferPoolClassList *list;
+  HyScanBufferPoolCache *cache;
+  guint32 capacity;
+  guint index;
+
+  g_return_if_fail (HYSCAN_IS_BUFFER_POOL (pool));
+  g_return_if_fail (HYSCAN_IS_BUFFER (buffer));
+
+  priv = pool->priv;
+
+  /* Буфер переводится в режим выделения памяти. Обёртка над внешними
+   * данными и память, используемая совместно с копиями, при этом
+   * освобождаются. */
+  hyscan_buffer_set (buffer, HYSCAN_DATA_BLOB, NULL, 0);
+
+  /* Класс размера памяти, который буфер гарантированно вмещает. */
+  capacity = hyscan_buffer_get_capacity (buffer);
+  index = g_bit_storage (capacity);
+  if (index <= HYSCAN_BUFFER_POOL_MIN_CLASS)
+    {
+      g_object_unref (buffer);
+      return;
+    }
+
+  index = MIN (index - 1, HYSCAN_BUFFER_POOL_N_CLASSES - 1);
+
+  /* Буфер в кэш потока. */
+  cache = hyscan_buffer_pool_lock_cache (priv);
+  if (cache->n_buffers[index] < HYSCAN_BUFFER_POOL_CACHE_BUFFERS)
+    {
+      cache->buffers[index][cache->n_buffers[index]++] = buffer;
+      buffer = NULL;
+    }
+  g_mutex_unlock (&cache->lock);
+
+  if (buffer == NULL)
+    return;
+
+  /* Буфер в общий список. */
+  list = &priv->classes[index];
+  g_mutex_lock (&priv->lock);
+  if (list->n_buffers < HYSCAN_BUFFER_POOL_MAX_BUFFERS)
+    {
+      list->buffers[list->n_buffers++] = buffer;
+      buffer = NULL;
+    }
+  g_mutex_unlock (&priv->lock);
+
+  if (buffer != NULL)
+    g_object_unref (buffer);
+}
+
+/**
+ * hyscan_buffer_pool_get_stats:
+ * @pool: указатель на #HyScanBufferPool
+ * @hits: (out) (optional): число запросов, обслуженных из пула
+ * @misses: (out) (optional): число запросов, потребовавших создания буфера
+ *
+ * Функция возвращает статистику запросов буферов из пула.
+ */
+void
+hyscan_buffer_pool_get_stats (HyScanBufferPool *pool,
+                              guint            *hits,
+                              guint            *misses)
+{
+  g_return_if_fail (HYSCAN_IS_BUFFER_POOL (pool));
+
+  (hits != NULL) ? *hits = g_atomic_int_get (&pool->priv->hits) : 0;
+  (misses != NULL) ? *misses = g_atomic_int_get (&pool->priv->misses) : 0;
+}
+
+/**
+ * hyscan_buffer_pool_clear:
+ * @pool: указатель на #HyScanBufferPool
+ *
+ * Функция удаляет все буферы пула из общего списка и из кэшей всех потоков.
+ */
+void
+hyscan_buffer_pool_clear (HyScanBufferPool *pool)
+{
+  HyScanBufferPoolPrivate *priv;
+  GList *link;
+  guint i, j;
+
+  g_return_if_fail (HYSCAN_IS_BUFFER_POOL (pool));
+
+  priv = pool->priv;
+
+  /* Кэши потоков очищаются первыми, т.к. при переключении потока на другой
+   * пул буферы кэша возвращаются в общий список. */
+  g_mutex_lock (&hyscan_buffer_pool_caches_lock);
+  for (link = hyscan_buffer_pool_caches; link != NULL; link = link->next)
+    {
+      HyScanBufferPoolCache *cache = link->data;
+
+      g_mutex_lock (&cache->lock);
+      if (cache->owner == priv)
+        hyscan_buffer_pool_cache_flush (cache);
+      g_mutex_unlock (&cache->lock);
+    }
+  g_mutex_unlock (&hyscan_buffer_pool_caches_lock);
+
+  g_mutex_lock (&priv->lock);
+  for (i = 0; i < HYSCAN_BUFFER_POOL_N_CLASSES; i++)
+    {
+      for (j = 0; j < priv->classes[i].n_buffers; j++)
+        g_object_unref (priv->classes[i].buffers[j]);
+
+      priv->classes[i].n_buffers = 0;
+    }
+  g_mutex_unlock (&priv->lock);
+}
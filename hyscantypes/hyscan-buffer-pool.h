@@ -0,0 +1,92 @@
+/* hyscan-buffer-pool.h
+ *
+ * Copyright 2019 Screen LLC, Andrei Fadeev <andrei@webcontrol.ru>
+ *
+ * This file is part of HyScanTypes.
+ *
+ * HyScanTypes is dual-licensed: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * HyScanTypes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Alternatively, you can license this code under a commercial license.
+ * Contact the Screen LLC in this case - <info@screen-co.ru>.
+ */
+
+/* HyScanTypes имеет двойную лицензию.
+ *
+ * Во-первых, вы можете распространять HyScanTypes на условиях Стандартной
+ * Общественной Лицензии GNU версии 3, либо по любой более поздней версии
+ * лицензии (по вашему выбору). Полные положения лицензии GNU приведены в
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Во-вторых, этот программный код можно использовать по коммерческой
+ * лицензии. Для этого свяжитесь с ООО Экран - <info@screen-co.ru>.
+ */
+
+#ifndef __HYSCAN_BUFFER_POOL_H__
+#define __HYSCAN_BUFFER_POOL_H__
+
+#include <hyscan-buffer.h>
+
+G_BEGIN_DECLS
+
+#define HYSCAN_TYPE_BUFFER_POOL             (hyscan_buffer_pool_get_type ())
+#define HYSCAN_BUFFER_POOL(obj)             (G_TYPE_CHECK_INSTANCE_CAST ((obj), HYSCAN_TYPE_BUFFER_POOL, HyScanBufferPool))
+#define HYSCAN_IS_BUFFER_POOL(obj)          (G_TYPE_CHECK_INSTANCE_TYPE ((obj), HYSCAN_TYPE_BUFFER_POOL))
+#define HYSCAN_BUFFER_POOL_CLASS(klass)     (G_TYPE_CHECK_CLASS_CAST ((klass), HYSCAN_TYPE_BUFFER_POOL, HyScanBufferPoolClass))
+#define HYSCAN_IS_BUFFER_POOL_CLASS(klass)  (G_TYPE_CHECK_CLASS_TYPE ((klass), HYSCAN_TYPE_BUFFER_POOL))
+#define HYSCAN_BUFFER_POOL_GET_CLASS(obj)   (G_TYPE_INSTANCE_GET_CLASS ((obj), HYSCAN_TYPE_BUFFER_POOL, HyScanBufferPoolClass))
+
+typedef struct _HyScanBufferPool HyScanBufferPool;
+typedef struct _HyScanBufferPoolPrivate HyScanBufferPoolPrivate;
+typedef struct _HyScanBufferPoolClass HyScanBufferPoolClass;
+
+struct _HyScanBufferPool
+{
+  GObject parent_instance;
+
+  HyScanBufferPoolPrivate *priv;
+};
+
+struct _HyScanBufferPoolClass
+{
+  GObjectClass parent_class;
+};
+
+HYSCAN_API
+GType                  hyscan_buffer_pool_get_type      (void);
+
+HYSCAN_API
+HyScanBufferPool *     hyscan_buffer_pool_new           (void);
+
+HYSCAN_API
+HyScanBufferPool *     hyscan_buffer_pool_get_default   (void);
+
+HYSCAN_API
+HyScanBuffer *         hyscan_buffer_pool_acquire       (HyScanBufferPool      *pool,
+                                                         guint32                size);
+
+HYSCAN_API
+void                   hyscan_buffer_pool_release       (HyScanBufferPool      *pool,
+                                                         HyScanBuffer          *buffer);
+
+HYSCAN_API
+void                   hyscan_buffer_pool_get_stats     (HyScanBufferPool      *pool,
+                                                         guint                 *hits,
+                                                         guint                 *misses);
+
+HYSCAN_API
+void                   hyscan_buffer_pool_clear         (HyScanBufferPool      *pool);
+
+G_END_DECLS
+
+#endif /* __HYSCAN_BUFFER_POOL_H__ */
@@ -0,0 +1,519 @@
+/* hyscan-buffer-queue.c
+ *
+ * Copyright 2019 Screen LLC, Andrei Fadeev <andrei@webcontrol.ru>
+ *
+ * This file is part of HyScanTypes.
+ *
+ * HyScanTypes is dual-licensed: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * HyScanTypes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Alternatively, you can license this code under a commercial license.
+ * Contact the Screen LLC in this case - <info@screen-co.ru>.
+ */
+
+/* HyScanTypes имеет двойную лицензию.
+ *
+ * Во-первых, вы можете распространять HyScanTypes на условиях Стандартной
+ * Общественной Лицензии GNU версии 3, либо по любой более поздней версии
+ * лицензии (по вашему выбору). Полные положения лицензии GNU приведены в
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Во-вторых, этот программный код можно использовать по коммерческой
+ * лицензии. Для этого свяжитесь с ООО Экран - <info@screen-co.ru>.
+ */
+
+/**
+ * SECTION: hyscan-buffer-queue
+ * @Short_description: очередь буферов для нескольких потоков
+ * @Title: HyScanBufferQueue
+ *
+ * Класс предназначен для передачи данных от нескольких потоков-производителей
+ * нескольким потокам-потребителям. Очередь содержит фиксированное число
+ * заранее созданных объектов #HyScanBuffer, которые после обработки
+ * возвращаются производителям. Поэтому в установившемся режиме передача
+ * данных не требует создания объектов и выделения памяти.
+ *
+ * Создание объекта класса осуществляется функцией #hyscan_buffer_queue_new.
+ *
+ * Производитель получает свободный буфер функцией #hyscan_buffer_queue_acquire,
+ * записывает в него данные и помещает в очередь функцией
+ * #hyscan_buffer_queue_push. Потребитель извлекает самый старый буфер из
+ * очереди функцией #hyscan_buffer_queue_pop, с ожиданием данных, или функцией
+ * #hyscan_buffer_queue_try_pop, без ожидания. После обработки данных буфер
+ * возвращается в список свободных функцией #hyscan_buffer_queue_release.
+ *
+ * Поведение очереди при отсутствии свободных буферов, т.е. когда потребители
+ * не успевают обрабатывать данные, определяется политикой
+ * #HyScanBufferQueuePolicy:
+ *
+ * - #HYSCAN_BUFFER_QUEUE_BLOCK - производитель ожидает освобождения буфера;
+ * - #HYSCAN_BUFFER_QUEUE_DROP_OLDEST - производителю отдаётся самый старый
+ *   буфер из очереди, его данные теряются;
+ * - #HYSCAN_BUFFER_QUEUE_DROP_NEWEST - производитель получает NULL и должен
+ *   отказаться от новых данных.
+ *
+ * Если при политике #HYSCAN_BUFFER_QUEUE_DROP_OLDEST очередь пуста, т.е. все
+ * буферы заняты производителями и потребителями, функция
+ * #hyscan_buffer_queue_acquire также возвращает NULL.
+ *
+ * Функция #hyscan_buffer_queue_close закрывает очередь и прерывает все
+ * ожидания. После закрытия очереди производители не получают буферов, а
+ * потребители получают оставшиеся в очереди данные.
+ *
+ * Число помещённых в очередь и потерянных буферов можно узнать функцией
+ * #hyscan_buffer_queue_get_stats.
+ *
+ * Буферы принадлежат очереди, ссылки на них не передаются. Функции класса
+ * могут вызываться из разных потоков одновременно.
+ */
+
+#include "hyscan-buffer-queue.h"
+
+struct _HyScanBufferQueuePrivate
+{
+  GMutex                       lock;           /* Блокировка. */
+  GCond                        free_cond;      /* Сигнал появления свободного буфера. */
+  GCond                        data_cond;      /* Сигнал появления данных в очереди. */
+
+  HyScanBufferQueuePolicy      policy;         /* Политика при отсутствии свободных буферов. */
+  guint                        n_buffers;      /* Общее число буферов. */
+  gboolean                     closed;         /* Признак закрытия очереди. */
+
+  HyScanBuffer               **buffers;        /* Все буферы очереди. */
+
+  HyScanBuffer               **free;           /* Стек свободных буферов. */
+  guint                        n_free;         /* Число свободных буферов. */
+
+  HyScanBuffer               **pending;        /* Кольцо буферов с данными. */
+  guint                        first;          /* Индекс самого старого буфера с данными. */
+  guint                        n_pending;      /* Число буферов с данными. */
+
+  guint                        pushed;         /* Число помещённых в очередь буферов. */
+  guint                        dropped;        /* Число потерянных буферов. */
+};
+
+static void                    hyscan_buffer_queue_object_finalize     (GObject       *object);
+
+G_DEFINE_TYPE_WITH_PRIVATE (HyScanBufferQueue, hyscan_buffer_queue, G_TYPE_OBJECT)
+
+static void
+hyscan_buffer_queue_class_init (HyScanBufferQueueClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->finalize = hyscan_buffer_queue_object_finalize;
+}
+
+static void
+hyscan_buffer_queue_init (HyScanBufferQueue *queue)
+{
+  HyScanBufferQueuePrivate *priv;
+
+  queue->priv = hyscan_buffer_queue_get_instance_private (queue);
+  priv = queue->priv;
+
+  g_mutex_init (&priv->lock);
+  g_cond_init (&priv->free_cond);
+  g_cond_init (&priv->data_cond);
+}
+
+static void
+hyscan_buffer_queue_object_finalize (GObject *object)
+{
+  HyScanBufferQueue *queue = HYSCAN_BUFFER_QUEUE (object);
+  HyScanBufferQueuePrivate *priv = queue->priv;
+  guint i;
+
+  for (i = 0; i < priv->n_buffers; i++)
+    g_object_unref (priv->buffers[i]);
+
+  g_free (priv->buffers);
+  g_free (priv->free);
+  g_free (priv->pending);
+
+  g_cond_clear (&priv->data_cond);
+  g_cond_clear (&priv->free_cond);
+  g_mutex_clear (&priv->lock);
+
+  G_OBJECT_CLASS (hyscan_buffer_queue_parent_class)->finalize (object);
+}
+
+/* Функция извлекает самый старый буфер из очереди. Вызывается под блокировкой. */
+static HyScanBuffer *
+hyscan_buffer_queue_take (HyScanBufferQueuePrivate *priv)
+{
+  HyScanBuffer *buffer;
+
+  if (priv->n_pending == 0)
+    return NULL;
+
+  buffer = priv->pending[priv->first];
+  priv->first = (priv->first + 1) % priv->n_buffers;
+  priv->n_pending -= 1;
+
+  return buffer;
+}
+
+/* Функция проверяет, принадлежит ли буфер очереди. Список буферов не
+ * изменяется после создания очереди, поэтому блокировка не требуется. */
+static gboolean
+hyscan_buffer_queue_owns (HyScanBufferQueuePrivate *priv,
+                          HyScanBuffer             *buffer)
+{
+  guint i;
+
+  for (i = 0; i < priv->n_buffers; i++)
+    if (priv->buffers[i] == buffer)
+      return TRUE;
+
+  return FALSE;
+}
+
+/**
+ * hyscan_buffer_queue_new:
+ * @n_buffers: число буферов
+ * @size: размер памяти каждого буфера
+ * @policy: политика при отсутствии свободных буферов
+ *
+ * Функция создаёт новый объект #HyScanBufferQueue. Для каждого буфера
+ * заранее выделяется память размером @size байт. Число буферов ограничивает
+ * суммарное число данных в очереди и буферов, используемых производителями
+ * и потребителями.
+ *
+ * Returns: #HyScanBufferQueue. Для удаления #g_object_unref.
+ */
+HyScanBufferQueue *
+hyscan_buffer_queue_new (guint                   n_buffers,
+                         guint32                 size,
+                         HyScanBufferQueuePolicy policy)
+{
+  HyScanBufferQueue *queue;
+  HyScanBufferQueuePrivate *priv;
+  guint i;
+
+  g_return_val_if_fail (n_buffers > 0, NULL);
+  g_return_val_if_fail ((policy == HYSCAN_BUFFER_QUEUE_BLOCK) ||
+                        (policy == HYSCAN_BUFFER_QUEUE_DROP_OLDEST) ||
+                        (policy == HYSCAN_BUFFER_QUEUE_DROP_NEWEST), NULL);
+
+  queue = g_object_new (HYSCAN_TYPE_BUFFER_QUEUE, NULL);
+  priv = queue->priv;
+
+  priv->policy = policy;
+  priv->n_buffers = n_buffers;
+  priv->buffers = g_new (HyScanBuffer *, n_buffers);
+  priv->free = g_new (HyScanBuffer *, n_buffers);
+  priv->pending = g_new (HyScanBuffer *, n_buffers);
+
+  for (i = 0; i < n_buffers; i++)
+    {
+      priv->buffers[i] = hyscan_buffer_new ();
+      hyscan_buffer_reserve (priv->buffers[i], size);
+      priv->free[i] = priv->buffers[i];
+    }
+
+  priv->n_free = n_buffers;
+
+  return queue;
+}
+
+/**
+ * hyscan_buffer_queue_get_policy:
+ * @queue: указатель на #HyScanBufferQueue
+ *
+ * Функция возвращает политику поведения очереди при отсутствии свободных
+ * буферов.
+ *
+ * Returns: Политика при отсутствии свободных буферов.
+ */
+HyScanBufferQueuePolicy
+hyscan_buffer_queue_get_policy (HyScanBufferQueue *queue)
+{
+  g_return_val_if_fail (HYSCAN_IS_BUFFER_QUEUE (queue), HYSCAN_BUFFER_QUEUE_BLOCK);
+
+  return queue->priv->policy;
+}
+
+/**
+ * hyscan_buffer_queue_get_n_buffers:
+ * @queue: указатель на #HyScanBufferQueue
+ *
+ * Функция возвращает число буферов с данными в очереди. Значение может
+ * устареть к моменту использования.
+ *
+ * Returns: Число буферов с данными.
+ */
+guint
+hyscan_buffer_queue_get_n_buffers (HyScanBufferQueue *queue)
+{
+  HyScanBufferQueuePrivate *priv;
+  guint n_pending;
+
+  g_return_val_if_fail (HYSCAN_IS_BUFFER_QUEUE (queue), 0);
+
+  priv = queue->priv;
+
+  g_mutex_lock (&priv->lock);
+  n_pending = priv->n_pending;
+  g_mutex_unlock (&priv->lock);
+
+  return n_pending;
+}
+
+/**
+ * hyscan_buffer_queue_acquire:
+ * @queue: указатель на #HyScanBufferQueue
+ *
+ * Функция возвращает свободный буфер для записи данных. Если свободных
+ * буферов нет, поведение функции определяется политикой очереди. Полученный
+ * буфер необходимо вернуть в очередь функцией #hyscan_buffer_queue_push или
+ * #hyscan_buffer_queue_release. Тип и содержимое данных в буфере не
+ * определены.
+ *
+ * Returns: (transfer none) (nullable): #HyScanBuffer или NULL, если
+ *          буфер не может быть получен или очередь закрыта.
+ */
+HyScanBuffer *
+hyscan_buffer_queue_acquire (HyScanBufferQueue *queue)
+{
+  HyScanBufferQueuePrivate *priv;
+  HyScanBuffer *buffer = NULL;
+
+  g_return_val_if_fail (HYSCAN_IS_BUFFER_QUEUE (queue), NULL);
+
+  priv = queue->priv;
+
+  g_mutex_lock (&priv->lock);
+
+  if (priv->policy == HYSCAN_BUFFER_QUEUE_BLOCK)
+    {
+      while ((priv->n_free == 0) && !priv->closed)
+        g_cond_wait (&priv->free_cond, &priv->lock);
+    }
+
+  if (priv->closed)
+    goto exit;
+
+  if (priv->n_free > 0)
+    {
+      buffer = priv->free[--priv->n_free];
+    }
+  else if (priv->policy == HYSCAN_BUFFER_QUEUE_DROP_OLDEST)
+    {
+      buffer = hyscan_buffer_queue_take (priv);
+      if (buffer != NULL)
+        priv->dropped += 1;
+    }
+  else
+    {
+      priv->dropped += 1;
+    }
+
+exit:
+  g_mutex_unlock (&priv->lock);
+
+  return buffer;
+}
+
+/**
+ * hyscan_buffer_queue_push:
+ * @queue: указатель на #HyScanBufferQueue
+ * @buffer: буфер, полученный функцией #hyscan_buffer_queue_acquire
+ *
+ * Функция помещает буфер с данными в очередь. Если очередь закрыта, буфер
+ * возвращается в список свободных.
+ *
+ * Returns: %TRUE если буфер помещён в очередь, иначе %FALSE.
+ */
+gboolean
+hyscan_buffer_queue_push (HyScanBufferQueue *queue,
+                          HyScanBuffer      *buffer)
+{
+  HyScanBufferQueuePrivate *priv;
+  gboolean status = FALSE;
+
+  g_return_val_if_fail (HYSCAN_IS_BUFFER_QUEUE (queue), FALSE);
+  g_return_val_if_fail (HYSCAN_IS_BUFFER (buffer), FALSE);
+  g_return_val_if_fail (hyscan_buffer_queue_owns (queue->priv, buffer), FALSE);
+
+  priv = queue->priv;
+
+  g_mutex_lock (&priv->lock);
+
+  /* Свободных буферов и буферов с данными не может быть больше общего
+   * числа буферов, поэтому место в кольце есть всегда. */
+  if (!priv->closed && (priv->n_free + priv->n_pending < priv->n_buffers))
+    {
+      priv->pending[(priv->first + priv->n_pending) % priv->n_buffers] = buffer;
+      priv->n_pending += 1;
+      priv->pushed += 1;
+      status = TRUE;
+
+      g_cond_signal (&priv->data_cond);
+    }
+  else if (priv->n_free < priv->n_buffers)
+    {
+      priv->free[priv->n_free++] = buffer;
+    }
+
+  g_mutex_unlock (&priv->lock);
+
+  return status;
+}
+
+/**
+ * hyscan_buffer_queue_pop:
+ * @queue: указатель на #HyScanBufferQueue
+ *
+ * Функция извлекает самый старый буфер из очереди. Если очередь пуста,
+ * функция ожидает появления данных или закрытия очереди. После обработки
+ * данных буфер необходимо вернуть функцией #hyscan_buffer_queue_release.
+ *
+ * Returns: (transfer none) (nullable): #HyScanBuffer или NULL, если
+ *          очередь закрыта и пуста.
+ */
+HyScanBuffer *
+hyscan_buffer_queue_pop (HyScanBufferQueue *queue)
+{
+  HyScanBufferQueuePrivate *priv;
+  HyScanBuffer *buffer;
+
+  g_return_val_if_fail (HYSCAN_IS_BUFFER_QUEUE (queue), NULL);
+
+  priv = queue->priv;
+
+  g_mutex_lock (&priv->lock);
+
+  while ((priv->n_pending == 0) && !priv->closed)
+    g_cond_wait (&priv->data_cond, &priv->lock);
+
+  buffer = hyscan_buffer_queue_take (priv);
+
+  g_mutex_unlock (&priv->lock);
+
+  return buffer;
+}
+
+/**
+ * hyscan_buffer_queue_try_pop:
+ * @queue: указатель на #HyScanBufferQueue
+ *
+ * Функция извлекает самый старый буфер из очереди без ожидания данных.
+ * После обработки данных буфер необходимо вернуть функцией
+ * #hyscan_buffer_queue_release.
+ *
+ * Returns: (transfer none) (nullable): #HyScanBuffer или NULL, если
+ *          очередь пуста.
+ */
+HyScanBuffer *
+hyscan_buffer_queue_try_pop (HyScanBufferQueue *queue)
+{
+  HyScanBufferQueuePrivate *priv;
+  HyScanBuffer *buffer;
+
+  g_return_val_if_fail (HYSCAN_IS_BUFFER_QUEUE (queue), NULL);
+
+  priv = queue->priv;
+
+  g_mutex_lock (&priv->lock);
+  buffer = hyscan_buffer_queue_take (priv);
+  g_mutex_unlock (&priv->lock);
+
+  return buffer;
+}
+
+/**
+ * hyscan_buffer_queue_release:
+ * @queue: указатель на #HyScanBufferQueue
+ * @buffer: буфер, полученный из очереди
+ *
+ * Функция возвращает буфер в список свободных. Функция может использоваться
+ * как потребителем, после обработки данных, так и производителем, отказавшимся
+ * от передачи данных.
+ */
+void
+hyscan_buffer_queue_release (HyScanBufferQueue *queue,
+                             HyScanBuffer      *buffer)
+{
+  HyScanBufferQueuePrivate *priv;
+
+  g_return_if_fail (HYSCAN_IS_BUFFER_QUEUE (queue));
+  g_return_if_fail (HYSCAN_IS_BUFFER (buffer));
+  g_return_if_fail (hyscan_buffer_queue_owns (queue->priv, buffer));
+
+  priv = queue->priv;
+
+  g_mutex_lock (&priv->lock);
+
+  if (priv->n_free + priv->n_pending < priv->n_buffers)
+    {
+      priv->free[priv->n_free++] = buffer;
+      g_cond_signal (&priv->free_cond);
+    }
+
+  g_mutex_unlock (&priv->lock);
+}
+
+/**
+ * hyscan_buffer_queue_close:
+ * @queue: указатель на #HyScanBufferQueue
+ *
+ * Функция закрывает очередь и прерывает ожидание во всех потоках.
+ */
+void
+hyscan_buffer_queue_close (HyScanBufferQueue *queue)
+{
+  HyScanBufferQueuePrivate *priv;
+
+  g_return_if_fail (HYSCAN_IS_BUFFER_QUEUE (queue));
+
+  priv = queue->priv;
+
+  g_mutex_lock (&priv->lock);
+  priv->closed = TRUE;
+  g_cond_broadcast (&priv->free_cond);
+  g_cond_broadcast (&priv->data_cond);
+  g_mutex_unlock (&priv->lock);
+}
+
+/**
+ * hyscan_buffer_queue_get_stats:
+ * @queue: указатель на #HyScanBufferQueue
+ * @pushed: (out) (optional): число помещённых в очередь буферов
+ * @dropped: (out) (optional): число потерянных буферов
+ *
+ * Функция возвращает статистику работы очереди. Потерянными считаются
+ * буферы, данные которых были удалены из очереди политикой
+ * #HYSCAN_BUFFER_QUEUE_DROP_OLDEST, и отказы в буфере при политике
+ * #HYSCAN_BUFFER_QUEUE_DROP_NEWEST.
+ */
+void
+hyscan_buffer_queue_get_stats (HyScanBufferQueue *queue,
+                               guint             *pushed,
+                               guint             *dropped)
+{
+  HyScanBufferQueuePrivate *priv;
+
+  g_return_if_fail (HYSCAN_IS_BUFFER_QUEUE (queue));
+
+  priv = queue->priv;
+
+  g_mutex_lock (&priv->lock);
+
+  if (pushed != NULL)
+    *pushed = priv->pushed;
+  if (dropped != NULL)
+    *dropped = priv->dropped;
+
+  g_mutex_unlock (&priv->lock);
+}
@@ -0,0 +1,121 @@
+/* hyscan-buffer-queue.h
+ *
+ * Copyright 2019 Screen LLC, Andrei Fadeev <andrei@webcontrol.ru>
+ *
+ * This file is part of HyScanTypes.
+ *
+ * HyScanTypes is dual-licensed: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * HyScanTypes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Alternatively, you can license this code under a commercial license.
+ * Contact the Screen LLC in this case - <info@screen-co.ru>.
+ */
+
+/* HyScanTypes имеет двойную лицензию.
+ *
+ * Во-первых, вы можете распространять HyScanTypes на условиях Стандартной
+ * Общественной Лицензии GNU версии 3, либо по любой более поздней версии
+ * лицензии (по вашему выбору). Полные положения лицензии GNU приведены в
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Во-вторых, этот программный код можно использовать по коммерческой
+ * лицензии. Для этого свяжитесь с ООО Экран - <info@screen-co.ru>.
+ */
+
+#ifndef __HYSCAN_BUFFER_QUEUE_H__
+#define __HYSCAN_BUFFER_QUEUE_H__
+
+#include <hyscan-buffer.h>
+
+G_BEGIN_DECLS
+
+/**
+ * HyScanBufferQueuePolicy:
+ * @HYSCAN_BUFFER_QUEUE_BLOCK: ожидание освобождения буфера
+ * @HYSCAN_BUFFER_QUEUE_DROP_OLDEST: удаление самых старых данных из очереди
+ * @HYSCAN_BUFFER_QUEUE_DROP_NEWEST: отказ в буфере для новых данных
+ *
+ * Политики поведения очереди при отсутствии свободных буферов.
+ */
+typedef enum
+{
+  HYSCAN_BUFFER_QUEUE_BLOCK,
+  HYSCAN_BUFFER_QUEUE_DROP_OLDEST,
+  HYSCAN_BUFFER_QUEUE_DROP_NEWEST
+} HyScanBufferQueuePolicy;
+
+#define HYSCAN_TYPE_BUFFER_QUEUE             (hyscan_buffer_queue_get_type ())
+#define HYSCAN_BUFFER_QUEUE(obj)             (G_TYPE_CHECK_INSTANCE_CAST ((obj), HYSCAN_TYPE_BUFFER_QUEUE, HyScanBufferQueue))
+#define HYSCAN_IS_BUFFER_QUEUE(obj)          (G_TYPE_CHECK_INSTANCE_TYPE ((obj), HYSCAN_TYPE_BUFFER_QUEUE))
+#define HYSCAN_BUFFER_QUEUE_CLASS(klass)     (G_TYPE_CHECK_CLASS_CAST ((klass), HYSCAN_TYPE_BUFFER_QUEUE, HyScanBufferQueueClass))
+#define HYSCAN_IS_BUFFER_QUEUE_CLASS(klass)  (G_TYPE_CHECK_CLASS_TYPE ((klass), HYSCAN_TYPE_BUFFER_QUEUE))
+#define HYSCAN_BUFFER_QUEUE_GET_CLASS(obj)   (G_TYPE_INSTANCE_GET_CLASS ((obj), HYSCAN_TYPE_BUFFER_QUEUE, HyScanBufferQueueClass))
+
+typedef struct _HyScanBufferQueue HyScanBufferQueue;
+typedef struct _HyScanBufferQueuePrivate HyScanBufferQueuePrivate;
+typedef struct _HyScanBufferQueueClass HyScanBufferQueueClass;
+
+struct _HyScanBufferQueue
+{
+  GObject parent_instance;
+
+  HyScanBufferQueuePrivate *priv;
+};
+
+struct _HyScanBufferQueueClass
+{
+  GObjectClass parent_class;
+};
+
+HYSCAN_API
+GType                  hyscan_buffer_queue_get_type      (void);
+
+HYSCAN_API
+HyScanBufferQueue *    hyscan_buffer_queue_new           (guint                    n_buffers,
+                                                          guint32                  size,
+                                                          HyScanBufferQueuePolicy  policy);
+
+HYSCAN_API
+HyScanBufferQueuePolicy hyscan_buffer_queue_get_policy   (HyScanBufferQueue       *queue);
+
+HYSCAN_API
+guint                  hyscan_buffer_queue_get_n_buffers (HyScanBufferQueue       *queue);
+
+HYSCAN_API
+HyScanBuffer *         hyscan_buffer_queue_acquire       (HyScanBufferQueue       *queue);
+
+HYSCAN_API
+gboolean               hyscan_buffer_queue_push          (HyScanBufferQueue       *queue,
+                                                          HyScanBuffer            *buffer);
+
+HYSCAN_API
+HyScanBuffer *         hyscan_buffer_queue_pop           (HyScanBufferQueue       *queue);
+
+HYSCAN_API
+HyScanBuffer *         hyscan_buffer_queue_try_pop       (HyScanBufferQueue       *queue);
+
+HYSCAN_API
+void                   hyscan_buffer_queue_release       (HyScanBufferQueue       *queue,
+                                                          HyScanBuffer            *buffer);
+
+HYSCAN_API
+void                   hyscan_buffer_queue_close         (HyScanBufferQueue       *queue);
+
+HYSCAN_API
+void                   hyscan_buffer_queue_get_stats     (HyScanBufferQueue       *queue,
+                                                          guint                   *pushed,
+                                                          guint                   *dropped);
+
+G_END_DECLS
+
+#endif /* __HYSCAN_BUFFER_QUEUE_H__ */
@@ -0,0 +1,303 @@
+/* hyscan-buffer-ring.c
+ *
+ * Copyright 2019 Screen LLC, Andrei Fadeev <andrei@webcontrol.ru>
+ *
+ * This file is part of HyScanTypes.
+ *
+ * HyScanTypes is dual-licensed: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * HyScanTypes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Alternatively, you can license this code under a commercial license.
+ * Contact the Screen LLC in this case - <info@screen-co.ru>.
+ */
+
+/* HyScanTypes имеет двойную лицензию.
+ *
+ * Во-первых, вы можете распространять HyScanTypes на условиях Стандартной
+ * Общественной Лицензии GNU версии 3, либо по любой более поздней версии
+ * лицензии (по вашему выбору). Полные положения лицензии GNU приведены в
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Во-вторых, этот программный код можно использовать по коммерческой
+ * лицензии. Для этого свяжитесь с ООО Экран - <info@screen-co.ru>.
+ */
+
+/**
+ * SECTION: hyscan-buffer-ring
+ * @Short_description: кольцевой буфер для передачи данных между потоками
+ * @Title: HyScanBufferRing
+ *
+ * Класс предназначен для передачи данных от одного потока-производителя
+ * одному потоку-потребителю. Кольцо содержит фиксированное число заранее
+ * созданных объектов #HyScanBuffer, поэтому передача данных не требует
+ * выделения памяти. Синхронизация потоков выполняется только атомарными
+ * операциями, без блокировок.
+ *
+ * Создание объекта класса осуществляется функцией #hyscan_buffer_ring_new.
+ * Число буферов в кольце округляется вверх до степени двойки.
+ *
+ * Производитель получает свободный буфер функцией #hyscan_buffer_ring_acquire,
+ * записывает в него данные и передаёт потребителю функцией
+ * #hyscan_buffer_ring_commit. Потребитель получает самый старый из переданных
+ * буферов функцией #hyscan_buffer_ring_peek и, после обработки данных,
+ * возвращает его производителю функцией #hyscan_buffer_ring_release. Если
+ * свободных или переданных буферов нет, функции #hyscan_buffer_ring_acquire
+ * и #hyscan_buffer_ring_peek возвращают NULL.
+ *
+ * Функции производителя и потребителя могут вызываться одновременно, но
+ * каждая группа функций должна вызываться только из одного потока.
+ * Буферы принадлежат кольцу, ссылки на них не передаются.
+ */
+
+#include "hyscan-buffer-ring.h"
+
+/* Размер строки кэша. Индексы производителя и потребителя размещаются в
+ * разных строках, чтобы потоки не конкурировали за одну строку кэша. */
+#define HYSCAN_BUFFER_RING_CACHE_LINE  64
+
+struct _HyScanBufferRingPrivate
+{
+  HyScanBuffer               **buffers;        /* Буферы кольца. */
+  guint                        mask;           /* Маска индекса буфера. */
+
+  guint8                       pad0[HYSCAN_BUFFER_RING_CACHE_LINE];
+
+  gint                         head;           /* Число переданных буферов. */
+  guint                        cached_tail;    /* Копия tail у производителя. */
+
+  guint8                       pad1[HYSCAN_BUFFER_RING_CACHE_LINE];
+
+  gint                         tail;           /* Число возвращённых буферов. */
+  guint                        cached_head;    /* Копия head у потребителя. */
+
+  guint8                       pad2[HYSCAN_BUFFER_RING_CACHE_LINE];
+};
+
+static void                    hyscan_buffer_ring_object_finalize      (GObject       *object);
+
+G_DEFINE_TYPE_WITH_PRIVATE (HyScanBufferRing, hyscan_buffer_ring, G_TYPE_OBJECT)
+
+static void
+hyscan_buffer_ring_class_init (HyScanBufferRingClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->finalize = hyscan_buffer_ring_object_finalize;
+}
+
+static void
+hyscan_buffer_ring_init (HyScanBufferRing *ring)
+{
+  ring->priv = hyscan_buffer_ring_get_instance_private (ring);
+}
+
+static void
+hyscan_buffer_ring_object_finalize (GObject *object)
+{
+  HyScanBufferRing *ring = HYSCAN_BUFFER_RING (object);
+  HyScanBufferRingPrivate *priv = ring->priv;
+  guint i;
+
+  for (i = 0; i <= priv->mask; i++)
+    g_object_unref (priv->buffers[i]);
+
+  g_free (priv->buffers);
+
+  G_OBJECT_CLASS (hyscan_buffer_ring_parent_class)->finalize (object);
+}
+
+/**
+ * hyscan_buffer_ring_new:
+ * @n_buffers: число буферов
+ * @size: размер памяти каждого буфера
+ *
+ * Функция создаёт новый объект #HyScanBufferRing. Для каждого буфера
+ * заранее выделяется память размером @size байт.
+ *
+ * Returns: #HyScanBufferRing. Для удаления #g_object_unref.
+ */
+HyScanBufferRing *
+hyscan_buffer_ring_new (guint   n_buffers,
+                        guint32 size)
+{
+  HyScanBufferRing *ring;
+  HyScanBufferRingPrivate *priv;
+  guint capacity;
+  guint i;
+
+  g_return_val_if_fail ((n_buffers > 0) && (n_buffers <= G_MAXINT / 2 + 1), NULL);
+
+  ring = g_object_new (HYSCAN_TYPE_BUFFER_RING, NULL);
+  priv = ring->priv;
+
+  capacity = 1u << g_bit_storage (n_buffers - 1);
+  priv->buffers = g_new (HyScanBuffer *, capacity);
+  priv->mask = capacity - 1;
+
+  for (i = 0; i < capacity; i++)
+    {
+      priv->buffers[i] = hyscan_buffer_new ();
+      hyscan_buffer_reserve (priv->buffers[i], size);
+    }
+
+  return ring;
+}
+
+/**
+ * hyscan_buffer_ring_get_capacity:
+ * @ring: указатель на #HyScanBufferRing
+ *
+ * Функция возвращает число буферов в кольце.
+ *
+ * Returns: Число буферов в кольце.
+ */
+guint
+hyscan_buffer_ring_get_capacity (HyScanBufferRing *ring)
+{
+  g_return_val_if_fail (HYSCAN_IS_BUFFER_RING (ring), 0);
+
+  return ring->priv->mask + 1;
+}
+
+/**
+ * hyscan_buffer_ring_get_n_buffers:
+ * @ring: указатель на #HyScanBufferRing
+ *
+ * Функция возвращает число буферов, переданных потребителю и ещё не
+ * возвращённых им. Значение может устареть к моменту использования.
+ *
+ * Returns: Число переданных буферов.
+ */
+guint
+hyscan_buffer_ring_get_n_buffers (HyScanBufferRing *ring)
+{
+  HyScanBufferRingPrivate *priv;
+
+  g_return_val_if_fail (HYSCAN_IS_BUFFER_RING (ring), 0);
+
+  priv = ring->priv;
+
+  return (guint)g_atomic_int_get (&priv->head) - (guint)g_atomic_int_get (&priv->tail);
+}
+
+/**
+ * hyscan_buffer_ring_acquire:
+ * @ring: указатель на #HyScanBufferRing
+ *
+ * Функция возвращает свободный буфер для записи данных. Функция вызывается
+ * только производителем. Повторный вызов до #hyscan_buffer_ring_commit
+ * возвращает тот же буфер.
+ *
+ * Returns: (transfer none) (nullable): #HyScanBuffer или NULL, если
+ *          свободных буферов нет.
+ */
+HyScanBuffer *
+hyscan_buffer_ring_acquire (HyScanBufferRing *ring)
+{
+  HyScanBufferRingPrivate *priv;
+  guint head;
+
+  g_return_val_if_fail (HYSCAN_IS_BUFFER_RING (ring), NULL);
+
+  priv = ring->priv;
+
+  /* Индекс head изменяется только производителем. */
+  head = (guint)priv->head;
+
+  /* Индекс tail потребителя считывается, только если по его сохранённому
+   * значению свободных буферов нет. */
+  if (head - priv->cached_tail > priv->mask)
+    {
+      priv->cached_tail = (guint)g_atomic_int_get (&priv->tail);
+      if (head - priv->cached_tail > priv->mask)
+        return NULL;
+    }
+
+  return priv->buffers[head & priv->mask];
+}
+
+/**
+ * hyscan_buffer_ring_commit:
+ * @ring: указатель на #HyScanBufferRing
+ *
+ * Функция передаёт потребителю буфер, полученный функцией
+ * #hyscan_buffer_ring_acquire. Функция вызывается только производителем.
+ */
+void
+hyscan_buffer_ring_commit (HyScanBufferRing *ring)
+{
+  HyScanBufferRingPrivate *priv;
+
+  g_return_if_fail (HYSCAN_IS_BUFFER_RING (ring));
+
+  priv = ring->priv;
+
+  g_return_if_fail ((guint)priv->head - priv->cached_tail <= priv->mask);
+
+  /* Атомарная запись публикует данные буфера для потребителя. */
+  g_atomic_int_set (&priv->head, (guint)priv->head + 1);
+}
+
+/**
+ * hyscan_buffer_ring_peek:
+ * @ring: указатель на #HyScanBufferRing
+ *
+ * Функция возвращает самый старый из переданных потребителю буферов, не
+ * удаляя его из очереди. Функция вызывается только потребителем.
+ *
+ * Returns: (transfer none) (nullable): #HyScanBuffer или NULL, если
+ *          переданных буферов нет.
+ */
+HyScanBuffer *
+hyscan_buffer_ring_peek (HyScanBufferRing *ring)
+{
+  HyScanBufferRingPrivate *priv;
+  guint tail;
+
+  g_return_val_if_fail (HYSCAN_IS_BUFFER_RING (ring), NULL);
+
+  priv = ring->priv;
+
+  /* Индекс tail изменяется только потребителем. */
+  tail = (guint)priv->tail;
+
+  if (tail == priv->cached_head)
+    {
+      priv->cached_head = (guint)g_atomic_int_get (&priv->head);
+      if (tail == priv->cached_head)
+        return NULL;
+    }
+
+  return priv->buffers[tail & priv->mask];
+}
+
+/**
+ * hyscan_buffer_ring_release:
+ * @ring: указатель на #HyScanBufferRing
+ *
+ * Функция возвращает производителю буфер, полученный функцией
+ * #hyscan_buffer_ring_peek. Функция вызывается только потребителем.
+ */
+void
+hyscan_buffer_ring_release (HyScanBufferRing *ring)
+{
+  HyScanBufferRingPrivate *priv;
+
+  g_return_if_fail (HYSCAN_IS_BUFFER_RING (ring));
+
+  priv = ring->priv;
+
+  g_return_if_fail ((guint)priv->tail != priv->cached_head);
+
+  g_atomic_int_set (&priv->tail, (guint)priv->tail + 1);
+}
@@ -0,0 +1,92 @@
+/* hyscan-buffer-ring.h
+ *
+ * Copyright 2019 Screen LLC, Andrei Fadeev <andrei@webcontrol.ru>
+ *
+ * This file is part of HyScanTypes.
+ *
+ * HyScanTypes is dual-licensed: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * HyScanTypes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Alternatively, you can license this code under a commercial license.
+ * Contact the Screen LLC in this case - <info@screen-co.ru>.
+ */
+
+/* HyScanTypes имеет двойную лицензию.
+ *
+ * Во-первых, вы можете распространять HyScanTypes на условиях Стандартной
+ * Общественной Лицензии GNU версии 3, либо по любой более поздней версии
+ * лицензии (по вашему выбору). Полные положения лицензии GNU приведены в
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Во-вторых, этот программный код можно использовать по коммерческой
+ * лицензии. Для этого свяжитесь с ООО Экран - <info@screen-co.ru>.
+ */
+
+#ifndef __HYSCAN_BUFFER_RING_H__
+#define __HYSCAN_BUFFER_RING_H__
+
+#include <hyscan-buffer.h>
+
+G_BEGIN_DECLS
+
+#define HYSCAN_TYPE_BUFFER_RING             (hyscan_buffer_ring_get_type ())
+#define HYSCAN_BUFFER_RING(obj)             (G_TYPE_CHECK_INSTANCE_CAST ((obj), HYSCAN_TYPE_BUFFER_RING, HyScanBufferRing))
+#define HYSCAN_IS_BUFFER_RING(obj)          (G_TYPE_CHECK_INSTANCE_TYPE ((obj), HYSCAN_TYPE_BUFFER_RING))
+#define HYSCAN_BUFFER_RING_CLASS(klass)     (G_TYPE_CHECK_CLASS_CAST ((klass), HYSCAN_TYPE_BUFFER_RING, HyScanBufferRingClass))
+#define HYSCAN_IS_BUFFER_RING_CLASS(klass)  (G_TYPE_CHECK_CLASS_TYPE ((klass), HYSCAN_TYPE_BUFFER_RING))
+#define HYSCAN_BUFFER_RING_GET_CLASS(obj)   (G_TYPE_INSTANCE_GET_CLASS ((obj), HYSCAN_TYPE_BUFFER_RING, HyScanBufferRingClass))
+
+typedef struct _HyScanBufferRing HyScanBufferRing;
+typedef struct _HyScanBufferRingPrivate HyScanBufferRingPrivate;
+typedef struct _HyScanBufferRingClass HyScanBufferRingClass;
+
+struct _HyScanBufferRing
+{
+  GObject parent_instance;
+
+  HyScanBufferRingPrivate *priv;
+};
+
+struct _HyScanBufferRingClass
+{
+  GObjectClass parent_class;
+};
+
+HYSCAN_API
+GType                  hyscan_buffer_ring_get_type      (void);
+
+HYSCAN_API
+HyScanBufferRing *     hyscan_buffer_ring_new           (guint                  n_buffers,
+                                                         guint32                size);
+
+HYSCAN_API
+guint                  hyscan_buffer_ring_get_capacity  (HyScanBufferRing      *ring);
+
+HYSCAN_API
+guint                  hyscan_buffer_ring_get_n_buffers (HyScanBufferRing      *ring);
+
+HYSCAN_API
+HyScanBuffer *         hyscan_buffer_ring_acquire       (HyScanBufferRing      *ring);
+
+HYSCAN_API
+void                   hyscan_buffer_ring_commit        (HyScanBufferRing      *ring);
+
+HYSCAN_API
+HyScanBuffer *         hyscan_buffer_ring_peek          (HyScanBufferRing      *ring);
+
+HYSCAN_API
+void                   hyscan_buffer_ring_release       (HyScanBufferRing      *ring);
+
+G_END_DECLS
+
+#endif /* __HYSCAN_BUFFER_RING_H__ */
@@ -32,6 +32,11 @@
  * лицензии. Для этого свяжитесь с ООО Экран - <info@screen-co.ru>.
  */
 
+/* Функция mremap доступна только в Linux. */
+#ifdef __linux__
+#define _GNU_SOURCE
+#endif
+
 /**
  * SECTION: hyscan-buffer
  * @Short_description: буфер данных
@@ -48,15 +53,66 @@
  *
  * Для импорта данных используется функция #hyscan_buffer_import, для
  * экспорта #hyscan_buffer_export. Функция #hyscan_buffer_copy копирует
- * данные без преобразования.
+ * данные без преобразования. Большие объёмы данных можно преобразовывать
+ * в нескольких потоках функциями #hyscan_buffer_import_parallel и
+ * #hyscan_buffer_export_parallel. Данные, не требующие преобразования,
+ * можно импортировать без копирования функцией #hyscan_buffer_import_view.
+ * Функция #hyscan_buffer_import_batch импортирует несколько строк данных в
+ * одну матрицу. Функции #hyscan_buffer_import_complex_planar и
+ * #hyscan_buffer_import_doa_planar импортируют комплексные и
+ * пространственные данные в отдельные массивы gfloat для каждой компоненты
+ * точки, удобные для векторной обработки.
+ *
+ * Преобразование данных выполняется векторными функциями SSE2, AVX2 или NEON.
+ * Для данных в формате float16 используется аппаратное преобразование F16C
+ * (x86) или NEON (AArch64), таблицы преобразования используются только при
+ * его отсутствии. Набор инструкций выбирается один раз, в зависимости от
+ * возможностей процессора. Результат векторных функций побитно совпадает с результатом
+ * скалярных. Изменить набор инструкций можно функцией #hyscan_buffer_set_simd,
+ * узнать текущий - #hyscan_buffer_get_simd.
  *
  * Записать данные в буфер можно с помощью функции #hyscan_buffer_set. Кроме
  * этого, #HyScanBuffer может являться обёрткой над любым другим блоком данных,
  * для этого используется функция #hyscan_buffer_wrap. При этом данные не
  * копируются в буфер, а используется уже выделенный блок памяти.
  *
+ * Функция #hyscan_buffer_wrap_segments конфигурирует буфер как обёртку над
+ * списком блоков данных, например фрагментов сетевого пакета, которые
+ * вместе образуют непрерывные данные. Сегменты добавляются функцией
+ * #hyscan_buffer_append_segment. Функции импорта #hyscan_buffer_import и
+ * экспорта #hyscan_buffer_export обрабатывают сегменты непосредственно, без
+ * сборки данных в один блок, в том числе точки, разделённые границей
+ * сегментов. Остальные функции, которым требуется непрерывный доступ к
+ * данным, например #hyscan_buffer_get и #hyscan_buffer_peek, предварительно
+ * собирают сегменты в память буфера.
+ *
+ * Функция #hyscan_buffer_map_file конфигурирует буфер как обёртку над
+ * областью файла, отображённой в память. Это позволяет импортировать данные
+ * из файла без промежуточного копирования.
+ *
  * Получить доступ к данным можно с помощью функции #hyscan_buffer_get.
  * Пользователь может изменять данные в буфере в пределах установленного размера.
+ * Функция #hyscan_buffer_peek предоставляет доступ к данным только для чтения.
+ *
+ * Копии буфера, созданные функцией #hyscan_buffer_copy, используют память
+ * совместно, до первого изменения данных в одном из них.
+ *
+ * При увеличении размера данных память выделяется в соответствии с
+ * политикой #HyScanBufferGrowth, задаваемой функцией
+ * #hyscan_buffer_set_growth. Заранее выделить память можно функцией
+ * #hyscan_buffer_reserve, освободить неиспользуемую - функцией
+ * #hyscan_buffer_shrink_to_fit. Число выделений памяти можно узнать функцией
+ * #hyscan_buffer_get_n_allocations.
+ *
+ * Память для данных большого размера выделяется с помощью mmap, с
+ * рекомендацией использовать большие страницы (Transparent Huge Pages).
+ * Увеличение такой памяти в Linux выполняется функцией mremap без
+ * копирования данных. Порог размера задаётся функцией
+ * #hyscan_buffer_set_mmap_threshold.
+ *
+ * Память для данных выделяется с выравниванием по границе
+ * #HYSCAN_BUFFER_ALIGNMENT байт, которое сохраняется при увеличении размера.
+ * Выравнивание данных можно узнать функцией #hyscan_buffer_get_alignment.
  *
  * Для установки/получения типа данных и их размер можно использовать функции
  * #hyscan_buffer_set_data_type, #hyscan_buffer_get_data_type,
@@ -69,57 +125,90 @@
  * #hyscan_buffer_get_complex_float, #hyscan_buffer_set_doa,
  * #hyscan_buffer_wrap_doa и #hyscan_buffer_get_doa. Они работают аналогично
  * функциям #hyscan_buffer_wrap, #hyscan_buffer_set и #hyscan_buffer_get,
- * но обеспечивают приведение типов данных.
+ * но обеспечивают приведение типов данных. Функции
+ * #hyscan_buffer_get_complex_planar и #hyscan_buffer_get_doa_planar
+ * раскладывают компоненты точек по отдельным буферам.
  */
 
-#include "hyscan-buffer.h"
+#include "hyscan-buffer-internal.h"
 #include <string.h>
+#include <stdlib.h>
 
-union float32int
+#ifdef G_OS_WIN32
+#include <malloc.h>
+#endif
+
+#ifdef G_OS_UNIX
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define HYSCAN_BUFFER_MMAP
+#endif
+
+/* Гранулярность размера памяти, отображаемой mmap, соответствует размеру
+ * большой страницы (Transparent Huge Pages). */
+#define HYSCAN_BUFFER_MMAP_PAGE_SIZE   (2 * 1024 * 1024)
+
+/* Размер данных, начиная с которого используется mmap. */
+#define HYSCAN_BUFFER_MMAP_THRESHOLD   (64 * 1024 * 1024)
+
+/* Число точек, преобразуемых за один раз при импорте в матрицу по столбцам. */
+#define HYSCAN_BUFFER_BATCH_TILE       256
+
+/* Память, совместно используемая копиями буфера. */
+typedef struct
 {
-  gfloat                       value;          /* Значение числа. */
-  guint32                      code;           /* 32-х битное представление. */
-};
+  gint                         ref_count;      /* Число ссылок. */
+  gpointer                     data;           /* Данные. */
+  gsize                        mapped_size;    /* Размер отображённой памяти или 0. */
+} HyScanBufferStorage;
+
+#ifdef HYSCAN_BUFFER_MMAP
+/* Отображённая область файла, совместно используемая буфером и его
+ * представлениями. */
+typedef struct
+{
+  gint                         ref_count;      /* Число ссылок. */
+  gpointer                     data;           /* Отображённая область. */
+  gsize                        size;           /* Размер отображённой области. */
+} HyScanBufferFile;
+#endif
 
 struct _HyScanBufferPrivate
 {
   gboolean                     self_allocated; /* Признак выделения памяти. */
+  gboolean                     view;           /* Признак представления данных другого буфера. */
+  HyScanBufferStorage         *storage;        /* Память буфера. */
   guint32                      allocated_size; /* Размер буфера. */
+  HyScanBufferGrowth           growth;         /* Политика увеличения памяти. */
+  guint                        n_allocations;  /* Число выделений памяти. */
   HyScanDataType               type;           /* Тип данных. */
   gpointer                     data;           /* Данные. */
   guint32                      size;           /* Размер данных. */
+
+  gboolean                     segmented;      /* Признак обёртки над сегментами. */
+  HyScanBufferSegment         *segments;       /* Сегменты данных. */
+  guint                        n_segments;     /* Число сегментов. */
+  guint                        max_segments;   /* Размер массива сегментов. */
+
+#ifdef HYSCAN_BUFFER_MMAP
+  HyScanBufferFile            *file;           /* Отображённая область файла. */
+#else
+  GMappedFile                 *file;           /* Отображённый файл. */
+#endif
 };
 
 static void                    hyscan_buffer_object_finalize   (GObject       *object);
+static void                    hyscan_buffer_storage_free      (HyScanBufferStorage *storage);
+static void                    hyscan_buffer_unmap_file        (HyScanBufferPrivate *priv);
+static void                    hyscan_buffer_storage_unref     (HyScanBufferStorage *storage);
+static void                    hyscan_buffer_gather            (HyScanBufferPrivate *priv);
+static gboolean                hyscan_buffer_prepare           (HyScanBufferPrivate *priv,
+                                                                guint32        size,
+                                                                gboolean       keep);
 
-static void                    hyscan_buffer_setup_table16     (void);
-
-static inline gfloat           hyscan_buffer_decode_adc_14le   (guint16        code);
-static inline gfloat           hyscan_buffer_decode_adc_16le   (guint16        code);
-static inline gfloat           hyscan_buffer_decode_adc_24le   (guint32        code);
-static inline gfloat           hyscan_buffer_decode_int8       (guint8         code);
-static inline gfloat           hyscan_buffer_decode_int16le    (guint16        code);
-static inline gfloat           hyscan_buffer_decode_int24le    (guint32        code);
-static inline gfloat           hyscan_buffer_decode_int32le    (guint32        code);
-static inline gfloat           hyscan_buffer_decode_float16le  (guint16        code);
-static inline gfloat           hyscan_buffer_decode_float32le  (guint32        code);
-
-static inline guint16          hyscan_buffer_encode_adc_14le   (gfloat         value);
-static inline guint16          hyscan_buffer_encode_adc_16le   (gfloat         value);
-static inline guint32          hyscan_buffer_encode_adc_24le   (gfloat         value);
-static inline guint8           hyscan_buffer_encode_int8       (gfloat         value);
-static inline guint16          hyscan_buffer_encode_int16le    (gfloat         value);
-static inline guint32          hyscan_buffer_encode_int24le    (gfloat         value);
-static inline guint32          hyscan_buffer_encode_int32le    (gfloat         value);
-static inline guint16          hyscan_buffer_encode_float16le  (gfloat         value);
-static inline guint32          hyscan_buffer_encode_float32le  (gfloat         value);
-
-static guint32                 hyscan_buffer_mantissa16[2048];
-static guint32                 hyscan_buffer_exponent16[64];
-static guint32                 hyscan_buffer_offset16[64];
-
-static guint16                 hyscan_buffer_shift16[512];
-static guint16                 hyscan_buffer_base16[1924];
+static guint32 hyscan_buffer_mmap_threshold = HYSCAN_BUFFER_MMAP_THRESHOLD;
 
 G_DEFINE_TYPE_WITH_PRIVATE (HyScanBuffer, hyscan_buffer, G_TYPE_OBJECT)
 
@@ -129,8 +218,6 @@ hyscan_buffer_class_init (HyScanBufferClass *klass)
   GObjectClass *object_class = G_OBJECT_CLASS (klass);
 
   object_class->finalize = hyscan_buffer_object_finalize;
-
-  hyscan_buffer_setup_table16();
 }
 
 static void
@@ -147,266 +234,587 @@ hyscan_buffer_object_finalize (GObject *object)
   HyScanBuffer *buffer = HYSCAN_BUFFER (object);
   HyScanBufferPrivate *priv = buffer->priv;
 
-  if (priv->self_allocated)
-    g_free (priv->data);
+  hyscan_buffer_storage_unref (priv->storage);
+  hyscan_buffer_unmap_file (priv);
+  g_free (priv->segments);
 
   G_OBJECT_CLASS (hyscan_buffer_parent_class)->finalize (object);
 }
 
-/* Функция вычисляет таблицы для преобразования float32 <-> float16. Сам
- * алгоритм преобразования описан в статье "Fast Half Float Conversions"
- * за авторством Jeroen van der Zijp. */
-static void
-hyscan_buffer_setup_table16 (void)
+/* Функция выделяет память, выровненную по границе HYSCAN_BUFFER_ALIGNMENT. */
+static gpointer
+hyscan_buffer_aligned_alloc (gsize size)
 {
-  guint i;
+  gpointer data;
 
-  /* Таблицы преобразования float16 -> float32. */
-  hyscan_buffer_mantissa16[0] = 0;
+  if (size == 0)
+    return NULL;
 
-  for (i = 1; i <= 1023; i++)
-    {
-      guint m = i << 13;
-      guint e=0;
-      while (!(m & 0x00800000))
-        {
-          e-=0x00800000;
-          m <<= 1;
-        }
-      m &= ~0x00800000;
-      e += 0x38800000;
-      hyscan_buffer_mantissa16[i] = m | e;
-    }
+#ifdef G_OS_WIN32
+  data = _aligned_malloc (size, HYSCAN_BUFFER_ALIGNMENT);
+#else
+  if (posix_memalign (&data, HYSCAN_BUFFER_ALIGNMENT, size) != 0)
+    data = NULL;
+#endif
 
-  for (i = 1024; i <= 2047; i++)
-    hyscan_buffer_mantissa16[i] = 0x38000000 + ((i - 1024) << 13);
+  if (data == NULL)
+    g_error ("%s: failed to allocate %" G_GSIZE_FORMAT " bytes", G_STRLOC, size);
 
-  hyscan_buffer_exponent16[0] = 0;
-  hyscan_buffer_exponent16[32] = 0x80000000;
+  return data;
+}
 
-  for (i = 1; i <= 30; i++)
-    hyscan_buffer_exponent16[i] = i << 23;
+/* Функция освобождает выровненную память. */
+static void
+hyscan_buffer_aligned_free (gpointer data)
+{
+#ifdef G_OS_WIN32
+  _aligned_free (data);
+#else
+  free (data);
+#endif
+}
 
-  for (i = 33; i <= 62; i++)
-    hyscan_buffer_exponent16[i] = 0x80000000 + ((i - 32) << 23);
+/* Функция проверяет, нужно ли использовать mmap для size байт данных. */
+static inline gboolean
+hyscan_buffer_use_mmap (guint32 size)
+{
+#ifdef HYSCAN_BUFFER_MMAP
+  guint32 threshold = (guint32)g_atomic_int_get (&hyscan_buffer_mmap_threshold);
 
-  hyscan_buffer_exponent16[31] = 0x47800000;
-  hyscan_buffer_exponent16[63] = 0xC7800000;
+  return (threshold > 0) && (size >= threshold);
+#else
+  return FALSE;
+#endif
+}
 
-  for (i = 0; i <= 63; i++)
-    hyscan_buffer_offset16[i] = 1024;
+#ifdef HYSCAN_BUFFER_MMAP
+/* Функция возвращает размер памяти, отображаемой для size байт данных. */
+static inline gsize
+hyscan_buffer_mmap_length (gsize size)
+{
+  return (size + HYSCAN_BUFFER_MMAP_PAGE_SIZE - 1) & ~((gsize)HYSCAN_BUFFER_MMAP_PAGE_SIZE - 1);
+}
 
-  hyscan_buffer_offset16[0] = 0;
-  hyscan_buffer_offset16[32] = 0;
+/* Функция отображает анонимную память размером length байт. */
+static gpointer
+hyscan_buffer_mmap_alloc (gsize length)
+{
+  gpointer data;
 
-  /* Таблицы преобразования float32 -> float16. */
-  for (i = 0; i < 256; i++)
-    {
-    gint e = i - 127;
-    if (e < -24)
-      {
-        hyscan_buffer_base16[i|0x000] = 0x0000;
-        hyscan_buffer_base16[i|0x100] = 0x8000;
-        hyscan_buffer_shift16[i|0x000] = 24;
-        hyscan_buffer_shift16[i|0x100] = 24;
-      }
-    else if (e < -14)
-      {
-        hyscan_buffer_base16[i|0x000] = (0x0400 >> (-e - 14));
-        hyscan_buffer_base16[i|0x100] = (0x0400 >> (-e - 14)) | 0x8000;
-        hyscan_buffer_shift16[i|0x000] = -e-1;
-        hyscan_buffer_shift16[i|0x100] = -e-1;
-    }
-    else if (e <= 15)
-      {
-        hyscan_buffer_base16[i|0x000] = ((e + 15) << 10);
-        hyscan_buffer_base16[i|0x100] = ((e + 15) << 10) | 0x8000;
-        hyscan_buffer_shift16[i|0x000] = 13;
-        hyscan_buffer_shift16[i|0x100] = 13;
-      }
-    else if(e < 128)
-      {
-        hyscan_buffer_base16[i|0x000] = 0x7C00;
-        hyscan_buffer_base16[i|0x100] = 0xFC00;
-        hyscan_buffer_shift16[i|0x000] = 24;
-        hyscan_buffer_shift16[i|0x100] = 24;
-      }
-    else
-      {
-        hyscan_buffer_base16[i|0x000] = 0x7C00;
-        hyscan_buffer_base16[i|0x100] = 0xFC00;
-        hyscan_buffer_shift16[i|0x000] = 13;
-        hyscan_buffer_shift16[i|0x100] = 13;
-      }
-    }
-}
+  data = mmap (NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (data == MAP_FAILED)
+    g_error ("%s: failed to map %" G_GSIZE_FORMAT " bytes", G_STRLOC, length);
 
-/* функции декодирования данных. */
+#ifdef MADV_HUGEPAGE
+  madvise (data, length, MADV_HUGEPAGE);
+#endif
 
-static inline gfloat
-hyscan_buffer_decode_adc_14le (guint16 code)
-{
-  static const gfloat scale = 2.0f / 16383.0f;
-  code = GUINT16_FROM_LE (code) & 0x3fff;
-  return scale * code - 1.0;
+  return data;
 }
+#endif
 
-static inline gfloat
-hyscan_buffer_decode_adc_16le (guint16 code)
+/* Функция выделяет память размером не менее size байт. Данные размером
+ * больше порога размещаются в памяти, отображаемой mmap. */
+static void
+hyscan_buffer_storage_alloc (HyScanBufferPrivate *priv,
+                             HyScanBufferStorage *storage,
+                             guint32              size)
 {
-  static const gfloat scale = 2.0f / 65535.0f;
-  code = GUINT16_FROM_LE (code);
-  return scale * code - 1.0;
+  priv->n_allocations += 1;
+
+#ifdef HYSCAN_BUFFER_MMAP
+  if (hyscan_buffer_use_mmap (size))
+    {
+      storage->mapped_size = hyscan_buffer_mmap_length (size);
+      storage->data = hyscan_buffer_mmap_alloc (storage->mapped_size);
+      priv->allocated_size = MIN (storage->mapped_size, G_MAXUINT32);
+
+      return;
+    }
+#endif
+
+  storage->mapped_size = 0;
+  storage->data = hyscan_buffer_aligned_alloc (size);
+  priv->allocated_size = size;
 }
 
-static inline gfloat
-hyscan_buffer_decode_adc_24le (guint32 code)
+/* Функция освобождает память с данными. */
+static void
+hyscan_buffer_storage_free (HyScanBufferStorage *storage)
 {
-  static const gfloat scale = 2.0f / 16777215.0f;
-  code = GUINT32_FROM_LE (code) & 0x00ffffff;
-  return scale * code - 1.0;
+#ifdef HYSCAN_BUFFER_MMAP
+  if (storage->mapped_size > 0)
+    {
+      munmap (storage->data, storage->mapped_size);
+      return;
+    }
+#endif
+
+  hyscan_buffer_aligned_free (storage->data);
 }
 
-static inline gfloat
-hyscan_buffer_decode_int8 (guint8 code)
+/* Функция изменяет размер памяти, сохраняя первые keep байт данных.
+ * Отображаемая память, по возможности, изменяется без копирования. */
+static void
+hyscan_buffer_storage_resize (HyScanBufferPrivate *priv,
+                              HyScanBufferStorage *storage,
+                              guint32              size,
+                              guint32              keep)
 {
-  static const gfloat scale = 1.0f / 255.0f;
-  return scale * code;
+  HyScanBufferStorage old = *storage;
+
+#if defined (HYSCAN_BUFFER_MMAP) && defined (MREMAP_MAYMOVE)
+  if ((storage->mapped_size > 0) && hyscan_buffer_use_mmap (size))
+    {
+      gsize length = hyscan_buffer_mmap_length (size);
+      gpointer data;
+
+      if (length != storage->mapped_size)
+        {
+          data = mremap (storage->data, storage->mapped_size, length, MREMAP_MAYMOVE);
+          if (data == MAP_FAILED)
+            g_error ("%s: failed to remap %" G_GSIZE_FORMAT " bytes", G_STRLOC, length);
+
+          priv->n_allocations += 1;
+          storage->data = data;
+          storage->mapped_size = length;
+        }
+
+      priv->allocated_size = MIN (length, G_MAXUINT32);
+
+      return;
+    }
+#endif
+
+  hyscan_buffer_storage_alloc (priv, storage, size);
+
+  if (keep > 0)
+    memcpy (storage->data, old.data, keep);
+
+  hyscan_buffer_storage_free (&old);
 }
 
-static inline gfloat
-hyscan_buffer_decode_int16le (guint16 code)
+/* Функция освобождает ссылку на отображённую в память область файла. */
+static void
+hyscan_buffer_unmap_file (HyScanBufferPrivate *priv)
 {
-  static const gfloat scale = 1.0f / 65536.0f;
-  code = GUINT16_FROM_LE (code);
-  return scale * code;
+#ifdef HYSCAN_BUFFER_MMAP
+  if ((priv->file != NULL) && g_atomic_int_dec_and_test (&priv->file->ref_count))
+    {
+      munmap (priv->file->data, priv->file->size);
+      g_slice_free (HyScanBufferFile, priv->file);
+    }
+
+  priv->file = NULL;
+#else
+  g_clear_pointer (&priv->file, g_mapped_file_unref);
+#endif
 }
 
-static inline gfloat
-hyscan_buffer_decode_int24le (guint32 code)
+/* Функция добавляет буферу ссылку на область файла, отображённую другим
+ * буфером. */
+static void
+hyscan_buffer_ref_file (HyScanBufferPrivate *priv,
+                        HyScanBufferPrivate *owner)
 {
-  static const gfloat scale = 1.0f / 16777215.0f;
-  code = GUINT32_FROM_LE (code) & 0x00ffffff;
-  return scale * code;
+  hyscan_buffer_unmap_file (priv);
+
+#ifdef HYSCAN_BUFFER_MMAP
+  if (owner->file != NULL)
+    g_atomic_int_inc (&owner->file->ref_count);
+
+  priv->file = owner->file;
+#else
+  priv->file = (owner->file != NULL) ? g_mapped_file_ref (owner->file) : NULL;
+#endif
 }
 
-static inline gfloat
-hyscan_buffer_decode_int32le (guint32 code)
+/* Функция освобождает ссылку на память буфера. */
+static void
+hyscan_buffer_storage_unref (HyScanBufferStorage *storage)
 {
-  static const gfloat scale = 1.0f / 4294967295.0f;
-  code = GUINT32_FROM_LE (code);
-  return scale * code;
+  if (storage == NULL)
+    return;
+
+  if (g_atomic_int_dec_and_test (&storage->ref_count))
+    {
+      hyscan_buffer_storage_free (storage);
+      g_slice_free (HyScanBufferStorage, storage);
+    }
 }
 
-static inline gfloat
-hyscan_buffer_decode_float16le (guint16 code)
+/* Функция возвращает размер памяти, выделяемой для size байт данных,
+ * в соответствии с политикой увеличения памяти. */
+static guint32
+hyscan_buffer_get_growth_size (HyScanBufferPrivate *priv,
+                               guint32              size)
 {
-  union float32int value;
+  guint64 new_size = size;
 
-  code = GUINT16_FROM_LE (code);
-  value.code  = hyscan_buffer_mantissa16[hyscan_buffer_offset16[code >> 10] + (code & 0x3ff)];
-  value.code += hyscan_buffer_exponent16[code>>10];
+  if (size <= priv->allocated_size)
+    return size;
 
-  return value.value;
+  switch (priv->growth)
+    {
+    case HYSCAN_BUFFER_GROWTH_GEOMETRIC:
+      new_size = MAX (new_size, (guint64)priv->allocated_size + priv->allocated_size / 2);
+      break;
+
+    case HYSCAN_BUFFER_GROWTH_POWER_OF_TWO:
+      if (size > 1)
+        new_size = G_GUINT64_CONSTANT (1) << g_bit_storage (size - 1);
+      break;
+
+    default:
+      break;
+    }
+
+  return MIN (new_size, G_MAXUINT32);
 }
 
-static inline gfloat
-hyscan_buffer_decode_float32le (guint32 code)
+/* Функция подготавливает память буфера к записи: выделяет не менее size байт
+ * и, если память используется совместно с копиями буфера, отделяет её. Если
+ * keep = TRUE, текущие данные сохраняются. В режиме обёртки над внешними
+ * данными память не выделяется, а при её нехватке функция возвращает FALSE. */
+static gboolean
+hyscan_buffer_prepare (HyScanBufferPrivate *priv,
+                       guint32              size,
+                       gboolean             keep)
 {
-  union float32int value;
+  HyScanBufferStorage *storage;
 
-  value.code = GUINT32_FROM_LE (code);
+  /* Сегменты собираются в память буфера. */
+  if (priv->segmented)
+    hyscan_buffer_gather (priv);
 
-  return value.value;
-}
+  /* Представление данных другого буфера, создаём собственную копию. */
+  if (priv->view)
+    {
+      gconstpointer data = priv->data;
 
-/* Функции кодирования данных. */
+      priv->view = FALSE;
+      priv->self_allocated = TRUE;
+      priv->allocated_size = 0;
 
-static inline guint16
-hyscan_buffer_encode_adc_14le (gfloat value)
-{
-  guint16 code;
-  value = 8192.0 * (value + 1.0);
-  code = CLAMP (value, 0.0, 16383.0);
-  return GUINT16_TO_LE (code);
-}
+      hyscan_buffer_prepare (priv, MAX (size, keep ? priv->size : 0), FALSE);
+      if (keep && (priv->size > 0))
+        memcpy (priv->data, data, priv->size);
 
-static inline guint16
-hyscan_buffer_encode_adc_16le (gfloat value)
-{
-  guint16 code;
-  value = 32768.0 * (value + 1.0);
-  code = CLAMP (value, 0.0, 65535.0);
-  return GUINT16_TO_LE (code);
-}
+      hyscan_buffer_unmap_file (priv);
 
-static inline guint32
-hyscan_buffer_encode_adc_24le (gfloat value)
-{
-  guint32 code;
-  value = 8388608.0 * (value + 1.0);
-  code = CLAMP (value, 0.0, 16777215.0);
-  return GUINT32_TO_LE (code);
+      return TRUE;
+    }
+
+  storage = priv->storage;
+
+  if (!priv->self_allocated)
+    return (priv->allocated_size >= size);
+
+  /* Память используется совместно, создаём собственную копию. */
+  if ((storage != NULL) && (g_atomic_int_get (&storage->ref_count) > 1))
+    {
+      size = hyscan_buffer_get_growth_size (priv, MAX (size, keep ? priv->size : 0));
+
+      priv->storage = g_slice_new (HyScanBufferStorage);
+      priv->storage->ref_count = 1;
+      hyscan_buffer_storage_alloc (priv, priv->storage, size);
+
+      if (keep && (priv->size > 0))
+        memcpy (priv->storage->data, priv->data, priv->size);
+
+      priv->data = priv->storage->data;
+      hyscan_buffer_storage_unref (storage);
+
+      return TRUE;
+    }
+
+  if (storage == NULL)
+    {
+      storage = priv->storage = g_slice_new0 (HyScanBufferStorage);
+      storage->ref_count = 1;
+      priv->allocated_size = 0;
+    }
+
+  /* Новая память, с сохранением выравнивания. */
+  if (priv->allocated_size < size)
+    {
+      size = hyscan_buffer_get_growth_size (priv, size);
+      hyscan_buffer_storage_resize (priv, storage, size, keep ? priv->size : 0);
+    }
+
+  priv->data = storage->data;
+
+  return TRUE;
 }
 
-static inline guint8
-hyscan_buffer_encode_int8 (gfloat value)
+/* Функция собирает данные из сегментов в память буфера. */
+static void
+hyscan_buffer_gather (HyScanBufferPrivate *priv)
 {
-  guint8 code;
-  value = 256.0 * value;
-  code = CLAMP (value, 0.0, 255.0);
-  return code;
+  guint8 *data;
+  guint32 size;
+  guint i;
+
+  if (!priv->segmented)
+    return;
+
+  size = priv->size;
+
+  priv->segmented = FALSE;
+  priv->self_allocated = TRUE;
+  priv->allocated_size = 0;
+  priv->data = NULL;
+  priv->size = 0;
+
+  hyscan_buffer_prepare (priv, size, FALSE);
+  priv->size = size;
+
+  data = priv->data;
+  for (i = 0; (i < priv->n_segments) && (size > 0); i++)
+    {
+      guint32 n_bytes = MIN (priv->segments[i].size, size);
+
+      memcpy (data, priv->segments[i].data, n_bytes);
+      data += n_bytes;
+      size -= n_bytes;
+    }
+
+  priv->n_segments = 0;
 }
 
-static inline guint16
-hyscan_buffer_encode_int16le (gfloat value)
+/* Параметры импорта строк данных в матрицу. */
+typedef struct
+{
+  HyScanBuffer               **raws;           /* Строки данных. */
+  guint32                      n_points;       /* Число точек в строке матрицы. */
+  guint32                      stride;         /* Шаг матрицы в точках. */
+  guint                        n_values;       /* Число значений в точке. */
+  HyScanBufferLayout           layout;         /* Расположение строк. */
+  gfloat                      *matrix;         /* Матрица. */
+} HyScanBufferBatch;
+
+/* Функция импортирует одну строку данных в матрицу. */
+static void
+hyscan_buffer_batch_task (gpointer data,
+                          guint    index)
 {
-  guint16 code;
-  value = 65536.0 * value;
-  code = CLAMP (value, 0.0, 65535.0);
-  return GUINT16_TO_LE (code);
+  HyScanBufferBatch *batch = data;
+  HyScanBufferPrivate *raw = batch->raws[index]->priv;
+  const HyScanBufferFormat *format;
+  const guint8 *raw_data = raw->data;
+  guint32 point_size;
+  guint32 n_points;
+  guint n_values = batch->n_values;
+  guint32 i;
+
+  format = hyscan_buffer_internal_get_format (raw->type);
+  point_size = hyscan_data_get_point_size (raw->type);
+  n_points = MIN (raw->size / point_size, batch->n_points);
+
+  /* Строка матрицы, оставшиеся точки заполняются нулями. */
+  if (batch->layout == HYSCAN_BUFFER_LAYOUT_ROW_MAJOR)
+    {
+      gfloat *row = batch->matrix + (gsize)index * batch->stride * n_values;
+
+      hyscan_buffer_internal_decode (format, row, raw_data, n_points, 1);
+      memset (row + (gsize)n_points * n_values, 0,
+              (gsize)(batch->stride - n_points) * n_values * sizeof (gfloat));
+
+      return;
+    }
+
+  /* Столбец матрицы, точки преобразуются частями во временный массив. */
+  for (i = 0; i < batch->n_points; i += HYSCAN_BUFFER_BATCH_TILE)
+    {
+      gfloat tile[HYSCAN_BUFFER_BATCH_TILE * HYSCAN_BUFFER_MAX_POINT_SIZE / sizeof (gfloat)];
+      guint32 n_tile = MIN (HYSCAN_BUFFER_BATCH_TILE, batch->n_points - i);
+      guint32 n_decode = (i < n_points) ? MIN (n_tile, n_points - i) : 0;
+      guint32 j;
+
+      if (n_decode > 0)
+        hyscan_buffer_internal_decode (format, tile, raw_data + (gsize)i * point_size, n_decode, 1);
+
+      if (n_decode < n_tile)
+        memset (tile + (gsize)n_decode * n_values, 0, (gsize)(n_tile - n_decode) * n_values * sizeof (gfloat));
+
+      for (j = 0; j < n_tile; j++)
+        {
+          memcpy (batch->matrix + ((gsize)(i + j) * batch->stride + index) * n_values,
+                  tile + (gsize)j * n_values, n_values * sizeof (gfloat));
+        }
+    }
 }
 
-static inline guint32
-hyscan_buffer_encode_int24le (gfloat value)
+/* Функция импортирует данные из буфера raw, раскладывая значения точек по
+ * отдельным буферам planes типа HYSCAN_DATA_FLOAT. */
+static gboolean
+hyscan_buffer_import_planar (HyScanBuffer   *raw,
+                             HyScanDataType  float_type,
+                             HyScanBuffer  **planes,
+                             guint           n_planes)
 {
-  guint32 code;
-  value = 16777215.0 * value;
-  code = CLAMP (value, 0.0, 16777215.0);
-  return GUINT32_TO_LE (code);
+  const HyScanBufferFormat *format;
+  gfloat *values[3];
+  HyScanDataType type;
+  gconstpointer data;
+  guint32 n_points;
+  guint32 size;
+  guint i, j;
+
+  g_return_val_if_fail (HYSCAN_IS_BUFFER (raw), FALSE);
+
+  for (i = 0; i < n_planes; i++)
+    {
+      g_return_val_if_fail (HYSCAN_IS_BUFFER (planes[i]), FALSE);
+
+      if (planes[i] == raw)
+        return FALSE;
+
+      for (j = 0; j < i; j++)
+        if (planes[i] == planes[j])
+          return FALSE;
+    }
+
+  /* Размер и тип импортируемых данных. */
+  data = hyscan_buffer_peek (raw, &type, &size);
+  format = hyscan_buffer_internal_get_format (type);
+  if ((format == NULL) || (format->float_type != float_type))
+    return FALSE;
+
+  n_points = size / hyscan_data_get_point_size (type);
+  for (i = 0; i < n_planes; i++)
+    {
+      hyscan_buffer_set (planes[i], HYSCAN_DATA_FLOAT, NULL, n_points * sizeof (gfloat));
+      values[i] = planes[i]->priv->data;
+    }
+
+  /* Импорт данных. */
+  hyscan_buffer_internal_decode_planar (format, values, data, n_points);
+
+  return TRUE;
 }
 
-static inline guint32
-hyscan_buffer_encode_int32le (gfloat value)
+/* Функция сбрасывает режим обёртки над сегментами. */
+static void
+hyscan_buffer_clear_segments (HyScanBufferPrivate *priv)
 {
-  guint32 code;
-  value = 4294967296.0 * value;
-  code = CLAMP (value, 0.0, 4294967295.0);
-  return GUINT32_TO_LE (code);
+  priv->segmented = FALSE;
+  priv->n_segments = 0;
 }
 
-static inline guint16
-hyscan_buffer_encode_float16le (gfloat value)
+/* Функция декодирует n_points точек данных из сегментов. Точки, разделённые
+ * границей сегментов, собираются во временном массиве. */
+static void
+hyscan_buffer_decode_segments (const HyScanBufferFormat *format,
+                               gfloat                   *values,
+                               HyScanBufferPrivate      *raw,
+                               guint32                   point_size,
+                               guint32                   n_points,
+                               guint                     n_threads)
 {
-  union float32int code32;
-  guint16 code16;
+  guint64 point[HYSCAN_BUFFER_MAX_POINT_SIZE / sizeof (guint64)];
+  guint32 filled = 0;
+  guint i;
 
-  code32.value = value;
+  for (i = 0; (i < raw->n_segments) && (n_points > 0); i++)
+    {
+      const guint8 *data = raw->segments[i].data;
+      guint32 left = raw->segments[i].size;
+      guint32 n;
+
+      /* Окончание точки, начатой в предыдущих сегментах. */
+      if (filled > 0)
+        {
+          n = MIN (point_size - filled, left);
+          memcpy ((guint8 *)point + filled, data, n);
+          filled += n;
+          data += n;
+          left -= n;
+
+          if (filled < point_size)
+            continue;
+
+          hyscan_buffer_internal_decode (format, values, point, 1, 1);
+          values += format->n_values;
+          n_points -= 1;
+          filled = 0;
+        }
 
-  code16  = hyscan_buffer_base16[(code32.code >> 23) & 0x1ff];
-  code16 += (code32.code & 0x007fffff) >> hyscan_buffer_shift16[(code32.code >> 23) & 0x1ff];
+      /* Точки, целиком находящиеся в сегменте. */
+      n = MIN (left / point_size, n_points);
+      if (n > 0)
+        {
+          hyscan_buffer_internal_decode (format, values, data, n, n_threads);
+          values += (gsize)n * format->n_values;
+          data += (gsize)n * point_size;
+          left -= n * point_size;
+          n_points -= n;
+        }
 
-  return GUINT16_TO_LE (code16);
+      /* Начало точки, продолжающейся в следующем сегменте. */
+      if ((n_points > 0) && (left > 0))
+        {
+          memcpy (point, data, left);
+          filled = left;
+        }
+    }
 }
 
-static inline guint32
-hyscan_buffer_encode_float32le (gfloat value)
+/* Функция кодирует n_points точек данных в сегменты. Точки, разделённые
+ * границей сегментов, кодируются во временный массив. */
+static void
+hyscan_buffer_encode_segments (const HyScanBufferFormat *format,
+                               HyScanBufferPrivate      *raw,
+                               const gfloat             *values,
+                               guint32                   point_size,
+                               guint32                   n_points,
+                               guint                     n_threads)
 {
-  union float32int code;
+  guint64 point[HYSCAN_BUFFER_MAX_POINT_SIZE / sizeof (guint64)];
+  guint32 pending = 0;
+  guint i;
+
+  for (i = 0; (i < raw->n_segments) && ((n_points > 0) || (pending > 0)); i++)
+    {
+      guint8 *data = raw->segments[i].data;
+      guint32 left = raw->segments[i].size;
+      guint32 n;
+
+      /* Окончание точки, начатой в предыдущих сегментах. */
+      if (pending > 0)
+        {
+          n = MIN (pending, left);
+          memcpy (data, (guint8 *)point + point_size - pending, n);
+          pending -= n;
+          data += n;
+          left -= n;
+
+          if (pending > 0)
+            continue;
+        }
 
-  code.value = value;
+      /* Точки, целиком находящиеся в сегменте. */
+      n = MIN (left / point_size, n_points);
+      if (n > 0)
+        {
+          hyscan_buffer_internal_encode (format, data, values, n, n_threads);
+          values += (gsize)n * format->n_values;
+          data += (gsize)n * point_size;
+          left -= n * point_size;
+          n_points -= n;
+        }
+
+      /* Начало точки, продолжающейся в следующем сегменте. */
+      if ((n_points > 0) && (left > 0))
+        {
+          hyscan_buffer_internal_encode (format, point, values, 1, 1);
+          values += format->n_values;
+          n_points -= 1;
 
-  return GUINT32_TO_LE (code.code);
+          memcpy (data, point, left);
+          pending = point_size - left;
+        }
+    }
 }
 
 /**
@@ -422,6 +830,38 @@ hyscan_buffer_new (void)
   return g_object_new (HYSCAN_TYPE_BUFFER, NULL);
 }
 
+/**
+ * hyscan_buffer_set_simd:
+ * @simd: набор инструкций #HyScanBufferSimd
+ *
+ * Функция выбирает набор инструкций, используемый для импорта и экспорта
+ * данных всеми объектами #HyScanBuffer. По умолчанию выбирается наилучший
+ * набор инструкций, поддерживаемый процессором. Результат преобразования
+ * не зависит от выбранного набора инструкций.
+ *
+ * Returns: %TRUE если набор инструкций выбран, %FALSE если он не
+ *          поддерживается процессором.
+ */
+gboolean
+hyscan_buffer_set_simd (HyScanBufferSimd simd)
+{
+  return hyscan_buffer_internal_set_simd (simd);
+}
+
+/**
+ * hyscan_buffer_get_simd:
+ *
+ * Функция возвращает набор инструкций, используемый для импорта и экспорта
+ * данных.
+ *
+ * Returns: Набор инструкций #HyScanBufferSimd.
+ */
+HyScanBufferSimd
+hyscan_buffer_get_simd (void)
+{
+  return hyscan_buffer_internal_get_codecs ()->simd;
+}
+
 /**
  * hyscan_buffer_copy:
  * @buffer: указатель на #HyScanBuffer
@@ -430,257 +870,758 @@ hyscan_buffer_new (void)
  * Функция копирует данные из внешнего буфера @orig без преобразования.
  * Если буфер находился в режиме обёртки над блоком данных, для копии
  * память будет выделена динамически.
+ *
+ * Если память буфера @orig выделена динамически, данные не копируются, а
+ * используются обоими буферами совместно. Копирование выполняется только
+ * при первом изменении данных в одном из буферов, например при получении
+ * данных функцией #hyscan_buffer_get. Для доступа к данным только для
+ * чтения, без копирования, используется функция #hyscan_buffer_peek.
  */
 void
 hyscan_buffer_copy (HyScanBuffer *buffer,
                     HyScanBuffer *orig)
 {
+  HyScanBufferPrivate *priv;
+  HyScanBufferStorage *storage;
   HyScanDataType type;
-  gpointer data;
+  gconstpointer data;
   guint32 size;
 
   g_return_if_fail (HYSCAN_IS_BUFFER (buffer));
+  g_return_if_fail (HYSCAN_IS_BUFFER (orig));
 
-  data = hyscan_buffer_get (orig, &type, &size);
-  hyscan_buffer_set (buffer, type, data, size);
+  if (buffer == orig)
+    return;
+
+  priv = buffer->priv;
+  storage = orig->priv->storage;
+
+  if (!orig->priv->self_allocated || (storage == NULL))
+    {
+      data = hyscan_buffer_peek (orig, &type, &size);
+      hyscan_buffer_set (buffer, type, (gpointer)data, size);
+      return;
+    }
+
+  /* Совместное использование памяти. */
+  g_atomic_int_inc (&storage->ref_count);
+  hyscan_buffer_storage_unref (priv->storage);
+  hyscan_buffer_unmap_file (priv);
+  hyscan_buffer_clear_segments (priv);
+
+  priv->self_allocated = TRUE;
+  priv->view = FALSE;
+  priv->storage = storage;
+  priv->allocated_size = orig->priv->allocated_size;
+  priv->type = orig->priv->type;
+  priv->data = orig->priv->data;
+  priv->size = orig->priv->size;
 }
 
-/**
- * hyscan_buffer_import:
- * @buffer: указатель на #HyScanBuffer
- * @raw: указатель на #HyScanBuffer с данными для импорта
- *
- * Функция импортирует данные из внешнего буфера @raw и преобразовывает их в
- * массив gfloat, #HyScanComplexFloat или #HyScanDOA в зависимости от их типа.
- *
- * Returns: %TRUE если данные успешно импортированы, иначе %FALSE.
- */
-gboolean
-hyscan_buffer_import (HyScanBuffer *buffer,
-                      HyScanBuffer *raw)
+/* Функция импортирует данные, используя до n_threads потоков. */
+static gboolean
+hyscan_buffer_import_real (HyScanBuffer *buffer,
+                           HyScanBuffer *raw,
+                           guint         n_threads)
 {
-  HyScanComplexFloat *complex_float_buffer = NULL;
-  HyScanDOA *doa_buffer = NULL;
-  gfloat *float_buffer = NULL;
+  const HyScanBufferFormat *format;
   HyScanDataType type;
-  gpointer data;
+  gconstpointer data;
+  guint32 point_size;
   guint32 n_points;
   guint32 size;
-  guint32 i;
 
-  g_return_val_if_fail (HYSCAN_IS_BUFFER (buffer), FALSE);
+  g_return_val_if_fail (HYSCAN_IS_BUFFER (raw), FALSE);
 
   /* Размер и тип импортируемых данных. */
-  data = hyscan_buffer_get (raw, &type, &size);
-  if (hyscan_data_get_point_size (type) == 0)
+  type = raw->priv->type;
+  format = hyscan_buffer_internal_get_format (type);
+  if (format == NULL)
     return FALSE;
 
-  n_points = size / hyscan_data_get_point_size (type);
-  switch (type)
-    {
-    case HYSCAN_DATA_FLOAT:
-    case HYSCAN_DATA_ADC14LE:
-    case HYSCAN_DATA_ADC16LE:
-    case HYSCAN_DATA_ADC24LE:
-    case HYSCAN_DATA_FLOAT16LE:
-    case HYSCAN_DATA_FLOAT32LE:
-    case HYSCAN_DATA_AMPLITUDE_INT8:
-    case HYSCAN_DATA_AMPLITUDE_INT16LE:
-    case HYSCAN_DATA_AMPLITUDE_INT24LE:
-    case HYSCAN_DATA_AMPLITUDE_INT32LE:
-    case HYSCAN_DATA_AMPLITUDE_FLOAT16LE:
-    case HYSCAN_DATA_AMPLITUDE_FLOAT32LE:
-      hyscan_buffer_set_float (buffer, NULL, n_points);
-      float_buffer = hyscan_buffer_get_float (buffer, &n_points);
-      break;
-
-    case HYSCAN_DATA_COMPLEX_FLOAT:
-    case HYSCAN_DATA_COMPLEX_ADC14LE:
-    case HYSCAN_DATA_COMPLEX_ADC16LE:
-    case HYSCAN_DATA_COMPLEX_ADC24LE:
-    case HYSCAN_DATA_COMPLEX_FLOAT16LE:
-    case HYSCAN_DATA_COMPLEX_FLOAT32LE:
-      hyscan_buffer_set_complex_float (buffer, NULL, n_points);
-      complex_float_buffer = hyscan_buffer_get_complex_float (buffer, &n_points);
-      break;
+  point_size = hyscan_data_get_point_size (type);
+  if (point_size > HYSCAN_BUFFER_MAX_POINT_SIZE)
+    return FALSE;
 
-    case HYSCAN_DATA_DOA:
-    case HYSCAN_DATA_DOA_FLOAT32LE:
-      hyscan_buffer_set_doa (buffer, NULL, n_points);
-      doa_buffer = hyscan_buffer_get_doa (buffer, &n_points);
-      break;
+  n_points = raw->priv->size / point_size;
+  size = n_points * hyscan_data_get_point_size (format->float_type);
+  hyscan_buffer_set (buffer, format->float_type, NULL, size);
 
-    default:
-      return FALSE;
+  /* Импорт данных из сегментов. */
+  if (raw->priv->segmented)
+    {
+      hyscan_buffer_decode_segments (format, buffer->priv->data, raw->priv,
+                                     point_size, n_points, n_threads);
+      return TRUE;
     }
 
   /* Импорт данных. */
-  switch (type)
-    {
-    case HYSCAN_DATA_FLOAT:
-      {
-        memcpy (float_buffer, data, size);
-      }
-      break;
-
-    case HYSCAN_DATA_ADC14LE:
-      {
-        guint16 *raw_data = data;
-        for (i = 0; i < n_points; i++)
-          float_buffer[i] = hyscan_buffer_decode_adc_14le (*raw_data++);
-      }
-      break;
+  data = hyscan_buffer_peek (raw, NULL, &size);
+  hyscan_buffer_internal_decode (format, buffer->priv->data, data, n_points, n_threads);
 
-    case HYSCAN_DATA_ADC16LE:
-      {
-        guint16 *raw_data = data;
-        for (i = 0; i < n_points; i++)
-          float_buffer[i] = hyscan_buffer_decode_adc_16le (*raw_data++);
-      }
-      break;
+  return TRUE;
+}
 
-    case HYSCAN_DATA_ADC24LE:
-      {
-        guint32 *raw_data = data;
-        for (i = 0; i < n_points; i++)
-          float_buffer[i] = hyscan_buffer_decode_adc_24le (*raw_data++);
-      }
-      break;
+/* Функция экспортирует данные, используя до n_threads потоков. */
+static gboolean
+hyscan_buffer_export_real (HyScanBuffer   *buffer,
+                           HyScanBuffer   *raw,
+                           HyScanDataType  type,
+                           guint           n_threads)
+{
+  const HyScanBufferFormat *format;
+  HyScanDataType float_type;
+  gconstpointer data;
+  guint32 n_points;
+  guint32 size;
 
-    case HYSCAN_DATA_AMPLITUDE_INT8:
-      {
-        guint8 *raw_data = data;
-        for (i = 0; i < n_points; i++)
-          float_buffer[i] = hyscan_buffer_decode_int8 (*raw_data++);
-      }
-      break;
+  /* Тип данных: действительные, комплексные или пространственные. */
+  format = hyscan_buffer_internal_get_format (type);
+  if (format == NULL)
+    return FALSE;
 
-    case HYSCAN_DATA_AMPLITUDE_INT16LE:
-      {
-        guint16 *raw_data = data;
-        for (i = 0; i < n_points; i++)
-          float_buffer[i] = hyscan_buffer_decode_int16le (*raw_data++);
-      }
-      break;
+  data = hyscan_buffer_peek (buffer, &float_type, &size);
+  if (float_type != format->float_type)
+    return FALSE;
 
-    case HYSCAN_DATA_AMPLITUDE_INT24LE:
-      {
-        guint32 *raw_data = data;
-        for (i = 0; i < n_points; i++)
-          float_buffer[i] = hyscan_buffer_decode_int24le (*raw_data++);
-      }
-      break;
+  /* Размер экспортируемых данных. */
+  n_points = size / hyscan_data_get_point_size (float_type);
+  size = n_points * hyscan_data_get_point_size (type);
 
-    case HYSCAN_DATA_AMPLITUDE_INT32LE:
-      {
-        guint32 *raw_data = data;
-        for (i = 0; i < n_points; i++)
-          float_buffer[i] = hyscan_buffer_decode_int32le (*raw_data++);
-      }
-      break;
+  /* Экспорт данных в сегменты, размер которых не изменяется. */
+  if (raw->priv->segmented)
+    {
+      if ((size > raw->priv->allocated_size) ||
+          (hyscan_data_get_point_size (type) > HYSCAN_BUFFER_MAX_POINT_SIZE))
+        {
+          return FALSE;
+        }
 
-    case HYSCAN_DATA_FLOAT16LE:
-    case HYSCAN_DATA_AMPLITUDE_FLOAT16LE:
-      {
-        guint16 *raw_data = data;
-        for (i = 0; i < n_points; i++)
-          float_buffer[i] = hyscan_buffer_decode_float16le (*raw_data++);
-      }
-      break;
+      raw->priv->type = type;
+      raw->priv->size = size;
+      hyscan_buffer_encode_segments (format, raw->priv, data,
+                                     hyscan_data_get_point_size (type), n_points, n_threads);
+
+      return TRUE;
+    }
+
+  hyscan_buffer_set (raw, type, NULL, size);
+
+  /* Экспорт данных. */
+  hyscan_buffer_internal_encode (format, raw->priv->data, data, n_points, n_threads);
+
+  return TRUE;
+}
+
+/**
+ * hyscan_buffer_import:
+ * @buffer: указатель на #HyScanBuffer
+ * @raw: указатель на #HyScanBuffer с данными для импорта
+ *
+ * Функция импортирует данные из внешнего буфера @raw и преобразовывает их в
+ * массив gfloat, #HyScanComplexFloat или #HyScanDOA в зависимости от их типа.
+ *
+ * Returns: %TRUE если данные успешно импортированы, иначе %FALSE.
+ */
+gboolean
+hyscan_buffer_import (HyScanBuffer *buffer,
+                      HyScanBuffer *raw)
+{
+  g_return_val_if_fail (HYSCAN_IS_BUFFER (buffer), FALSE);
+
+  return hyscan_buffer_import_real (buffer, raw, 1);
+}
+
+/**
+ * hyscan_buffer_import_parallel:
+ * @buffer: указатель на #HyScanBuffer
+ * @raw: указатель на #HyScanBuffer с данными для импорта
+ * @n_threads: максимальное число потоков или 0
+ *
+ * Функция аналогична #hyscan_buffer_import, но преобразование выполняется
+ * параллельно, частями, в общем для всех объектов пуле потоков. Вызывающий
+ * поток также участвует в преобразовании. Если @n_threads равно 0, число
+ * потоков равно числу процессоров.
+ *
+ * Данные, число точек в которых меньше порога, заданного функцией
+ * #hyscan_buffer_set_parallel_threshold, преобразуются в вызывающем потоке.
+ *
+ * Returns: %TRUE если данные успешно импортированы, иначе %FALSE.
+ */
+gboolean
+hyscan_buffer_import_parallel (HyScanBuffer *buffer,
+                               HyScanBuffer *raw,
+                               guint         n_threads)
+{
+  g_return_val_if_fail (HYSCAN_IS_BUFFER (buffer), FALSE);
+
+  return hyscan_buffer_import_real (buffer, raw, n_threads);
+}
+
+/**
+ * hyscan_buffer_import_view:
+ * @buffer: указатель на #HyScanBuffer
+ * @raw: указатель на #HyScanBuffer с данными для импорта
+ * @view: (out) (optional): признак представления данных
+ *
+ * Функция аналогична #hyscan_buffer_import, но если данные не требуют
+ * преобразования, например FLOAT32LE, COMPLEX_FLOAT32LE или DOA_FLOAT32LE на
+ * платформах с порядком байт little endian, буфер @buffer конфигурируется
+ * как обёртка над данными @raw. При этом память не выделяется и данные не
+ * копируются. Иначе данные импортируются обычным образом.
+ *
+ * Если в @view записано %TRUE, @buffer ссылается на данные @raw. При первом
+ * изменении данных в @buffer, например при получении данных функцией
+ * #hyscan_buffer_get, они копируются, так что @raw и его копии не
+ * изменяются. Если @raw является обёрткой над внешними данными, они должны
+ * оставаться доступными и неизменными всё время использования @buffer.
+ * Область файла, отображённая функцией #hyscan_buffer_map_file, остаётся
+ * доступной @buffer и после удаления @raw или изменения режима его работы.
+ *
+ * Returns: %TRUE если данные успешно импортированы, иначе %FALSE.
+ */
+gboolean
+hyscan_buffer_import_view (HyScanBuffer *buffer,
+                           HyScanBuffer *raw,
+                           gboolean     *view)
+{
+  const HyScanBufferFormat *format;
+  HyScanDataType type;
+  gconstpointer data;
+  guint32 n_points;
+  guint32 size;
+
+  g_return_val_if_fail (HYSCAN_IS_BUFFER (buffer), FALSE);
+  g_return_val_if_fail (buffer != raw, FALSE);
+
+  (view != NULL) ? *view = FALSE : 0;
+
+  data = hyscan_buffer_peek (raw, &type, &size);
+  format = hyscan_buffer_internal_get_format (type);
+  if (format == NULL)
+    return FALSE;
+
+  /* Представление возможно только для выровненных данных. */
+  if (!hyscan_buffer_internal_is_identity (format) ||
+      (GPOINTER_TO_SIZE (data) % sizeof (gfloat) != 0))
+    {
+      return hyscan_buffer_import_real (buffer, raw, 1);
+    }
+
+  n_points = size / hyscan_data_get_point_size (type);
+  size = n_points * hyscan_data_get_point_size (format->float_type);
+
+  /* Память @raw используется совместно и отделяется при изменении данных
+   * в одном из буферов. Внешние данные копируются при изменении данных
+   * представления. */
+  if (raw->priv->self_allocated && (raw->priv->storage != NULL))
+    {
+      hyscan_buffer_copy (buffer, raw);
+      buffer->priv->type = format->float_type;
+      buffer->priv->size = size;
+    }
+  else
+    {
+      if (!hyscan_buffer_wrap (buffer, format->float_type, (gpointer)data, size))
+        return FALSE;
+
+      hyscan_buffer_ref_file (buffer->priv, raw->priv);
+      buffer->priv->view = TRUE;
+    }
+
+  (view != NULL) ? *view = TRUE : 0;
+
+  return TRUE;
+}
+
+/**
+ * hyscan_buffer_import_in_place:
+ * @buffer: указатель на #HyScanBuffer
+ *
+ * Функция импортирует данные, находящиеся в самом буфере, и записывает
+ * результат на их место, без выделения отдельной памяти. Если результат
+ * больше исходных данных, память буфера увеличивается. В режиме обёртки
+ * над внешними данными это невозможно, и функция возвращает %FALSE.
+ *
+ * Для данных в формате FLOAT32LE на платформах с порядком байт little
+ * endian изменяется только тип данных.
+ *
+ * Returns: %TRUE если данные успешно импортированы, иначе %FALSE.
+ */
+gboolean
+hyscan_buffer_import_in_place (HyScanBuffer *buffer)
+{
+  const HyScanBufferFormat *format;
+  HyScanBufferPrivate *priv;
+  guint32 n_points;
+  guint32 size;
+
+  g_return_val_if_fail (HYSCAN_IS_BUFFER (buffer), FALSE);
+
+  priv = buffer->priv;
+
+  format = hyscan_buffer_internal_get_format (priv->type);
+  if (format == NULL)
+    return FALSE;
+
+  n_points = priv->size / hyscan_data_get_point_size (priv->type);
+  size = n_points * hyscan_data_get_point_size (format->float_type);
+  if (!hyscan_buffer_internal_is_identity (format))
+    {
+      if (!hyscan_buffer_prepare (priv, MAX (size, priv->size), TRUE))
+        return FALSE;
+
+      hyscan_buffer_internal_decode_in_place (format, priv->data, n_points);
+    }
+
+  priv->type = format->float_type;
+  priv->size = size;
+
+  return TRUE;
+}
+
+/**
+ * hyscan_buffer_export_in_place:
+ * @buffer: указатель на #HyScanBuffer
+ * @type: тип экспортируемых данныx
+ *
+ * Функция экспортирует данные, находящиеся в самом буфере, в тип @type и
+ * записывает результат на их место, без выделения отдельной памяти.
+ *
+ * Returns: %TRUE если данные успешно экспортированы, иначе %FALSE.
+ */
+gboolean
+hyscan_buffer_export_in_place (HyScanBuffer   *buffer,
+                               HyScanDataType  type)
+{
+  const HyScanBufferFormat *format;
+  HyScanBufferPrivate *priv;
+  guint32 n_points;
+
+  g_return_val_if_fail (HYSCAN_IS_BUFFER (buffer), FALSE);
+
+  priv = buffer->priv;
+
+  format = hyscan_buffer_internal_get_format (type);
+  if ((format == NULL) || (priv->type != format->float_type))
+    return FALSE;
+
+  n_points = priv->size / hyscan_data_get_point_size (priv->type);
+
+  if (!hyscan_buffer_internal_is_identity (format))
+    {
+      if (!hyscan_buffer_prepare (priv, priv->size, TRUE))
+        return FALSE;
+
+      hyscan_buffer_internal_encode_in_place (format, priv->data, n_points);
+    }
+
+  priv->type = type;
+  priv->size = n_points * hyscan_data_get_point_size (type);
+
+  return TRUE;
+}
+
+/**
+ * hyscan_buffer_import_range:
+ * @buffer: указатель на #HyScanBuffer
+ * @raw: указатель на #HyScanBuffer с данными для импорта
+ * @offset: индекс первой импортируемой точки
+ * @n_points: число импортируемых точек
+ *
+ * Функция импортирует точки данных с индексами [@offset, @offset + @n_points)
+ * из внешнего буфера @raw. Остальные данные не преобразуются. Если данных
+ * меньше, чем запрошено, импортируются все точки, начиная с @offset.
+ *
+ * Returns: %TRUE если данные успешно импортированы, иначе %FALSE.
+ */
+gboolean
+hyscan_buffer_import_range (HyScanBuffer *buffer,
+                            HyScanBuffer *raw,
+                            guint32       offset,
+                            guint32       n_points)
+{
+  const HyScanBufferFormat *format;
+  HyScanDataType type;
+  const guint8 *data;
+  guint32 point_size;
+  guint32 size;
+
+  g_return_val_if_fail (HYSCAN_IS_BUFFER (buffer), FALSE);
+
+  if (buffer == raw)
+    return FALSE;
+
+  /* Размер и тип импортируемых данных. */
+  data = hyscan_buffer_peek (raw, &type, &size);
+  format = hyscan_buffer_internal_get_format (type);
+  if (format == NULL)
+    return FALSE;
+
+  point_size = hyscan_data_get_point_size (type);
+  if (offset > size / point_size)
+    return FALSE;
+
+  n_points = MIN (n_points, size / point_size - offset);
+  size = n_points * hyscan_data_get_point_size (format->float_type);
+  hyscan_buffer_set (buffer, format->float_type, NULL, size);
+
+  /* Импорт данных. */
+  hyscan_buffer_internal_decode (format, buffer->priv->data, data + (gsize)offset * point_size, n_points, 1);
+
+  return TRUE;
+}
+
+/**
+ * hyscan_buffer_import_decimated:
+ * @buffer: указатель на #HyScanBuffer
+ * @raw: указатель на #HyScanBuffer с данными для импорта
+ * @factor: коэффициент прореживания
+ * @decimation: способ прореживания #HyScanBufferDecimation
+ *
+ * Функция импортирует данные из внешнего буфера @raw, уменьшая число точек
+ * в @factor раз. Точки разбиваются на группы по @factor точек, каждая
+ * группа заменяется одной точкой. Последняя группа может быть неполной.
+ *
+ * При прореживании #HYSCAN_BUFFER_DECIMATION_STRIDE декодируется только
+ * первая точка каждой группы. При прореживании #HYSCAN_BUFFER_DECIMATION_MAX
+ * выбирается точка с максимальным абсолютным значением, для комплексных
+ * данных - с максимальной амплитудой, для пространственных - с максимальной
+ * амплитудой отражённого сигнала. При прореживании #HYSCAN_BUFFER_DECIMATION_MEAN
+ * вычисляется среднее значение каждой компоненты точек группы.
+ *
+ * Returns: %TRUE если данные успешно импортированы, иначе %FALSE.
+ */
+gboolean
+hyscan_buffer_import_decimated (HyScanBuffer           *buffer,
+                                HyScanBuffer           *raw,
+                                guint32                 factor,
+                                HyScanBufferDecimation  decimation)
+{
+  const HyScanBufferFormat *format;
+  HyScanDataType type;
+  gconstpointer data;
+  guint32 n_points;
+  guint32 size;
+
+  g_return_val_if_fail (HYSCAN_IS_BUFFER (buffer), FALSE);
+  g_return_val_if_fail (factor > 0, FALSE);
+
+  if (buffer == raw)
+    return FALSE;
+
+  if ((decimation != HYSCAN_BUFFER_DECIMATION_STRIDE) &&
+      (decimation != HYSCAN_BUFFER_DECIMATION_MAX) &&
+      (decimation != HYSCAN_BUFFER_DECIMATION_MEAN))
+    {
+      return FALSE;
+    }
+
+  /* Размер и тип импортируемых данных. */
+  data = hyscan_buffer_peek (raw, &type, &size);
+  format = hyscan_buffer_internal_get_format (type);
+  if (format == NULL)
+    return FALSE;
+
+  n_points = size / hyscan_data_get_point_size (type);
+  size = (n_points / factor + ((n_points % factor) ? 1 : 0)) * hyscan_data_get_point_size (format->float_type);
+  hyscan_buffer_set (buffer, format->float_type, NULL, size);
+
+  /* Импорт данных. */
+  hyscan_buffer_internal_decimate (format, buffer->priv->data, data, n_points, factor, decimation);
+
+  return TRUE;
+}
+
+/**
+ * hyscan_buffer_import_transform:
+ * @buffer: указатель на #HyScanBuffer
+ * @raw: указатель на #HyScanBuffer с данными для импорта
+ * @ops: (array length=n_ops): последовательность операций #HyScanBufferOp
+ * @n_ops: число операций
+ *
+ * Функция импортирует действительные или комплексные данные из внешнего
+ * буфера @raw и выполняет над ними последовательность операций @ops. Все
+ * операции выполняются за один проход по данным, одновременно с их
+ * преобразованием. Например, импорт отсчётов АЦП с учётом опорного
+ * напряжения и смещения нуля и вычислением амплитуды в дБ можно выполнить
+ * операциями:
+ *
+ * |[<!-- language="C" -->
+ * HyScanBufferOp ops[] = { { HYSCAN_BUFFER_OP_OFFSET,    -offset },
+ *                          { HYSCAN_BUFFER_OP_SCALE,     vref },
+ *                          { HYSCAN_BUFFER_OP_AMPLITUDE, 0.0 },
+ *                          { HYSCAN_BUFFER_OP_DB,        20.0 } };
+ * ]|
+ *
+ * Операции масштабирования и смещения применяются к каждой компоненте
+ * комплексного числа. Операция #HYSCAN_BUFFER_OP_AMPLITUDE для комплексных
+ * данных вычисляет амплитуду, после чего результат становится массивом
+ * gfloat. Операция #HYSCAN_BUFFER_OP_DB допустима только для действительных
+ * данных. Пространственные данные не поддерживаются.
+ *
+ * Returns: %TRUE если данные успешно импортированы, иначе %FALSE.
+ */
+gboolean
+hyscan_buffer_import_transform (HyScanBuffer         *buffer,
+                                HyScanBuffer         *raw,
+                                const HyScanBufferOp *ops,
+                                guint                 n_ops)
+{
+  const HyScanBufferFormat *format;
+  HyScanDataType float_type;
+  HyScanDataType type;
+  gconstpointer data;
+  guint32 n_points;
+  guint32 size;
+  guint i;
+
+  g_return_val_if_fail (HYSCAN_IS_BUFFER (buffer), FALSE);
+  g_return_val_if_fail ((ops != NULL) || (n_ops == 0), FALSE);
+
+  if (buffer == raw)
+    return FALSE;
+
+  /* Размер и тип импортируемых данных. */
+  data = hyscan_buffer_peek (raw, &type, &size);
+  format = hyscan_buffer_internal_get_format (type);
+  if ((format == NULL) || (format->float_type == HYSCAN_DATA_DOA))
+    return FALSE;
+
+  /* Проверка операций и тип данных результата. */
+  float_type = format->float_type;
+  for (i = 0; i < n_ops; i++)
+    {
+      switch (ops[i].type)
+        {
+        case HYSCAN_BUFFER_OP_SCALE:
+        case HYSCAN_BUFFER_OP_OFFSET:
+          break;
+
+        case HYSCAN_BUFFER_OP_AMPLITUDE:
+          float_type = HYSCAN_DATA_FLOAT;
+          break;
+
+        case HYSCAN_BUFFER_OP_DB:
+          if (float_type != HYSCAN_DATA_FLOAT)
+            return FALSE;
+          break;
+
+        default:
+          return FALSE;
+        }
+    }
+
+  n_points = size / hyscan_data_get_point_size (type);
+  size = n_points * hyscan_data_get_point_size (float_type);
+  hyscan_buffer_set (buffer, float_type, NULL, size);
+
+  /* Импорт данных. */
+  hyscan_buffer_internal_transform (format, buffer->priv->data, data, n_points, ops, n_ops);
+
+  return TRUE;
+}
+
+/**
+ * hyscan_buffer_import_amplitude:
+ * @buffer: указатель на #HyScanBuffer
+ * @raw: указатель на #HyScanBuffer с данными для импорта
+ *
+ * Функция импортирует комплексные данные из внешнего буфера @raw и
+ * преобразовывает их в массив амплитуд gfloat. Амплитуда вычисляется
+ * как sqrtf (re * re + im * im) векторными функциями, одновременно с
+ * преобразованием данных, без промежуточного массива #HyScanComplexFloat.
+ * Для действительных данных вычисляется модуль значений.
+ *
+ * Returns: %TRUE если данные успешно импортированы, иначе %FALSE.
+ */
+gboolean
+hyscan_buffer_import_amplitude (HyScanBuffer *buffer,
+                                HyScanBuffer *raw)
+{
+  const HyScanBufferOp amplitude = { HYSCAN_BUFFER_OP_AMPLITUDE, 0.0f };
+
+  return hyscan_buffer_import_transform (buffer, raw, &amplitude, 1);
+}
+
+/**
+ * hyscan_buffer_import_batch:
+ * @buffer: указатель на #HyScanBuffer
+ * @raws: (array length=n_raws): строки данных для импорта
+ * @n_raws: число строк данных
+ * @n_points: число точек в строке матрицы или 0
+ * @stride: шаг матрицы в точках или 0
+ * @layout: расположение строк в матрице #HyScanBufferLayout
+ * @n_threads: максимальное число потоков или 0
+ *
+ * Функция импортирует строки данных из буферов @raws в одну матрицу
+ * действительных, комплексных или пространственных данных. Все строки
+ * должны импортироваться в один тип данных.
+ *
+ * Каждая строка данных занимает в матрице @n_points точек. Если @n_points
+ * равно 0, используется длина самой длинной строки. Более длинные строки
+ * усекаются, более короткие дополняются нулями.
+ *
+ * При расположении #HYSCAN_BUFFER_LAYOUT_ROW_MAJOR строка данных с индексом
+ * i начинается с точки i * @stride матрицы, @stride должен быть не меньше
+ * @n_points. При расположении #HYSCAN_BUFFER_LAYOUT_COLUMN_MAJOR точка j
+ * строки данных i находится в точке j * @stride + i матрицы, @stride должен
+ * быть не меньше @n_raws. Если @stride равен 0, используется минимальное
+ * значение. Точки матрицы, не занятые данными, заполняются нулями.
+ *
+ * Память для матрицы выделяется один раз. Строки данных преобразуются
+ * параллельно, как в функции #hyscan_buffer_import_parallel.
+ *
+ * Returns: %TRUE если данные успешно импортированы, иначе %FALSE.
+ */
+gboolean
+hyscan_buffer_import_batch (HyScanBuffer       *buffer,
+                            HyScanBuffer      **raws,
+                            guint               n_raws,
+                            guint32             n_points,
+                            guint32             stride,
+                            HyScanBufferLayout  layout,
+                            guint               n_threads)
+{
+  const HyScanBufferFormat *format;
+  HyScanDataType float_type = HYSCAN_DATA_INVALID;
+  HyScanBufferBatch batch;
+  guint32 max_points = 0;
+  guint32 point_size;
+  guint64 size;
+  guint i;
+
+  g_return_val_if_fail (HYSCAN_IS_BUFFER (buffer), FALSE);
+  g_return_val_if_fail ((raws != NULL) || (n_raws == 0), FALSE);
+
+  if (n_raws == 0)
+    return FALSE;
+
+  /* Тип и размер строк данных. */
+  for (i = 0; i < n_raws; i++)
+    {
+      HyScanDataType type;
+      guint32 raw_size;
+
+      g_return_val_if_fail (HYSCAN_IS_BUFFER (raws[i]), FALSE);
+
+      if (raws[i] == buffer)
+        return FALSE;
+
+      /* Сегменты собираются до начала параллельного преобразования. */
+      hyscan_buffer_peek (raws[i], &type, &raw_size);
+      format = hyscan_buffer_internal_get_format (type);
+      if (format == NULL)
+        return FALSE;
+
+      if ((i > 0) && (format->float_type != float_type))
+        return FALSE;
+
+      float_type = format->float_type;
+      max_points = MAX (max_points, raw_size / hyscan_data_get_point_size (type));
+    }
+
+  if (n_points == 0)
+    n_points = max_points;
+
+  /* Размер матрицы. */
+  if (layout == HYSCAN_BUFFER_LAYOUT_ROW_MAJOR)
+    {
+      stride = (stride == 0) ? n_points : stride;
+      if (stride < n_points)
+        return FALSE;
+
+      size = (guint64)n_raws * stride;
+    }
+  else if (layout == HYSCAN_BUFFER_LAYOUT_COLUMN_MAJOR)
+    {
+      stride = (stride == 0) ? n_raws : stride;
+      if (stride < n_raws)
+        return FALSE;
+
+      size = (guint64)n_points * stride;
+    }
+  else
+    {
+      return FALSE;
+    }
 
-    case HYSCAN_DATA_FLOAT32LE:
-    case HYSCAN_DATA_AMPLITUDE_FLOAT32LE:
-      {
-        guint32 *raw_data = data;
-        for (i = 0; i < n_points; i++)
-          float_buffer[i] = hyscan_buffer_decode_float32le (*raw_data++);
-      }
-      break;
+  point_size = hyscan_data_get_point_size (float_type);
+  if (size * point_size > G_MAXUINT32)
+    return FALSE;
 
-    case HYSCAN_DATA_COMPLEX_FLOAT:
-      {
-        memcpy (complex_float_buffer, data, size);
-      }
-      break;
+  hyscan_buffer_set (buffer, float_type, NULL, size * point_size);
 
-    case HYSCAN_DATA_COMPLEX_ADC14LE:
-      {
-        guint16 *raw_data = data;
-        for (i = 0; i < n_points; i++)
-          {
-            complex_float_buffer[i].re = hyscan_buffer_decode_adc_14le (*raw_data++);
-            complex_float_buffer[i].im = hyscan_buffer_decode_adc_14le (*raw_data++);
-          }
-      }
-      break;
+  if (size == 0)
+    return TRUE;
 
-    case HYSCAN_DATA_COMPLEX_ADC16LE:
-      {
-        guint16 *raw_data = data;
-        for (i = 0; i < n_points; i++)
-          {
-            complex_float_buffer[i].re = hyscan_buffer_decode_adc_16le (*raw_data++);
-            complex_float_buffer[i].im = hyscan_buffer_decode_adc_16le (*raw_data++);
-          }
-      }
-      break;
+  batch.raws = raws;
+  batch.n_points = n_points;
+  batch.stride = stride;
+  batch.n_values = point_size / sizeof (gfloat);
+  batch.layout = layout;
+  batch.matrix = buffer->priv->data;
 
-    case HYSCAN_DATA_COMPLEX_ADC24LE:
-      {
-        guint32 *raw_data = data;
-        for (i = 0; i < n_points; i++)
-          {
-            complex_float_buffer[i].re = hyscan_buffer_decode_adc_24le (*raw_data++);
-            complex_float_buffer[i].im = hyscan_buffer_decode_adc_24le (*raw_data++);
-          }
-      }
-      break;
+  /* Столбцы матрицы после последней строки данных. */
+  if ((layout == HYSCAN_BUFFER_LAYOUT_COLUMN_MAJOR) && (stride > n_raws))
+    {
+      for (i = 0; i < n_points; i++)
+        {
+          memset (batch.matrix + ((gsize)i * stride + n_raws) * batch.n_values, 0,
+                  (gsize)(stride - n_raws) * point_size);
+        }
+    }
 
-    case HYSCAN_DATA_COMPLEX_FLOAT16LE:
-      {
-        guint16 *raw_data = data;
-        for (i = 0; i < n_points; i++)
-          {
-            complex_float_buffer[i].re = hyscan_buffer_decode_float16le (*raw_data++);
-            complex_float_buffer[i].im = hyscan_buffer_decode_float16le (*raw_data++);
-          }
-      }
-      break;
+  n_threads = hyscan_buffer_internal_get_n_threads (MIN (n_raws * (guint64)n_points, G_MAXUINT32), n_threads);
+  hyscan_buffer_internal_parallel (hyscan_buffer_batch_task, &batch, n_raws, n_threads);
 
-    case HYSCAN_DATA_COMPLEX_FLOAT32LE:
-      {
-        guint32 *raw_data = data;
-        for (i = 0; i < n_points; i++)
-          {
-            complex_float_buffer[i].re = hyscan_buffer_decode_float32le (*raw_data++);
-            complex_float_buffer[i].im = hyscan_buffer_decode_float32le (*raw_data++);
-          }
-      }
-      break;
+  return TRUE;
+}
 
-    case HYSCAN_DATA_DOA:
-      {
-        memcpy (doa_buffer, data, size);
-      }
-      break;
+/**
+ * hyscan_buffer_import_complex_planar:
+ * @re: указатель на #HyScanBuffer для действительной части
+ * @im: указатель на #HyScanBuffer для мнимой части
+ * @raw: указатель на #HyScanBuffer с данными для импорта
+ *
+ * Функция импортирует комплексные данные из внешнего буфера @raw и
+ * записывает действительные и мнимые части точек в отдельные массивы gfloat
+ * в буферах @re и @im.
+ *
+ * Returns: %TRUE если данные успешно импортированы, иначе %FALSE.
+ */
+gboolean
+hyscan_buffer_import_complex_planar (HyScanBuffer *re,
+                                     HyScanBuffer *im,
+                                     HyScanBuffer *raw)
+{
+  HyScanBuffer *planes[2] = { re, im };
 
-    case HYSCAN_DATA_DOA_FLOAT32LE:
-      {
-        guint32 *raw_data = data;
-        for (i = 0; i < n_points; i++)
-          {
-            doa_buffer[i].angle = hyscan_buffer_decode_float32le (*raw_data++);
-            doa_buffer[i].distance = hyscan_buffer_decode_float32le (*raw_data++);
-            doa_buffer[i].amplitude = hyscan_buffer_decode_float32le (*raw_data++);
-          }
-      }
-      break;
+  return hyscan_buffer_import_planar (raw, HYSCAN_DATA_COMPLEX_FLOAT, planes, 2);
+}
 
-    default:
-      return FALSE;
-    }
+/**
+ * hyscan_buffer_import_doa_planar:
+ * @angle: указатель на #HyScanBuffer для углов прихода
+ * @distance: указатель на #HyScanBuffer для дальностей
+ * @amplitude: указатель на #HyScanBuffer для амплитуд
+ * @raw: указатель на #HyScanBuffer с данными для импорта
+ *
+ * Функция импортирует пространственные данные из внешнего буфера @raw и
+ * записывает компоненты #HyScanDOA в отдельные массивы gfloat в буферах
+ * @angle, @distance и @amplitude.
+ *
+ * Returns: %TRUE если данные успешно импортированы, иначе %FALSE.
+ */
+gboolean
+hyscan_buffer_import_doa_planar (HyScanBuffer *angle,
+                                 HyScanBuffer *distance,
+                                 HyScanBuffer *amplitude,
+                                 HyScanBuffer *raw)
+{
+  HyScanBuffer *planes[3] = { angle, distance, amplitude };
 
-  return TRUE;
+  return hyscan_buffer_import_planar (raw, HYSCAN_DATA_DOA, planes, 3);
 }
 
 /**
@@ -699,345 +1640,729 @@ hyscan_buffer_export (HyScanBuffer   *buffer,
                       HyScanBuffer   *raw,
                       HyScanDataType  type)
 {
-  HyScanComplexFloat *complex_float_buffer = NULL;
-  HyScanDOA *doa_buffer = NULL;
-  gfloat *float_buffer = NULL;
-  guint8 *raw_data = NULL;
+  g_return_val_if_fail (HYSCAN_IS_BUFFER (buffer), FALSE);
+
+  return hyscan_buffer_export_real (buffer, raw, type, 1);
+}
+
+/**
+ * hyscan_buffer_export_parallel:
+ * @buffer: указатель на #HyScanBuffer
+ * @raw: указатель на #HyScanBuffer для экспортируемых данныx
+ * @type: тип экспортируемых данныx
+ * @n_threads: максимальное число потоков или 0
+ *
+ * Функция аналогична #hyscan_buffer_export, но преобразование выполняется
+ * параллельно, аналогично #hyscan_buffer_import_parallel.
+ *
+ * Returns: %TRUE если данные успешно экспортированы, иначе %FALSE.
+ */
+gboolean
+hyscan_buffer_export_parallel (HyScanBuffer   *buffer,
+                               HyScanBuffer   *raw,
+                               HyScanDataType  type,
+                               guint           n_threads)
+{
+  g_return_val_if_fail (HYSCAN_IS_BUFFER (buffer), FALSE);
+
+  return hyscan_buffer_export_real (buffer, raw, type, n_threads);
+}
+
+/**
+ * hyscan_buffer_set_parallel_threshold:
+ * @n_points: минимальное число точек
+ *
+ * Функция устанавливает минимальное число точек данных, начиная с которого
+ * функции #hyscan_buffer_import_parallel и #hyscan_buffer_export_parallel
+ * используют несколько потоков. Для меньших объёмов данных затраты на
+ * запуск потоков превышают выигрыш от параллельного преобразования.
+ * По умолчанию порог равен 262144 точкам.
+ */
+void
+hyscan_buffer_set_parallel_threshold (guint32 n_points)
+{
+  hyscan_buffer_internal_set_parallel_threshold (n_points);
+}
+
+/**
+ * hyscan_buffer_get_parallel_threshold:
+ *
+ * Функция возвращает минимальное число точек данных для параллельного
+ * преобразования.
+ *
+ * Returns: Минимальное число точек.
+ */
+guint32
+hyscan_buffer_get_parallel_threshold (void)
+{
+  return hyscan_buffer_internal_get_parallel_threshold ();
+}
+
+/**
+ * hyscan_buffer_transcode:
+ * @buffer: указатель на #HyScanBuffer для преобразованных данных
+ * @raw: указатель на #HyScanBuffer с исходными данными
+ * @type: тип преобразованных данных
+ *
+ * Функция преобразовывает данные из внешнего буфера @raw в тип @type без
+ * промежуточного массива gfloat. Результат совпадает с последовательным
+ * импортом и экспортом, но преобразование выполняется за один проход,
+ * частями, через небольшой промежуточный буфер, находящийся в кэше.
+ *
+ * Исходный и требуемый тип данных должны быть совместимы, т.е. оба
+ * должны быть действительными, комплексными или пространственными.
+ *
+ * Returns: %TRUE если данные успешно преобразованы, иначе %FALSE.
+ */
+gboolean
+hyscan_buffer_transcode (HyScanBuffer   *buffer,
+                         HyScanBuffer   *raw,
+                         HyScanDataType  type)
+{
+  const HyScanBufferFormat *dst_format;
+  const HyScanBufferFormat *src_format;
+  HyScanDataType src_type;
+  gconstpointer data;
   guint32 n_points;
   guint32 size;
-  guint32 i;
 
   g_return_val_if_fail (HYSCAN_IS_BUFFER (buffer), FALSE);
+  g_return_val_if_fail (buffer != raw, FALSE);
+
+  data = hyscan_buffer_peek (raw, &src_type, &size);
+  src_format = hyscan_buffer_internal_get_format (src_type);
+  dst_format = hyscan_buffer_internal_get_format (type);
+  if ((src_format == NULL) || (dst_format == NULL))
+    return FALSE;
+
+  if (src_format->float_type != dst_format->float_type)
+    return FALSE;
+
+  n_points = size / hyscan_data_get_point_size (src_type);
+  size = n_points * hyscan_data_get_point_size (type);
+  hyscan_buffer_set (buffer, type, NULL, size);
+
+  hyscan_buffer_internal_transcode (dst_format, buffer->priv->data, src_format, data, n_points);
+
+  return TRUE;
+}
+
+/**
+ * hyscan_buffer_set:
+ * @buffer: указатель на #HyScanBuffer
+ * @type: тип данныx
+ * @data: (nullable) (array length=size) (element-type guint8) (transfer none): данные или NULL
+ * @size: размер данныx
+ *
+ * Функция записывает данные в буфер. При этом буфер переводится в режим
+ * динамического выделения памяти, если до этого он был сконфигурирован в
+ * режиме обёртки над внешними данными.
+ *
+ * Если data = NULL, изменяются только тип данных и размер.
+ *
+ * Returns: %TRUE если данные успешно записаны, иначе %FALSE.
+ *
+ */
+gboolean
+hyscan_buffer_set (HyScanBuffer   *buffer,
+                   HyScanDataType  type,
+                   gpointer        data,
+                   guint32         size)
+{
+  HyScanBufferPrivate *priv;
+
+  g_return_val_if_fail (HYSCAN_IS_BUFFER (buffer), FALSE);
+  g_return_val_if_fail (hyscan_data_get_id_by_type (type), FALSE);
+
+  priv = buffer->priv;
+
+  if (!priv->self_allocated)
+    {
+      hyscan_buffer_unmap_file (priv);
+      hyscan_buffer_clear_segments (priv);
+
+      priv->data = NULL;
+      priv->allocated_size = 0;
+      priv->size = 0;
+      priv->self_allocated = TRUE;
+      priv->view = FALSE;
+    }
+
+  hyscan_buffer_prepare (priv, size, FALSE);
+
+  priv->type = type;
+  priv->size = size;
+  if (data != NULL)
+    memcpy (priv->data, data, size);
+
+  return TRUE;
+}
+
+/**
+ * hyscan_buffer_wrap:
+ * @buffer: указатель на #HyScanBuffer
+ * @type: тип данныx
+ * @data: данные
+ * @size: размер данныx, в элементах определённого типа
+ *
+ * Функция конфигурирует буфер как обёртку над блоком данных.
+ *
+ * Данную функцию нельзя использовать через систему GIR, например в python-gi.
+ *
+ * Returns: %TRUE если буфер сконфигурирован, иначе %FALSE.
+ */
+gboolean
+hyscan_buffer_wrap (HyScanBuffer   *buffer,
+                    HyScanDataType  type,
+                    gpointer        data,
+                    guint32         size)
+{
+  HyScanBufferPrivate *priv;
+
+  g_return_val_if_fail (HYSCAN_IS_BUFFER (buffer), FALSE);
+  g_return_val_if_fail (hyscan_data_get_id_by_type (type), FALSE);
+
+  priv = buffer->priv;
+
+  if ((size > 0) && (data == NULL))
+    return FALSE;
+
+  hyscan_buffer_storage_unref (priv->storage);
+  hyscan_buffer_unmap_file (priv);
+  hyscan_buffer_clear_segments (priv);
+
+  priv->storage = NULL;
+  priv->self_allocated = FALSE;
+  priv->view = FALSE;
+  priv->allocated_size = priv->size = size;
+  priv->type = type;
+  priv->data = data;
+
+  return TRUE;
+}
+
+/**
+ * hyscan_buffer_wrap_segments:
+ * @buffer: указатель на #HyScanBuffer
+ * @type: тип данныx
+ * @segments: (array length=n_segments) (nullable): сегменты данных
+ * @n_segments: число сегментов
+ *
+ * Функция конфигурирует буфер как обёртку над списком блоков данных.
+ * Данные буфера образуются последовательным объединением сегментов.
+ * Точки данных могут быть разделены границей сегментов. Сегменты не
+ * копируются в буфер и должны оставаться доступными всё время его
+ * использования.
+ *
+ * Данную функцию нельзя использовать через систему GIR, например в python-gi.
+ *
+ * Returns: %TRUE если буфер сконфигурирован, иначе %FALSE.
+ */
+gboolean
+hyscan_buffer_wrap_segments (HyScanBuffer              *buffer,
+                             HyScanDataType             type,
+                             const HyScanBufferSegment *segments,
+                             guint                      n_segments)
+{
+  HyScanBufferPrivate *priv;
+  guint i;
+
+  g_return_val_if_fail (HYSCAN_IS_BUFFER (buffer), FALSE);
+
+  priv = buffer->priv;
+
+  if ((n_segments > 0) && (segments == NULL))
+    return FALSE;
+
+  if (!hyscan_buffer_wrap (buffer, type, NULL, 0))
+    return FALSE;
+
+  priv->segmented = TRUE;
+
+  for (i = 0; i < n_segments; i++)
+    {
+      if (!hyscan_buffer_append_segment (buffer, segments[i].data, segments[i].size))
+        {
+          hyscan_buffer_wrap (buffer, type, NULL, 0);
+          return FALSE;
+        }
+    }
+
+  return TRUE;
+}
+
+/**
+ * hyscan_buffer_append_segment:
+ * @buffer: указатель на #HyScanBuffer
+ * @data: данные сегмента
+ * @size: размер данныx сегмента
+ *
+ * Функция добавляет сегмент в конец данных буфера, сконфигурированного
+ * функцией #hyscan_buffer_wrap_segments.
+ *
+ * Returns: %TRUE если сегмент добавлен, иначе %FALSE.
+ */
+gboolean
+hyscan_buffer_append_segment (HyScanBuffer *buffer,
+                              gpointer      data,
+                              guint32       size)
+{
+  HyScanBufferPrivate *priv;
+
+  g_return_val_if_fail (HYSCAN_IS_BUFFER (buffer), FALSE);
+
+  priv = buffer->priv;
+
+  if (!priv->segmented || ((size > 0) && (data == NULL)))
+    return FALSE;
+
+  if (size > G_MAXUINT32 - priv->size)
+    return FALSE;
+
+  if (size == 0)
+    return TRUE;
+
+  if (priv->n_segments == priv->max_segments)
+    {
+      priv->max_segments = MAX (2 * priv->max_segments, 8);
+      priv->segments = g_renew (HyScanBufferSegment, priv->segments, priv->max_segments);
+    }
+
+  priv->segments[priv->n_segments].data = data;
+  priv->segments[priv->n_segments].size = size;
+  priv->n_segments += 1;
+
+  priv->allocated_size += size;
+  priv->size += size;
+
+  return TRUE;
+}
+
+/**
+ * hyscan_buffer_get_n_segments:
+ * @buffer: указатель на #HyScanBuffer
+ *
+ * Функция возвращает число сегментов данных буфера. Если буфер не является
+ * обёрткой над сегментами, функция возвращает 0.
+ *
+ * Returns: Число сегментов.
+ */
+guint
+hyscan_buffer_get_n_segments (HyScanBuffer *buffer)
+{
+  g_return_val_if_fail (HYSCAN_IS_BUFFER (buffer), 0);
+
+  return buffer->priv->segmented ? buffer->priv->n_segments : 0;
+}
+
+/**
+ * hyscan_buffer_map_file:
+ * @buffer: указатель на #HyScanBuffer
+ * @type: тип данныx
+ * @path: путь к файлу
+ * @offset: смещение данных в файле
+ * @size: размер данныx или 0
+ *
+ * Функция отображает в память область файла @path и конфигурирует буфер
+ * как обёртку над ней. Данные не копируются: они загружаются операционной
+ * системой из файла при обращении к ним, например при импорте. Если @size
+ * равен 0, отображается область от @offset до конца файла.
+ *
+ * Файл открывается только для чтения. Изменение данных в буфере не
+ * затрагивает файл. Область файла освобождается при удалении буфера или
+ * при изменении режима его работы.
+ *
+ * Returns: %TRUE если буфер сконфигурирован, иначе %FALSE.
+ */
+gboolean
+hyscan_buffer_map_file (HyScanBuffer   *buffer,
+                        HyScanDataType  type,
+                        const gchar    *path,
+                        goffset         offset,
+                        guint32         size)
+{
+  HyScanBufferPrivate *priv;
+  goffset file_size;
+  guint8 *data;
+
+#ifdef HYSCAN_BUFFER_MMAP
+  struct stat file_stat;
+  goffset map_offset;
+  gsize map_size;
+  gint fd;
+#else
+  GMappedFile *file;
+#endif
+
+  g_return_val_if_fail (HYSCAN_IS_BUFFER (buffer), FALSE);
+  g_return_val_if_fail (hyscan_data_get_id_by_type (type), FALSE);
+  g_return_val_if_fail (path != NULL, FALSE);
 
-  /* Тип данных: действительные или комплексные. */
-  switch (type)
-    {
-    case HYSCAN_DATA_FLOAT:
-    case HYSCAN_DATA_ADC14LE:
-    case HYSCAN_DATA_ADC16LE:
-    case HYSCAN_DATA_ADC24LE:
-    case HYSCAN_DATA_FLOAT16LE:
-    case HYSCAN_DATA_FLOAT32LE:
-    case HYSCAN_DATA_AMPLITUDE_INT8:
-    case HYSCAN_DATA_AMPLITUDE_INT16LE:
-    case HYSCAN_DATA_AMPLITUDE_INT24LE:
-    case HYSCAN_DATA_AMPLITUDE_INT32LE:
-    case HYSCAN_DATA_AMPLITUDE_FLOAT16LE:
-    case HYSCAN_DATA_AMPLITUDE_FLOAT32LE:
-      float_buffer = hyscan_buffer_get_float (buffer, &n_points);
-      if (float_buffer == NULL)
-        return FALSE;
-      break;
+  priv = buffer->priv;
 
-    case HYSCAN_DATA_COMPLEX_FLOAT:
-    case HYSCAN_DATA_COMPLEX_ADC14LE:
-    case HYSCAN_DATA_COMPLEX_ADC16LE:
-    case HYSCAN_DATA_COMPLEX_ADC24LE:
-    case HYSCAN_DATA_COMPLEX_FLOAT16LE:
-    case HYSCAN_DATA_COMPLEX_FLOAT32LE:
-      complex_float_buffer = hyscan_buffer_get_complex_float (buffer, &n_points);
-      if (complex_float_buffer == NULL)
-        return FALSE;
-      break;
+  if (offset < 0)
+    return FALSE;
 
-    case HYSCAN_DATA_DOA:
-    case HYSCAN_DATA_DOA_FLOAT32LE:
-      doa_buffer = hyscan_buffer_get_doa (buffer, &n_points);
-      if (doa_buffer == NULL)
-        return FALSE;
-      break;
+#ifdef HYSCAN_BUFFER_MMAP
+  fd = open (path, O_RDONLY);
+  if (fd < 0)
+    return FALSE;
 
-    default:
+  if (fstat (fd, &file_stat) != 0)
+    {
+      close (fd);
       return FALSE;
     }
 
-  /* Размер экспортируемых данных. */
-  size = n_points * hyscan_data_get_point_size (type);
-  hyscan_buffer_set (raw, type, NULL, size);
-  raw_data = hyscan_buffer_get (raw, &type, &size);
-  switch (type)
+  file_size = file_stat.st_size;
+#else
+  file = g_mapped_file_new (path, TRUE, NULL);
+  if (file == NULL)
+    return FALSE;
+
+  file_size = g_mapped_file_get_length (file);
+#endif
+
+  /* Проверка границ области. */
+  if ((offset > file_size) || ((size > 0) && (size > file_size - offset)))
+    goto fail;
+
+  if (size == 0)
+    size = MIN (file_size - offset, G_MAXUINT32);
+
+  if (size == 0)
     {
-    case HYSCAN_DATA_FLOAT:
-      {
-        memcpy (raw_data, float_buffer, size);
-      }
-      break;
+#ifdef HYSCAN_BUFFER_MMAP
+      close (fd);
+#else
+      g_mapped_file_unref (file);
+#endif
+      return hyscan_buffer_wrap (buffer, type, NULL, 0);
+    }
 
-    case HYSCAN_DATA_ADC14LE:
-      {
-        guint16 *raw_data16 = (guint16*)raw_data;
-        for (i = 0; i < n_points; i++)
-          *raw_data16++ = hyscan_buffer_encode_adc_14le (float_buffer[i]);
-      }
-      break;
+#ifdef HYSCAN_BUFFER_MMAP
+  /* Смещение отображаемой области должно быть кратно размеру страницы. */
+  map_offset = offset - offset % sysconf (_SC_PAGESIZE);
+  map_size = size + (offset - map_offset);
 
-    case HYSCAN_DATA_ADC16LE:
-      {
-        guint16 *raw_data16 = (guint16*)raw_data;
-        for (i = 0; i < n_points; i++)
-          *raw_data16++ = hyscan_buffer_encode_adc_16le (float_buffer[i]);
-      }
-      break;
+  data = mmap (NULL, map_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, map_offset);
+  close (fd);
+  if (data == MAP_FAILED)
+    return FALSE;
 
-    case HYSCAN_DATA_ADC24LE:
-      {
-        guint32 *raw_data32 = (guint32*)raw_data;
-        for (i = 0; i < n_points; i++)
-          *raw_data32++ = hyscan_buffer_encode_adc_24le (float_buffer[i]);
-      }
-      break;
+  hyscan_buffer_wrap (buffer, type, data + (offset - map_offset), size);
 
-    case HYSCAN_DATA_AMPLITUDE_INT8:
-      {
-        for (i = 0; i < n_points; i++)
-          *raw_data++ = hyscan_buffer_encode_int8 (float_buffer[i]);
-      }
-      break;
+  priv->file = g_slice_new (HyScanBufferFile);
+  priv->file->ref_count = 1;
+  priv->file->data = data;
+  priv->file->size = map_size;
+#else
+  data = (guint8*)g_mapped_file_get_contents (file);
+  hyscan_buffer_wrap (buffer, type, data + offset, size);
 
-    case HYSCAN_DATA_AMPLITUDE_INT16LE:
-      {
-        guint16 *raw_data16 = (guint16*)raw_data;
-        for (i = 0; i < n_points; i++)
-          *raw_data16++ = hyscan_buffer_encode_int16le (float_buffer[i]);
-      }
-      break;
+  priv->file = file;
+#endif
 
-    case HYSCAN_DATA_AMPLITUDE_INT24LE:
-      {
-        guint32 *raw_data32 = (guint32*)raw_data;
-        for (i = 0; i < n_points; i++)
-          *raw_data32++ = hyscan_buffer_encode_int24le (float_buffer[i]);
-      }
-      break;
+  return TRUE;
 
-    case HYSCAN_DATA_AMPLITUDE_INT32LE:
-      {
-        guint32 *raw_data32 = (guint32*)raw_data;
-        for (i = 0; i < n_points; i++)
-          *raw_data32++ = hyscan_buffer_encode_int32le (float_buffer[i]);
-      }
-      break;
+fail:
+#ifdef HYSCAN_BUFFER_MMAP
+  close (fd);
+#else
+  g_mapped_file_unref (file);
+#endif
 
-    case HYSCAN_DATA_FLOAT16LE:
-    case HYSCAN_DATA_AMPLITUDE_FLOAT16LE:
-      {
-        guint16 *raw_data16 = (guint16*)raw_data;
-        for (i = 0; i < n_points; i++)
-          *raw_data16++ = hyscan_buffer_encode_float16le (float_buffer[i]);
-      }
-      break;
+  return FALSE;
+}
 
-    case HYSCAN_DATA_FLOAT32LE:
-    case HYSCAN_DATA_AMPLITUDE_FLOAT32LE:
-      {
-        guint32 *raw_data32 = (guint32*)raw_data;
-        for (i = 0; i < n_points; i++)
-          *raw_data32++ = hyscan_buffer_encode_float32le (float_buffer[i]);
-      }
-      break;
+/**
+ * hyscan_buffer_get:
+ * @buffer: указатель на #HyScanBuffer
+ * @type: (out) (nullable): тип данныx или NULL
+ * @size: (out): размер данныx
+ *
+ * Функция возвращает указатель на данные в буфере. Пользователь может
+ * изменять эти данные в пределах их размера. Если данные используются
+ * совместно с копиями буфера, для него создаётся собственная копия данных.
+ * Данные буфера, являющегося обёрткой над сегментами, собираются в память
+ * буфера.
+ *
+ * Returns: (nullable) (array length=size) (element-type guint8) (transfer none): Данные или NULL.
+ */
+gpointer
+hyscan_buffer_get (HyScanBuffer   *buffer,
+                   HyScanDataType *type,
+                   guint32        *size)
+{
+  HyScanBufferPrivate *priv;
 
-    case HYSCAN_DATA_COMPLEX_FLOAT:
-      {
-        memcpy (raw_data, complex_float_buffer, size);
-      }
-      break;
+  g_return_val_if_fail (HYSCAN_IS_BUFFER (buffer), NULL);
 
-    case HYSCAN_DATA_COMPLEX_ADC14LE:
-      {
-        guint16 *raw_data16 = (guint16*)raw_data;
-        for (i = 0; i < n_points; i++)
-          {
-            *raw_data16++ = hyscan_buffer_encode_adc_14le (complex_float_buffer[i].re);
-            *raw_data16++ = hyscan_buffer_encode_adc_14le (complex_float_buffer[i].im);
-          }
-      }
-      break;
+  priv = buffer->priv;
 
-    case HYSCAN_DATA_COMPLEX_ADC16LE:
-      {
-        guint16 *raw_data16 = (guint16*)raw_data;
-        for (i = 0; i < n_points; i++)
-          {
-            *raw_data16++ = hyscan_buffer_encode_adc_16le (complex_float_buffer[i].re);
-            *raw_data16++ = hyscan_buffer_encode_adc_16le (complex_float_buffer[i].im);
-          }
-      }
-      break;
+  if ((priv->storage != NULL) || priv->segmented || priv->view)
+    hyscan_buffer_prepare (priv, priv->size, TRUE);
 
-    case HYSCAN_DATA_COMPLEX_ADC24LE:
-      {
-        guint32 *raw_data32 = (guint32*)raw_data;
-        for (i = 0; i < n_points; i++)
-          {
-            *raw_data32++ = hyscan_buffer_encode_adc_24le (complex_float_buffer[i].re);
-            *raw_data32++ = hyscan_buffer_encode_adc_24le (complex_float_buffer[i].im);
-          }
-      }
-      break;
+  (type != NULL) ? *type = priv->type : 0;
+  *size = priv->size;
 
-    case HYSCAN_DATA_COMPLEX_FLOAT16LE:
-      {
-        guint16 *raw_data16 = (guint16*)raw_data;
-        for (i = 0; i < n_points; i++)
-          {
-            *raw_data16++ = hyscan_buffer_encode_float16le (complex_float_buffer[i].re);
-            *raw_data16++ = hyscan_buffer_encode_float16le (complex_float_buffer[i].im);
-          }
-      }
-      break;
+  return priv->data;
+}
 
-    case HYSCAN_DATA_COMPLEX_FLOAT32LE:
-      {
-        guint32 *raw_data32 = (guint32*)raw_data;
-        for (i = 0; i < n_points; i++)
-          {
-            *raw_data32++ = hyscan_buffer_encode_float32le (complex_float_buffer[i].re);
-            *raw_data32++ = hyscan_buffer_encode_float32le (complex_float_buffer[i].im);
-          }
-      }
-      break;
+/**
+ * hyscan_buffer_peek:
+ * @buffer: указатель на #HyScanBuffer
+ * @type: (out) (nullable): тип данныx или NULL
+ * @size: (out): размер данныx
+ *
+ * Функция возвращает указатель на данные в буфере только для чтения.
+ * В отличие от #hyscan_buffer_get, данные, используемые совместно с копиями
+ * буфера, не копируются. Данные буфера, являющегося обёрткой над сегментами,
+ * собираются в память буфера.
+ *
+ * Returns: (nullable) (array length=size) (element-type guint8) (transfer none): Данные или NULL.
+ */
+gconstpointer
+hyscan_buffer_peek (HyScanBuffer   *buffer,
+                    HyScanDataType *type,
+                    guint32        *size)
+{
+  HyScanBufferPrivate *priv;
 
-    case HYSCAN_DATA_DOA:
-      {
-        memcpy (raw_data, doa_buffer, size);
-      }
-      break;
+  g_return_val_if_fail (HYSCAN_IS_BUFFER (buffer), NULL);
 
-    case HYSCAN_DATA_DOA_FLOAT32LE:
-      {
-        guint32 *raw_data32 = (guint32*)raw_data;
-        for (i = 0; i < n_points; i++)
-          {
-            *raw_data32++ = hyscan_buffer_encode_float32le (doa_buffer[i].angle);
-            *raw_data32++ = hyscan_buffer_encode_float32le (doa_buffer[i].distance);
-            *raw_data32++ = hyscan_buffer_encode_float32le (doa_buffer[i].amplitude);
-          }
-      }
-      break;
+  priv = buffer->priv;
 
-    default:
-      return FALSE;
-    }
+  hyscan_buffer_gather (priv);
 
-  return TRUE;
+  (type != NULL) ? *type = priv->type : 0;
+  *size = priv->size;
+
+  return priv->data;
 }
 
 /**
- * hyscan_buffer_set:
+ * hyscan_buffer_set_growth:
  * @buffer: указатель на #HyScanBuffer
- * @type: тип данныx
- * @data: (nullable) (array length=size) (element-type guint8) (transfer none): данные или NULL
- * @size: размер данныx
+ * @growth: политика увеличения памяти #HyScanBufferGrowth
  *
- * Функция записывает данные в буфер. При этом буфер переводится в режим
- * динамического выделения памяти, если до этого он был сконфигурирован в
- * режиме обёртки над внешними данными.
+ * Функция задаёт политику увеличения памяти буфера. По умолчанию
+ * используется #HYSCAN_BUFFER_GROWTH_EXACT.
+ */
+void
+hyscan_buffer_set_growth (HyScanBuffer       *buffer,
+                          HyScanBufferGrowth  growth)
+{
+  g_return_if_fail (HYSCAN_IS_BUFFER (buffer));
+
+  buffer->priv->growth = growth;
+}
+
+/**
+ * hyscan_buffer_get_growth:
+ * @buffer: указатель на #HyScanBuffer
  *
- * Если data = NULL, изменяются только тип данных и размер.
+ * Функция возвращает политику увеличения памяти буфера.
  *
- * Returns: %TRUE если данные успешно записаны, иначе %FALSE.
+ * Returns: Политика увеличения памяти #HyScanBufferGrowth.
+ */
+HyScanBufferGrowth
+hyscan_buffer_get_growth (HyScanBuffer *buffer)
+{
+  g_return_val_if_fail (HYSCAN_IS_BUFFER (buffer), HYSCAN_BUFFER_GROWTH_EXACT);
+
+  return buffer->priv->growth;
+}
+
+/**
+ * hyscan_buffer_reserve:
+ * @buffer: указатель на #HyScanBuffer
+ * @size: размер памяти
+ *
+ * Функция выделяет память для данных размером не менее @size байт, не
+ * затрагивая их содержимое. Последующее увеличение размера данных до @size
+ * не требует выделения памяти. Если буфер находится в режиме обёртки над
+ * внешними данными и их размер меньше @size, функция завершается с ошибкой.
  *
+ * Returns: %TRUE если память выделена, иначе %FALSE.
  */
 gboolean
-hyscan_buffer_set (HyScanBuffer   *buffer,
-                   HyScanDataType  type,
-                   gpointer        data,
-                   guint32         size)
+hyscan_buffer_reserve (HyScanBuffer *buffer,
+                       guint32       size)
 {
   HyScanBufferPrivate *priv;
+  HyScanBufferGrowth growth;
+  gboolean status;
 
   g_return_val_if_fail (HYSCAN_IS_BUFFER (buffer), FALSE);
-  g_return_val_if_fail (hyscan_data_get_id_by_type (type), FALSE);
 
   priv = buffer->priv;
 
-  if (!priv->self_allocated)
+  /* Запрошенный размер выделяется точно. */
+  growth = priv->growth;
+  priv->growth = HYSCAN_BUFFER_GROWTH_EXACT;
+  status = hyscan_buffer_prepare (priv, size, TRUE);
+  priv->growth = growth;
+
+  return status;
+}
+
+/**
+ * hyscan_buffer_shrink_to_fit:
+ * @buffer: указатель на #HyScanBuffer
+ *
+ * Функция уменьшает память буфера до размера данных. Память, используемая
+ * совместно с копиями буфера, и внешние данные не изменяются.
+ */
+void
+hyscan_buffer_shrink_to_fit (HyScanBuffer *buffer)
+{
+  HyScanBufferPrivate *priv;
+  HyScanBufferStorage *storage;
+
+  g_return_if_fail (HYSCAN_IS_BUFFER (buffer));
+
+  priv = buffer->priv;
+  storage = priv->storage;
+
+  if ((storage == NULL) || (g_atomic_int_get (&storage->ref_count) > 1))
+    return;
+
+  if (priv->allocated_size == priv->size)
+    return;
+
+  if (priv->size > 0)
     {
-      priv->data = NULL;
-      priv->allocated_size = 0;
-      priv->self_allocated = TRUE;
+      hyscan_buffer_storage_resize (priv, storage, priv->size, priv->size);
     }
-
-  if (priv->allocated_size < size)
+  else
     {
-      priv->data = g_realloc (priv->data, size);
-      priv->allocated_size = size;
+      hyscan_buffer_storage_free (storage);
+      storage->data = NULL;
+      storage->mapped_size = 0;
+      priv->allocated_size = 0;
     }
 
-  priv->type = type;
-  priv->size = size;
-  if (data != NULL)
-    memcpy (priv->data, data, size);
+  priv->data = storage->data;
+}
 
-  return TRUE;
+/**
+ * hyscan_buffer_get_capacity:
+ * @buffer: указатель на #HyScanBuffer
+ *
+ * Функция возвращает размер памяти буфера, т.е. максимальный размер данных,
+ * не требующий выделения памяти.
+ *
+ * Returns: Размер памяти буфера.
+ */
+guint32
+hyscan_buffer_get_capacity (HyScanBuffer *buffer)
+{
+  g_return_val_if_fail (HYSCAN_IS_BUFFER (buffer), 0);
+
+  return buffer->priv->allocated_size;
 }
 
 /**
- * hyscan_buffer_wrap:
+ * hyscan_buffer_get_n_allocations:
  * @buffer: указатель на #HyScanBuffer
- * @type: тип данныx
- * @data: данные
- * @size: размер данныx, в элементах определённого типа
  *
- * Функция конфигурирует буфер как обёртку над блоком данных.
+ * Функция возвращает число выделений памяти для данных, выполненных буфером
+ * с момента его создания. Значение не изменяется, если размер данных не
+ * превышает размер памяти буфера.
  *
- * Данную функцию нельзя использовать через систему GIR, например в python-gi.
+ * Returns: Число выделений памяти.
+ */
+guint
+hyscan_buffer_get_n_allocations (HyScanBuffer *buffer)
+{
+  g_return_val_if_fail (HYSCAN_IS_BUFFER (buffer), 0);
+
+  return buffer->priv->n_allocations;
+}
+
+/**
+ * hyscan_buffer_set_mmap_threshold:
+ * @size: размер данных или 0
  *
- * Returns: %TRUE если буфер сконфигурирован, иначе %FALSE.
+ * Функция задаёт размер данных, начиная с которого память для них
+ * выделяется с помощью mmap, для всех объектов #HyScanBuffer. Такая память
+ * выделяется с точностью до 2 Мб. Если @size равен 0, mmap не используется.
+ * По умолчанию порог равен 64 Мб. На платформах без mmap функция ни на что
+ * не влияет.
+ */
+void
+hyscan_buffer_set_mmap_threshold (guint32 size)
+{
+  g_atomic_int_set (&hyscan_buffer_mmap_threshold, size);
+}
+
+/**
+ * hyscan_buffer_get_mmap_threshold:
+ *
+ * Функция возвращает размер данных, начиная с которого память для них
+ * выделяется с помощью mmap.
+ *
+ * Returns: Размер данных или 0.
+ */
+guint32
+hyscan_buffer_get_mmap_threshold (void)
+{
+  return (guint32)g_atomic_int_get (&hyscan_buffer_mmap_threshold);
+}
+
+/**
+ * hyscan_buffer_is_mapped:
+ * @buffer: указатель на #HyScanBuffer
+ *
+ * Функция проверяет, размещены ли данные буфера в памяти, выделенной
+ * с помощью mmap.
+ *
+ * Returns: %TRUE если данные размещены в памяти mmap, иначе %FALSE.
  */
 gboolean
-hyscan_buffer_wrap (HyScanBuffer   *buffer,
-                    HyScanDataType  type,
-                    gpointer        data,
-                    guint32         size)
+hyscan_buffer_is_mapped (HyScanBuffer *buffer)
 {
   HyScanBufferPrivate *priv;
 
   g_return_val_if_fail (HYSCAN_IS_BUFFER (buffer), FALSE);
-  g_return_val_if_fail (hyscan_data_get_id_by_type (type), FALSE);
 
   priv = buffer->priv;
 
-  if ((size > 0) && (data == NULL))
-    return FALSE;
-
-  if (priv->self_allocated)
-    g_free (priv->data);
-
-  priv->self_allocated = FALSE;
-  priv->allocated_size = priv->size = size;
-  priv->type = type;
-  priv->data = data;
-
-  return TRUE;
+  return priv->self_allocated && (priv->storage != NULL) && (priv->storage->mapped_size > 0);
 }
 
 /**
- * hyscan_buffer_get:
+ * hyscan_buffer_get_alignment:
  * @buffer: указатель на #HyScanBuffer
- * @type: (out) (nullable): тип данныx или NULL
- * @size: (out): размер данныx
  *
- * Функция возвращает указатель на данные в буфере. Пользователь может
- * изменять эти данные в пределах их размера.
+ * Функция возвращает выравнивание данных в буфере. Для памяти, выделенной
+ * буфером, оно равно #HYSCAN_BUFFER_ALIGNMENT. В режиме обёртки над внешними
+ * данными возвращается фактическое выравнивание данных, но не более
+ * #HYSCAN_BUFFER_ALIGNMENT. Для обёртки над сегментами возвращается
+ * наименьшее выравнивание сегментов.
  *
- * Returns: (nullable) (array length=size) (element-type guint8) (transfer none): Данные или NULL.
+ * Returns: Выравнивание данных в байтах.
  */
-gpointer
-hyscan_buffer_get (HyScanBuffer   *buffer,
-                   HyScanDataType *type,
-                   guint32        *size)
+guint
+hyscan_buffer_get_alignment (HyScanBuffer *buffer)
 {
   HyScanBufferPrivate *priv;
+  gsize address;
+  guint i;
 
-  g_return_val_if_fail (HYSCAN_IS_BUFFER (buffer), NULL);
+  g_return_val_if_fail (HYSCAN_IS_BUFFER (buffer), 0);
 
   priv = buffer->priv;
 
-  (type != NULL) ? *type = priv->type : 0;
-  *size = priv->size;
+  if (priv->self_allocated)
+    return HYSCAN_BUFFER_ALIGNMENT;
 
-  return priv->data;
+  address = GPOINTER_TO_SIZE (priv->data) | HYSCAN_BUFFER_ALIGNMENT;
+  for (i = 0; priv->segmented && (i < priv->n_segments); i++)
+    address |= GPOINTER_TO_SIZE (priv->segments[i].data);
+
+  return address & (~address + 1);
 }
 
 /**
@@ -1101,18 +2426,8 @@ hyscan_buffer_set_data_size (HyScanBuffer *buffer,
 
   priv = buffer->priv;
 
-  if (priv->allocated_size < size)
-    {
-      if (priv->self_allocated)
-        {
-          priv->data = g_realloc (priv->data, size);
-          priv->allocated_size = size;
-        }
-      else
-        {
-          return FALSE;
-        }
-    }
+  if (!hyscan_buffer_prepare (priv, size, TRUE))
+    return FALSE;
 
   priv->size = size;
 
@@ -1282,6 +2597,33 @@ hyscan_buffer_get_complex_float (HyScanBuffer *buffer,
   return data;
 }
 
+/**
+ * hyscan_buffer_get_complex_planar:
+ * @buffer: указатель на #HyScanBuffer
+ * @re: указатель на #HyScanBuffer для действительной части
+ * @im: указатель на #HyScanBuffer для мнимой части
+ *
+ * Функция записывает действительные и мнимые части массива
+ * #HyScanComplexFloat из буфера в отдельные массивы gfloat в буферах @re
+ * и @im.
+ *
+ * Returns: %TRUE если данные успешно записаны, иначе %FALSE.
+ */
+gboolean
+hyscan_buffer_get_complex_planar (HyScanBuffer *buffer,
+                                  HyScanBuffer *re,
+                                  HyScanBuffer *im)
+{
+  HyScanBuffer *planes[2] = { re, im };
+
+  g_return_val_if_fail (HYSCAN_IS_BUFFER (buffer), FALSE);
+
+  if (buffer->priv->type != HYSCAN_DATA_COMPLEX_FLOAT)
+    return FALSE;
+
+  return hyscan_buffer_import_planar (buffer, HYSCAN_DATA_COMPLEX_FLOAT, planes, 2);
+}
+
 /**
  * hyscan_buffer_set_doa:
  * @buffer: указатель на #HyScanBuffer
@@ -1354,3 +2696,31 @@ hyscan_buffer_get_doa (HyScanBuffer *buffer,
 
   return data;
 }
+
+/**
+ * hyscan_buffer_get_doa_planar:
+ * @buffer: указатель на #HyScanBuffer
+ * @angle: указатель на #HyScanBuffer для углов прихода
+ * @distance: указатель на #HyScanBuffer для дальностей
+ * @amplitude: указатель на #HyScanBuffer для амплитуд
+ *
+ * Функция записывает компоненты массива #HyScanDOA из буфера в отдельные
+ * массивы gfloat в буферах @angle, @distance и @amplitude.
+ *
+ * Returns: %TRUE если данные успешно записаны, иначе %FALSE.
+ */
+gboolean
+hyscan_buffer_get_doa_planar (HyScanBuffer *buffer,
+                              HyScanBuffer *angle,
+                              HyScanBuffer *distance,
+                              HyScanBuffer *amplitude)
+{
+  HyScanBuffer *planes[3] = { angle, distance, amplitude };
+
+  g_return_val_if_fail (HYSCAN_IS_BUFFER (buffer), FALSE);
+
+  if (buffer->priv->type != HYSCAN_DATA_DOA)
+    return FALSE;
+
+  return hyscan_buffer_import_planar (buffer, HYSCAN_DATA_DOA, planes, 3);
+}
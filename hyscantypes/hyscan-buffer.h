@@ -40,6 +40,122 @@
 
 G_BEGIN_DECLS
 
+/**
+ * HyScanBufferSimd:
+ * @HYSCAN_BUFFER_SIMD_NONE: скалярные функции преобразования
+ * @HYSCAN_BUFFER_SIMD_SSE2: векторные функции SSE2
+ * @HYSCAN_BUFFER_SIMD_AVX2: векторные функции AVX2
+ * @HYSCAN_BUFFER_SIMD_NEON: векторные функции NEON
+ * @HYSCAN_BUFFER_SIMD_F16C: векторные функции AVX2 и аппаратное преобразование float16 (F16C)
+ *
+ * Наборы инструкций, используемые при преобразовании данных.
+ */
+typedef enum
+{
+  HYSCAN_BUFFER_SIMD_NONE,
+  HYSCAN_BUFFER_SIMD_SSE2,
+  HYSCAN_BUFFER_SIMD_AVX2,
+  HYSCAN_BUFFER_SIMD_NEON,
+  HYSCAN_BUFFER_SIMD_F16C
+} HyScanBufferSimd;
+
+/**
+ * HyScanBufferOpType:
+ * @HYSCAN_BUFFER_OP_SCALE: умножение на значение
+ * @HYSCAN_BUFFER_OP_OFFSET: прибавление значения
+ * @HYSCAN_BUFFER_OP_AMPLITUDE: вычисление модуля, для комплексных данных - амплитуды
+ * @HYSCAN_BUFFER_OP_DB: умножение десятичного логарифма на значение
+ *
+ * Операции над отдельными значениями, выполняемые при импорте данных.
+ */
+typedef enum
+{
+  HYSCAN_BUFFER_OP_SCALE,
+  HYSCAN_BUFFER_OP_OFFSET,
+  HYSCAN_BUFFER_OP_AMPLITUDE,
+  HYSCAN_BUFFER_OP_DB
+} HyScanBufferOpType;
+
+/**
+ * HyScanBufferOp:
+ * @type: тип операции #HyScanBufferOpType
+ * @value: параметр операции
+ *
+ * Операция над отдельными значениями, выполняемая при импорте данных.
+ * Для операции #HYSCAN_BUFFER_OP_DB параметр равен 20 для амплитуды
+ * и 10 для мощности. Для операции #HYSCAN_BUFFER_OP_AMPLITUDE параметр
+ * не используется.
+ */
+typedef struct
+{
+  HyScanBufferOpType           type;
+  gfloat                       value;
+} HyScanBufferOp;
+
+/**
+ * HyScanBufferDecimation:
+ * @HYSCAN_BUFFER_DECIMATION_STRIDE: первая точка каждой группы
+ * @HYSCAN_BUFFER_DECIMATION_MAX: точка с максимальным значением (амплитудой)
+ * @HYSCAN_BUFFER_DECIMATION_MEAN: среднее значение точек группы
+ *
+ * Способы прореживания данных при импорте.
+ */
+typedef enum
+{
+  HYSCAN_BUFFER_DECIMATION_STRIDE,
+  HYSCAN_BUFFER_DECIMATION_MAX,
+  HYSCAN_BUFFER_DECIMATION_MEAN
+} HyScanBufferDecimation;
+
+/**
+ * HyScanBufferGrowth:
+ * @HYSCAN_BUFFER_GROWTH_EXACT: память выделяется точно по размеру данных
+ * @HYSCAN_BUFFER_GROWTH_GEOMETRIC: размер памяти увеличивается не менее чем в 1,5 раза
+ * @HYSCAN_BUFFER_GROWTH_POWER_OF_TWO: размер памяти округляется до степени двойки
+ *
+ * Политики увеличения памяти буфера.
+ */
+typedef enum
+{
+  HYSCAN_BUFFER_GROWTH_EXACT,
+  HYSCAN_BUFFER_GROWTH_GEOMETRIC,
+  HYSCAN_BUFFER_GROWTH_POWER_OF_TWO
+} HyScanBufferGrowth;
+
+/**
+ * HyScanBufferLayout:
+ * @HYSCAN_BUFFER_LAYOUT_ROW_MAJOR: строки данных расположены последовательно
+ * @HYSCAN_BUFFER_LAYOUT_COLUMN_MAJOR: строки данных являются столбцами матрицы
+ *
+ * Расположение строк данных в матрице.
+ */
+typedef enum
+{
+  HYSCAN_BUFFER_LAYOUT_ROW_MAJOR,
+  HYSCAN_BUFFER_LAYOUT_COLUMN_MAJOR
+} HyScanBufferLayout;
+
+/**
+ * HyScanBufferSegment:
+ * @data: данные сегмента
+ * @size: размер данных сегмента
+ *
+ * Сегмент данных буфера, составленного из нескольких блоков памяти.
+ */
+typedef struct
+{
+  gpointer                     data;
+  guint32                      size;
+} HyScanBufferSegment;
+
+/**
+ * HYSCAN_BUFFER_ALIGNMENT:
+ *
+ * Выравнивание памяти, выделяемой #HyScanBuffer для данных, в байтах.
+ * Соответствует размеру строки кэша и регистра AVX-512.
+ */
+#define HYSCAN_BUFFER_ALIGNMENT        64
+
 #define HYSCAN_TYPE_BUFFER             (hyscan_buffer_get_type ())
 #define HYSCAN_BUFFER(obj)             (G_TYPE_CHECK_INSTANCE_CAST ((obj), HYSCAN_TYPE_BUFFER, HyScanBuffer))
 #define HYSCAN_IS_BUFFER(obj)          (G_TYPE_CHECK_INSTANCE_TYPE ((obj), HYSCAN_TYPE_BUFFER))
@@ -69,6 +185,12 @@ GType                  hyscan_buffer_get_type           (void);
 HYSCAN_API
 HyScanBuffer *         hyscan_buffer_new                (void);
 
+HYSCAN_API
+gboolean               hyscan_buffer_set_simd           (HyScanBufferSimd       simd);
+
+HYSCAN_API
+HyScanBufferSimd       hyscan_buffer_get_simd           (void);
+
 HYSCAN_API
 void                   hyscan_buffer_copy               (HyScanBuffer          *buffer,
                                                          HyScanBuffer          *orig);
@@ -77,11 +199,90 @@ HYSCAN_API
 gboolean               hyscan_buffer_import             (HyScanBuffer          *buffer,
                                                          HyScanBuffer          *raw);
 
+HYSCAN_API
+gboolean               hyscan_buffer_import_parallel    (HyScanBuffer          *buffer,
+                                                         HyScanBuffer          *raw,
+                                                         guint                  n_threads);
+
+HYSCAN_API
+gboolean               hyscan_buffer_import_view        (HyScanBuffer          *buffer,
+                                                         HyScanBuffer          *raw,
+                                                         gboolean              *view);
+
+HYSCAN_API
+gboolean               hyscan_buffer_import_in_place    (HyScanBuffer          *buffer);
+
+HYSCAN_API
+gboolean               hyscan_buffer_export_in_place    (HyScanBuffer          *buffer,
+                                                         HyScanDataType         type);
+
+HYSCAN_API
+gboolean               hyscan_buffer_import_range       (HyScanBuffer          *buffer,
+                                                         HyScanBuffer          *raw,
+                                                         guint32                offset,
+                                                         guint32                n_points);
+
+HYSCAN_API
+gboolean               hyscan_buffer_import_decimated   (HyScanBuffer          *buffer,
+                                                         HyScanBuffer          *raw,
+                                                         guint32                factor,
+                                                         HyScanBufferDecimation decimation);
+
+HYSCAN_API
+gboolean               hyscan_buffer_import_transform   (HyScanBuffer          *buffer,
+                                                         HyScanBuffer          *raw,
+                                                         const HyScanBufferOp  *ops,
+                                                         guint                  n_ops);
+
+HYSCAN_API
+gboolean               hyscan_buffer_import_amplitude   (HyScanBuffer          *buffer,
+                                                         HyScanBuffer          *raw);
+
+HYSCAN_API
+gboolean               hyscan_buffer_import_batch       (HyScanBuffer          *buffer,
+                                                         HyScanBuffer         **raws,
+                                                         guint                  n_raws,
+                                                         guint32                n_points,
+                                                         guint32                stride,
+                                                         HyScanBufferLayout     layout,
+                                                         guint                  n_threads);
+
+HYSCAN_API
+gboolean               hyscan_buffer_import_complex_planar
+                                                        (HyScanBuffer          *re,
+                                                         HyScanBuffer          *im,
+                                                         HyScanBuffer          *raw);
+
+HYSCAN_API
+gboolean               hyscan_buffer_import_doa_planar  (HyScanBuffer          *angle,
+                                                         HyScanBuffer          *distance,
+                                                         HyScanBuffer          *amplitude,
+                                                         HyScanBuffer          *raw);
+
 HYSCAN_API
 gboolean               hyscan_buffer_export             (HyScanBuffer          *buffer,
                                                          HyScanBuffer          *raw,
                                                          HyScanDataType         type);
 
+HYSCAN_API
+gboolean               hyscan_buffer_export_parallel    (HyScanBuffer          *buffer,
+                                                         HyScanBuffer          *raw,
+                                                         HyScanDataType         type,
+                                                         guint                  n_threads);
+
+HYSCAN_API
+void                   hyscan_buffer_set_parallel_threshold
+                                                        (guint32                n_points);
+
+HYSCAN_API
+guint32                hyscan_buffer_get_parallel_threshold
+                                                        (void);
+
+HYSCAN_API
+gboolean               hyscan_buffer_transcode          (HyScanBuffer          *buffer,
+                                                         HyScanBuffer          *raw,
+                                                         HyScanDataType         type);
+
 HYSCAN_API
 gboolean               hyscan_buffer_set                (HyScanBuffer          *buffer,
                                                          HyScanDataType         type,
@@ -94,11 +295,69 @@ gboolean               hyscan_buffer_wrap               (HyScanBuffer          *
                                                          gpointer               data,
                                                          guint32                size);
 
+HYSCAN_API
+gboolean               hyscan_buffer_wrap_segments      (HyScanBuffer          *buffer,
+                                                         HyScanDataType         type,
+                                                         const HyScanBufferSegment *segments,
+                                                         guint                  n_segments);
+
+HYSCAN_API
+gboolean               hyscan_buffer_append_segment     (HyScanBuffer          *buffer,
+                                                         gpointer               data,
+                                                         guint32                size);
+
+HYSCAN_API
+guint                  hyscan_buffer_get_n_segments     (HyScanBuffer          *buffer);
+
+HYSCAN_API
+gboolean               hyscan_buffer_map_file           (HyScanBuffer          *buffer,
+                                                         HyScanDataType         type,
+                                                         const gchar           *path,
+                                                         goffset                offset,
+                                                         guint32                size);
+
 HYSCAN_API
 gpointer               hyscan_buffer_get                (HyScanBuffer          *buffer,
                                                          HyScanDataType        *type,
                                                          guint32               *size);
 
+HYSCAN_API
+gconstpointer          hyscan_buffer_peek               (HyScanBuffer          *buffer,
+                                                         HyScanDataType        *type,
+                                                         guint32               *size);
+
+HYSCAN_API
+void                   hyscan_buffer_set_growth         (HyScanBuffer          *buffer,
+                                                         HyScanBufferGrowth     growth);
+
+HYSCAN_API
+HyScanBufferGrowth     hyscan_buffer_get_growth         (HyScanBuffer          *buffer);
+
+HYSCAN_API
+gboolean               hyscan_buffer_reserve            (HyScanBuffer          *buffer,
+                                                         guint32                size);
+
+HYSCAN_API
+void                   hyscan_buffer_shrink_to_fit      (HyScanBuffer          *buffer);
+
+HYSCAN_API
+guint32                hyscan_buffer_get_capacity       (HyScanBuffer          *buffer);
+
+HYSCAN_API
+guint                  hyscan_buffer_get_n_allocations  (HyScanBuffer          *buffer);
+
+HYSCAN_API
+void                   hyscan_buffer_set_mmap_threshold (guint32                size);
+
+HYSCAN_API
+guint32                hyscan_buffer_get_mmap_threshold (void);
+
+HYSCAN_API
+gboolean               hyscan_buffer_is_mapped          (HyScanBuffer          *buffer);
+
+HYSCAN_API
+guint                  hyscan_buffer_get_alignment      (HyScanBuffer          *buffer);
+
 HYSCAN_API
 gboolean               hyscan_buffer_set_data_type      (HyScanBuffer          *buffer,
                                                          HyScanDataType         type);
@@ -141,6 +400,11 @@ HYSCAN_API
 HyScanComplexFloat *   hyscan_buffer_get_complex_float  (HyScanBuffer          *buffer,
                                                          guint32               *n_points);
 
+HYSCAN_API
+gboolean               hyscan_buffer_get_complex_planar (HyScanBuffer          *buffer,
+                                                         HyScanBuffer          *re,
+                                                         HyScanBuffer          *im);
+
 HYSCAN_API
 gboolean               hyscan_buffer_set_doa            (HyScanBuffer          *buffer,
                                                          HyScanDOA             *data,
@@ -155,6 +419,12 @@ HYSCAN_API
 HyScanDOA *            hyscan_buffer_get_doa            (HyScanBuffer          *buffer,
                                                          guint32               *n_points);
 
+HYSCAN_API
+gboolean               hyscan_buffer_get_doa_planar     (HyScanBuffer          *buffer,
+                                                         HyScanBuffer          *angle,
+                                                         HyScanBuffer          *distance,
+                                                         HyScanBuffer          *amplitude);
+
 G_END_DECLS
 
 #endif /* __HYSCAN_BUFFER_H__ */
@@ -210,6 +210,25 @@ static HyScanDataTypeInfo hyscan_data_types_info[] =
   { 0, "doa-float32le",        HYSCAN_DATA_DOA_FLOAT32LE,
     sizeof (HyScanDOA),        HYSCAN_DISCRETIZATION_DOA },
 
+  { 0, "adc24le-packed",       HYSCAN_DATA_ADC24LE_PACKED,
+    3,                         HYSCAN_DISCRETIZATION_REAL },
+  { 0, "complex-adc24le-packed", HYSCAN_DATA_COMPLEX_ADC24LE_PACKED,
+    2 * 3,                     HYSCAN_DISCRETIZATION_COMPLEX },
+  { 0, "amplitude-int24le-packed", HYSCAN_DATA_AMPLITUDE_INT24LE_PACKED,
+    3,                         HYSCAN_DISCRETIZATION_AMPLITUDE },
+
+  { 0, "adc12le",              HYSCAN_DATA_ADC12LE,
+    sizeof (guint16),          HYSCAN_DISCRETIZATION_REAL },
+  { 0, "complex-adc12le-packed", HYSCAN_DATA_COMPLEX_ADC12LE_PACKED,
+    3,                         HYSCAN_DISCRETIZATION_COMPLEX },
+
+  { 0, "bfloat16le",           HYSCAN_DATA_BFLOAT16LE,
+    sizeof (guint16),          HYSCAN_DISCRETIZATION_REAL },
+  { 0, "complex-bfloat16le",   HYSCAN_DATA_COMPLEX_BFLOAT16LE,
+    2 * sizeof (guint16),      HYSCAN_DISCRETIZATION_COMPLEX },
+  { 0, "amplitude-bfloat16le", HYSCAN_DATA_AMPLITUDE_BFLOAT16LE,
+    sizeof (guint16),          HYSCAN_DISCRETIZATION_AMPLITUDE },
+
   { 0, NULL,                   HYSCAN_DATA_INVALID,
     0,                         HYSCAN_DISCRETIZATION_INVALID }
 };
@@ -73,6 +73,14 @@ typedef struct _HyScanGeoPoint HyScanGeoPoint;
  * @HYSCAN_DATA_AMPLITUDE_FLOAT16LE: амплитудные значения с плавающей точкой, 16 бит
  * @HYSCAN_DATA_AMPLITUDE_FLOAT32LE: амплитудные значения с плавающей точкой, 32 бит
  * @HYSCAN_DATA_DOA_FLOAT32LE: пространственное положение цели, значения с плавающей точкой, 32 бит
+ * @HYSCAN_DATA_ADC24LE_PACKED: действительные отсчёты АЦП 24 бит, упакованные в 3 байта
+ * @HYSCAN_DATA_COMPLEX_ADC24LE_PACKED: комплексные отсчёты АЦП 24 бит, упакованные в 3 байта
+ * @HYSCAN_DATA_AMPLITUDE_INT24LE_PACKED: амплитудные значения, 24 бит, упакованные в 3 байта
+ * @HYSCAN_DATA_ADC12LE: действительные отсчёты АЦП, младшие 12 бит из 16
+ * @HYSCAN_DATA_COMPLEX_ADC12LE_PACKED: комплексные отсчёты АЦП 12 бит, упакованные в 3 байта
+ * @HYSCAN_DATA_BFLOAT16LE: действительные значения с плавающей точкой, формат bfloat16
+ * @HYSCAN_DATA_COMPLEX_BFLOAT16LE: комплексные значения с плавающей точкой, формат bfloat16
+ * @HYSCAN_DATA_AMPLITUDE_BFLOAT16LE: амплитудные значения с плавающей точкой, формат bfloat16
  *
  * Типы данных.
  *
@@ -125,7 +133,18 @@ typedef enum
   HYSCAN_DATA_AMPLITUDE_FLOAT16LE,
   HYSCAN_DATA_AMPLITUDE_FLOAT32LE,
 
-  HYSCAN_DATA_DOA_FLOAT32LE
+  HYSCAN_DATA_DOA_FLOAT32LE,
+
+  HYSCAN_DATA_ADC24LE_PACKED,
+  HYSCAN_DATA_COMPLEX_ADC24LE_PACKED,
+  HYSCAN_DATA_AMPLITUDE_INT24LE_PACKED,
+
+  HYSCAN_DATA_ADC12LE,
+  HYSCAN_DATA_COMPLEX_ADC12LE_PACKED,
+
+  HYSCAN_DATA_BFLOAT16LE,
+  HYSCAN_DATA_COMPLEX_BFLOAT16LE,
+  HYSCAN_DATA_AMPLITUDE_BFLOAT16LE
 } HyScanDataType;
 
 /**
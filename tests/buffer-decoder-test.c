@@ -0,0 +1,201 @@
+/* buffer-decoder-test.c
+ *
+ * Copyright 2019 Screen LLC, Andrei Fadeev <andrei@webcontrol.ru>
+ *
+ * This file is part of HyScanTypes.
+ *
+ * HyScanTypes is dual-licensed: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * HyScanTypes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Alternatively, you can license this code under a commercial license.
+ * Contact the Screen LLC in this case - <info@screen-co.ru>.
+ */
+
+/* HyScanTypes имеет двойную лицензию.
+ *
+ * Во-первых, вы можете распространять HyScanTypes на условиях Стандартной
+ * Общественной Лицензии GNU версии 3, либо по любой более поздней версии
+ * лицензии (по вашему выбору). Полные положения лицензии GNU приведены в
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Во-вторых, этот программный код можно использовать по коммерческой
+ * лицензии. Для этого свяжитесь с ООО Экран - <info@screen-co.ru>.
+ */
+
+#include <hyscan-buffer-decoder.h>
+#include <string.h>
+
+#define N_POINTS       100003
+#define MAX_CHUNK      257
+
+typedef struct _test_info test_info;
+struct _test_info
+{
+  HyScanDataType  type;
+  HyScanDataType  float_type;
+};
+
+static test_info types_info[] =
+{
+  { HYSCAN_DATA_FLOAT,                 HYSCAN_DATA_FLOAT },
+  { HYSCAN_DATA_ADC12LE,               HYSCAN_DATA_FLOAT },
+  { HYSCAN_DATA_ADC14LE,               HYSCAN_DATA_FLOAT },
+  { HYSCAN_DATA_ADC16LE,               HYSCAN_DATA_FLOAT },
+  { HYSCAN_DATA_ADC24LE,               HYSCAN_DATA_FLOAT },
+  { HYSCAN_DATA_ADC24LE_PACKED,        HYSCAN_DATA_FLOAT },
+  { HYSCAN_DATA_FLOAT16LE,             HYSCAN_DATA_FLOAT },
+  { HYSCAN_DATA_BFLOAT16LE,            HYSCAN_DATA_FLOAT },
+  { HYSCAN_DATA_FLOAT32LE,             HYSCAN_DATA_FLOAT },
+  { HYSCAN_DATA_AMPLITUDE_INT8,        HYSCAN_DATA_FLOAT },
+  { HYSCAN_DATA_AMPLITUDE_INT16LE,     HYSCAN_DATA_FLOAT },
+  { HYSCAN_DATA_AMPLITUDE_INT24LE,     HYSCAN_DATA_FLOAT },
+  { HYSCAN_DATA_AMPLITUDE_INT24LE_PACKED, HYSCAN_DATA_FLOAT },
+  { HYSCAN_DATA_AMPLITUDE_INT32LE,     HYSCAN_DATA_FLOAT },
+  { HYSCAN_DATA_AMPLITUDE_FLOAT16LE,   HYSCAN_DATA_FLOAT },
+  { HYSCAN_DATA_AMPLITUDE_BFLOAT16LE,  HYSCAN_DATA_FLOAT },
+  { HYSCAN_DATA_AMPLITUDE_FLOAT32LE,   HYSCAN_DATA_FLOAT },
+  { HYSCAN_DATA_COMPLEX_FLOAT,         HYSCAN_DATA_COMPLEX_FLOAT },
+  { HYSCAN_DATA_COMPLEX_ADC12LE_PACKED, HYSCAN_DATA_COMPLEX_FLOAT },
+  { HYSCAN_DATA_COMPLEX_ADC14LE,       HYSCAN_DATA_COMPLEX_FLOAT },
+  { HYSCAN_DATA_COMPLEX_ADC16LE,       HYSCAN_DATA_COMPLEX_FLOAT },
+  { HYSCAN_DATA_COMPLEX_ADC24LE,       HYSCAN_DATA_COMPLEX_FLOAT },
+  { HYSCAN_DATA_COMPLEX_ADC24LE_PACKED, HYSCAN_DATA_COMPLEX_FLOAT },
+  { HYSCAN_DATA_COMPLEX_FLOAT16LE,     HYSCAN_DATA_COMPLEX_FLOAT },
+  { HYSCAN_DATA_COMPLEX_BFLOAT16LE,    HYSCAN_DATA_COMPLEX_FLOAT },
+  { HYSCAN_DATA_COMPLEX_FLOAT32LE,     HYSCAN_DATA_COMPLEX_FLOAT },
+  { HYSCAN_DATA_DOA,                   HYSCAN_DATA_DOA },
+  { HYSCAN_DATA_DOA_FLOAT32LE,         HYSCAN_DATA_DOA }
+};
+
+int
+main (int    argc,
+      char **argv)
+{
+  HyScanBuffer *values;
+  HyScanBuffer *raw;
+  HyScanBuffer *reference;
+  HyScanBuffer *output;
+  guint seed = 1;
+  guint i;
+
+  values = hyscan_buffer_new ();
+  raw = hyscan_buffer_new ();
+  reference = hyscan_buffer_new ();
+  output = hyscan_buffer_new ();
+
+  hyscan_buffer_set_growth (output, HYSCAN_BUFFER_GROWTH_GEOMETRIC);
+
+  if (hyscan_buffer_decoder_new (HYSCAN_DATA_BLOB) != NULL)
+    g_error ("unsupported type accepted");
+
+  for (i = 0; i < G_N_ELEMENTS (types_info); i++)
+    {
+      HyScanBufferDecoder *decoder;
+      const guint8 *raw_data;
+      gconstpointer reference_data;
+      gconstpointer output_data;
+      gfloat *float_data;
+      guint32 reference_size;
+      guint32 output_size;
+      guint32 point_size;
+      guint32 raw_size;
+      guint32 offset;
+      guint32 j;
+
+      g_message ("Testing %s data format.", hyscan_data_get_id_by_type (types_info[i].type));
+
+      /* Тестовые данные. */
+      point_size = hyscan_data_get_point_size (types_info[i].float_type);
+      hyscan_buffer_set (values, types_info[i].float_type, NULL, N_POINTS * point_size);
+      float_data = hyscan_buffer_get (values, NULL, &raw_size);
+      for (j = 0; j < raw_size / sizeof (gfloat); j++)
+        {
+          seed = seed * 1103515245 + 12345;
+          float_data[j] = (seed >> 8) / 16777216.0f;
+        }
+
+      if (!hyscan_buffer_export (values, raw, types_info[i].type) ||
+          !hyscan_buffer_import (reference, raw))
+        {
+          g_error ("can't prepare data");
+        }
+
+      raw_data = hyscan_buffer_peek (raw, NULL, &raw_size);
+      reference_data = hyscan_buffer_peek (reference, NULL, &reference_size);
+
+      decoder = hyscan_buffer_decoder_new (types_info[i].type);
+      if (hyscan_buffer_decoder_get_data_type (decoder) != types_info[i].type)
+        g_error ("decoder type mismatch");
+
+      /* Незавершённая точка отбрасывается при сбросе. */
+      if (!hyscan_buffer_decoder_push (decoder, output, raw_data, 1) ||
+          (hyscan_buffer_decoder_get_pending (decoder) != (hyscan_data_get_point_size (types_info[i].type) > 1)))
+        {
+          g_error ("partial point error");
+        }
+
+      hyscan_buffer_decoder_reset (decoder);
+
+      /* Импорт частями случайного размера, в том числе нулевого. */
+      for (offset = 0; offset < raw_size;)
+        {
+          guint32 size;
+
+          seed = seed * 1103515245 + 12345;
+          size = MIN ((seed >> 8) % MAX_CHUNK, raw_size - offset);
+
+          if (!hyscan_buffer_decoder_push (decoder, output, raw_data + offset, size))
+            g_error ("can't push data");
+
+          offset += size;
+        }
+
+      if ((hyscan_buffer_decoder_get_n_points (decoder) != N_POINTS) ||
+          (hyscan_buffer_decoder_get_pending (decoder) != 0))
+        {
+          g_error ("decoder state error");
+        }
+
+      output_data = hyscan_buffer_peek (output, NULL, &output_size);
+      if ((hyscan_buffer_get_data_type (output) != types_info[i].float_type) ||
+          (output_size != reference_size) || (memcmp (output_data, reference_data, output_size) != 0))
+        {
+          g_error ("streaming import mismatch");
+        }
+
+      /* Изменённый выходной буфер не принимается. */
+      hyscan_buffer_set_data_size (output, point_size);
+      if (hyscan_buffer_decoder_push (decoder, output, raw_data, raw_size))
+        g_error ("modified output accepted");
+
+      /* Повторный импорт данных целиком. */
+      hyscan_buffer_decoder_reset (decoder);
+      if (!hyscan_buffer_decoder_push (decoder, output, raw_data, raw_size))
+        g_error ("can't push data");
+
+      output_data = hyscan_buffer_peek (output, NULL, &output_size);
+      if ((output_size != reference_size) || (memcmp (output_data, reference_data, output_size) != 0))
+        g_error ("single chunk import mismatch");
+
+      g_object_unref (decoder);
+    }
+
+  g_object_unref (values);
+  g_object_unref (raw);
+  g_object_unref (reference);
+  g_object_unref (output);
+
+  g_message ("All done");
+
+  return 0;
+}
@@ -0,0 +1,256 @@
+/* buffer-pool-test.c
+ *
+ * Copyright 2019 Screen LLC, Andrei Fadeev <andrei@webcontrol.ru>
+ *
+ * This file is part of HyScanTypes.
+ *
+ * HyScanTypes is dual-licensed: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * HyScanTypes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Alternatively, you can license this code under a commercial license.
+ * Contact the Screen LLC in this case - <info@screen-co.ru>.
+ */
+
+/* HyScanTypes имеет двойную лицензию.
+ *
+ * Во-первых, вы можете распространять HyScanTypes на условиях Стандартной
+ * Общественной Лицензии GNU версии 3, либо по любой более поздней версии
+ * лицензии (по вашему выбору). Полные положения лицензии GNU приведены в
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Во-вторых, этот программный код можно использовать по коммерческой
+ * лицензии. Для этого свяжитесь с ООО Экран - <info@screen-co.ru>.
+ */
+
+#include <hyscan-buffer-pool.h>
+#include <string.h>
+
+#define N_THREADS      4
+#define N_ITERATIONS   100000
+
+static HyScanBufferPool *pool;
+
+static GMutex gate_lock;
+static GCond gate_cond;
+static guint gate_stage;
+
+/* Функция ожидает этапа stage проверки очистки пула. */
+static void
+gate_wait (guint stage)
+{
+  g_mutex_lock (&gate_lock);
+  while (gate_stage < stage)
+    g_cond_wait (&gate_cond, &gate_lock);
+  g_mutex_unlock (&gate_lock);
+}
+
+/* Функция переходит к этапу stage проверки очистки пула. */
+static void
+gate_set (guint stage)
+{
+  g_mutex_lock (&gate_lock);
+  gate_stage = stage;
+  g_cond_broadcast (&gate_cond);
+  g_mutex_unlock (&gate_lock);
+}
+
+/* Поток, возвращающий буфер в кэш потока до и после очистки пула. */
+static gpointer
+clear_thread (gpointer data)
+{
+  HyScanBufferPool *cleared = data;
+
+  hyscan_buffer_pool_release (cleared, hyscan_buffer_pool_acquire (cleared, 1000));
+  gate_set (1);
+  gate_wait (2);
+
+  hyscan_buffer_pool_release (cleared, hyscan_buffer_pool_acquire (cleared, 1000));
+
+  return NULL;
+}
+
+/* Поток, запрашивающий буферы из пула. */
+static gpointer
+pool_thread (gpointer data)
+{
+  guint seed = GPOINTER_TO_UINT (data);
+  guint i;
+
+  for (i = 0; i < N_ITERATIONS; i++)
+    {
+      HyScanBuffer *buffer;
+      guint8 *values;
+      guint32 size;
+      guint32 j;
+
+      seed = seed * 1103515245 + 12345;
+      size = 1 + (seed >> 8) % 65536;
+
+      buffer = hyscan_buffer_pool_acquire (pool, size);
+      if (hyscan_buffer_get_capacity (buffer) < size)
+        g_error ("buffer capacity error");
+
+      hyscan_buffer_set (buffer, HYSCAN_DATA_BLOB, NULL, size);
+      values = hyscan_buffer_get (buffer, NULL, &size);
+      memset (values, i, size);
+
+      for (j = 0; j < size; j++)
+        if (values[j] != (guint8)i)
+          g_error ("data mismatch");
+
+      hyscan_buffer_pool_release (pool, buffer);
+    }
+
+  return NULL;
+}
+
+int
+main (int    argc,
+      char **argv)
+{
+  HyScanBuffer *buffer1;
+  HyScanBuffer *buffer2;
+  HyScanBuffer *buffer3;
+  HyScanBufferPool *pool1;
+  HyScanBufferPool *pool2;
+  GThread *threads[N_THREADS];
+  guint8 data[256];
+  guint n_allocations;
+  guint hits, misses;
+  guint i;
+
+  pool = hyscan_buffer_pool_new ();
+
+  /* Повторное использование буфера. */
+  buffer1 = hyscan_buffer_pool_acquire (pool, 1000);
+  if (hyscan_buffer_get_capacity (buffer1) < 1000)
+    g_error ("buffer capacity error");
+
+  hyscan_buffer_pool_release (pool, buffer1);
+
+  buffer2 = hyscan_buffer_pool_acquire (pool, 600);
+  if (buffer2 != buffer1)
+    g_error ("buffer isn't reused");
+
+  buffer3 = hyscan_buffer_pool_acquire (pool, 5000);
+  if ((buffer3 == buffer1) || (hyscan_buffer_get_capacity (buffer3) < 5000))
+    g_error ("wrong buffer size class");
+
+  hyscan_buffer_pool_get_stats (pool, &hits, &misses);
+  if ((hits != 1) || (misses != 2))
+    g_error ("wrong statistics: hits %d, misses %d", hits, misses);
+
+  /* Установившийся режим работы не выделяет память. */
+  n_allocations = hyscan_buffer_get_n_allocations (buffer2);
+  for (i = 0; i < 1000; i++)
+    {
+      hyscan_buffer_pool_release (pool, buffer2);
+      buffer2 = hyscan_buffer_pool_acquire (pool, 513 + i % 512);
+      hyscan_buffer_set (buffer2, HYSCAN_DATA_BLOB, NULL, 513 + i % 512);
+    }
+
+  if ((buffer2 != buffer1) || (hyscan_buffer_get_n_allocations (buffer2) != n_allocations))
+    g_error ("steady state allocations");
+
+  hyscan_buffer_pool_get_stats (pool, &hits, &misses);
+  if ((hits != 1001) || (misses != 2))
+    g_error ("wrong statistics: hits %d, misses %d", hits, misses);
+
+  /* Обёртка над внешними данными не сохраняется в пуле. */
+  hyscan_buffer_wrap (buffer3, HYSCAN_DATA_BLOB, data, sizeof (data));
+  hyscan_buffer_pool_release (pool, buffer3);
+  hyscan_buffer_pool_release (pool, buffer2);
+  hyscan_buffer_pool_clear (pool);
+
+  /* Буферы разных пулов не смешиваются. */
+  pool1 = hyscan_buffer_pool_new ();
+  pool2 = hyscan_buffer_pool_new ();
+
+  /* Дополнительная ссылка не позволяет создать новый буфер по тому же адресу. */
+  buffer1 = hyscan_buffer_pool_acquire (pool1, 1000);
+  hyscan_buffer_pool_release (pool1, g_object_ref (buffer1));
+  buffer2 = hyscan_buffer_pool_acquire (pool2, 1000);
+  if (buffer2 == buffer1)
+    g_error ("buffer is shared between pools");
+
+  g_object_unref (buffer1);
+
+  hyscan_buffer_pool_get_stats (pool2, &hits, &misses);
+  if ((hits != 0) || (misses != 1))
+    g_error ("wrong statistics: hits %d, misses %d", hits, misses);
+
+  /* Очистка пула не затрагивает буферы другого пула. */
+  hyscan_buffer_pool_release (pool2, buffer2);
+  hyscan_buffer_pool_clear (pool1);
+  buffer1 = hyscan_buffer_pool_acquire (pool2, 1000);
+  if (buffer1 != buffer2)
+    g_error ("buffer of other pool is cleared");
+
+  hyscan_buffer_pool_get_stats (pool2, &hits, &misses);
+  if ((hits != 1) || (misses != 1))
+    g_error ("wrong statistics: hits %d, misses %d", hits, misses);
+
+  hyscan_buffer_pool_get_stats (pool1, &hits, &misses);
+  if ((hits != 0) || (misses != 1))
+    g_error ("wrong statistics: hits %d, misses %d", hits, misses);
+
+  hyscan_buffer_pool_release (pool2, buffer1);
+
+  /* Поочерёдная работа с двумя пулами использует буферы повторно. */
+  for (i = 0; i < 100; i++)
+    {
+      hyscan_buffer_pool_release (pool1, hyscan_buffer_pool_acquire (pool1, 1000));
+      hyscan_buffer_pool_release (pool2, hyscan_buffer_pool_acquire (pool2, 1000));
+    }
+
+  hyscan_buffer_pool_get_stats (pool1, &hits, &misses);
+  if ((hits != 99) || (misses != 2))
+    g_error ("wrong statistics: hits %d, misses %d", hits, misses);
+
+  hyscan_buffer_pool_get_stats (pool2, &hits, &misses);
+  if ((hits != 101) || (misses != 1))
+    g_error ("wrong statistics: hits %d, misses %d", hits, misses);
+
+  /* Очистка пула удаляет его буферы из кэшей других потоков. */
+  threads[0] = g_thread_new ("pool-test", clear_thread, pool1);
+  gate_wait (1);
+  hyscan_buffer_pool_clear (pool1);
+  gate_set (2);
+  g_thread_join (threads[0]);
+
+  hyscan_buffer_pool_get_stats (pool1, &hits, &misses);
+  if ((hits != 100) || (misses != 3))
+    g_error ("wrong statistics: hits %d, misses %d", hits, misses);
+
+  g_object_unref (pool1);
+  g_object_unref (pool2);
+
+  /* Многопоточная работа. */
+  for (i = 0; i < N_THREADS; i++)
+    threads[i] = g_thread_new ("pool-test", pool_thread, GUINT_TO_POINTER (i + 1));
+
+  for (i = 0; i < N_THREADS; i++)
+    g_thread_join (threads[i]);
+
+  hyscan_buffer_pool_get_stats (pool, &hits, &misses);
+  if (hits + misses != 1003 + N_THREADS * N_ITERATIONS)
+    g_error ("wrong statistics: hits %d, misses %d", hits, misses);
+
+  g_message ("hits %d, misses %d", hits, misses);
+
+  g_object_unref (pool);
+
+  g_message ("All done");
+
+  return 0;
+}
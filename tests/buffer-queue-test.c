@@ -0,0 +1,266 @@
+/* buffer-queue-test.c
+ *
+ * Copyright 2019 Screen LLC, Andrei Fadeev <andrei@webcontrol.ru>
+ *
+ * This file is part of HyScanTypes.
+ *
+ * HyScanTypes is dual-licensed: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * HyScanTypes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Alternatively, you can license this code under a commercial license.
+ * Contact the Screen LLC in this case - <info@screen-co.ru>.
+ */
+
+/* HyScanTypes имеет двойную лицензию.
+ *
+ * Во-первых, вы можете распространять HyScanTypes на условиях Стандартной
+ * Общественной Лицензии GNU версии 3, либо по любой более поздней версии
+ * лицензии (по вашему выбору). Полные положения лицензии GNU приведены в
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Во-вторых, этот программный код можно использовать по коммерческой
+ * лицензии. Для этого свяжитесь с ООО Экран - <info@screen-co.ru>.
+ */
+
+#include <hyscan-buffer-queue.h>
+#include <string.h>
+
+#define N_BUFFERS      16
+#define BUFFER_SIZE    1024
+#define N_PRODUCERS    3
+#define N_CONSUMERS    2
+#define N_MESSAGES     100000
+
+/* Сообщение производителя. */
+typedef struct
+{
+  guint32      producer;
+  guint32      index;
+} test_message;
+
+static HyScanBufferQueue *queue;
+static gint received[N_PRODUCERS];
+
+/* Поток-производитель. */
+static gpointer
+producer_thread (gpointer data)
+{
+  guint32 producer = GPOINTER_TO_UINT (data);
+  guint32 i;
+
+  for (i = 0; i < N_MESSAGES; i++)
+    {
+      HyScanBuffer *buffer;
+      test_message *message;
+      guint32 size;
+
+      buffer = hyscan_buffer_queue_acquire (queue);
+      if (buffer == NULL)
+        g_error ("queue acquire error");
+
+      size = sizeof (test_message) + i % (BUFFER_SIZE - sizeof (test_message));
+      hyscan_buffer_set (buffer, HYSCAN_DATA_BLOB, NULL, size);
+      message = hyscan_buffer_get (buffer, NULL, &size);
+      memset (message + 1, producer + i, size - sizeof (test_message));
+      message->producer = producer;
+      message->index = i;
+
+      if (!hyscan_buffer_queue_push (queue, buffer))
+        g_error ("queue push error");
+    }
+
+  return NULL;
+}
+
+/* Поток-потребитель. */
+static gpointer
+consumer_thread (gpointer data)
+{
+  guint32 last[N_PRODUCERS];
+  HyScanBuffer *buffer;
+  guint i;
+
+  for (i = 0; i < N_PRODUCERS; i++)
+    last[i] = G_MAXUINT32;
+
+  while ((buffer = hyscan_buffer_queue_pop (queue)) != NULL)
+    {
+      test_message *message;
+      guint8 *payload;
+      guint32 size;
+      guint32 j;
+
+      message = hyscan_buffer_get (buffer, NULL, &size);
+      if (message->producer >= N_PRODUCERS)
+        g_error ("message producer error");
+
+      /* Сообщения одного производителя извлекаются по порядку. */
+      if ((last[message->producer] != G_MAXUINT32) && (message->index <= last[message->producer]))
+        g_error ("message order error");
+      last[message->producer] = message->index;
+
+      payload = (guint8 *)(message + 1);
+      for (j = 0; j < size - sizeof (test_message); j++)
+        if (payload[j] != (guint8)(message->producer + message->index))
+          g_error ("message data error");
+
+      /* Буферы используются повторно без выделения памяти. */
+      if (hyscan_buffer_get_n_allocations (buffer) != 1)
+        g_error ("buffer reallocated");
+
+      g_atomic_int_inc (&received[message->producer]);
+      hyscan_buffer_queue_release (queue, buffer);
+    }
+
+  return NULL;
+}
+
+/* Функция проверяет поведение очереди при отсутствии свободных буферов. */
+static void
+check_policy (HyScanBufferQueuePolicy policy)
+{
+  HyScanBuffer *buffers[4];
+  HyScanBuffer *buffer;
+  guint pushed, dropped;
+  guint32 *value;
+  guint32 size;
+  guint32 first, last;
+  guint32 i;
+
+  queue = hyscan_buffer_queue_new (4, 64, policy);
+
+  for (i = 0; i < 4; i++)
+    {
+      buffers[i] = hyscan_buffer_queue_acquire (queue);
+      if (buffers[i] == NULL)
+        g_error ("queue acquire error");
+
+      hyscan_buffer_set (buffers[i], HYSCAN_DATA_BLOB, &i, sizeof (i));
+      hyscan_buffer_queue_push (queue, buffers[i]);
+    }
+
+  buffer = hyscan_buffer_queue_acquire (queue);
+  if (policy == HYSCAN_BUFFER_QUEUE_DROP_OLDEST)
+    {
+      if (buffer != buffers[0])
+        g_error ("drop oldest error");
+
+      hyscan_buffer_set (buffer, HYSCAN_DATA_BLOB, &i, sizeof (i));
+      hyscan_buffer_queue_push (queue, buffer);
+    }
+  else if (buffer != NULL)
+    {
+      g_error ("drop newest error");
+    }
+
+  hyscan_buffer_queue_get_stats (queue, &pushed, &dropped);
+  if ((pushed != 4 + (buffer != NULL)) || (dropped != 1))
+    g_error ("wrong statistics: pushed %d, dropped %d", pushed, dropped);
+
+  /* В очереди остаются четыре самых новых или четыре самых старых значения. */
+  first = (buffer != NULL) ? 1 : 0;
+  last = first + 4;
+
+  if (hyscan_buffer_queue_get_n_buffers (queue) != 4)
+    g_error ("queue n_buffers error");
+
+  for (i = first; i < last; i++)
+    {
+      buffer = hyscan_buffer_queue_try_pop (queue);
+      if (buffer == NULL)
+        g_error ("queue pop error");
+
+      value = hyscan_buffer_get (buffer, NULL, &size);
+      if ((size != sizeof (i)) || (*value != i))
+        g_error ("queue order error");
+
+      hyscan_buffer_queue_release (queue, buffer);
+    }
+
+  if (hyscan_buffer_queue_try_pop (queue) != NULL)
+    g_error ("empty queue pop");
+
+  /* Все буферы заняты производителями, потерянных данных нет. */
+  for (i = 0; i < 4; i++)
+    buffers[i] = hyscan_buffer_queue_acquire (queue);
+
+  if (hyscan_buffer_queue_acquire (queue) != NULL)
+    g_error ("busy queue acquire");
+
+  hyscan_buffer_queue_get_stats (queue, NULL, &dropped);
+  if (dropped != ((policy == HYSCAN_BUFFER_QUEUE_DROP_OLDEST) ? 1 : 2))
+    g_error ("wrong statistics: dropped %d", dropped);
+
+  for (i = 0; i < 4; i++)
+    hyscan_buffer_queue_release (queue, buffers[i]);
+
+  /* Закрытие очереди. */
+  hyscan_buffer_queue_close (queue);
+  if ((hyscan_buffer_queue_acquire (queue) != NULL) || (hyscan_buffer_queue_pop (queue) != NULL))
+    g_error ("closed queue error");
+
+  g_object_unref (queue);
+}
+
+int
+main (int    argc,
+      char **argv)
+{
+  GThread *producers[N_PRODUCERS];
+  GThread *consumers[N_CONSUMERS];
+  guint pushed, dropped;
+  gint64 start, elapsed;
+  guint i;
+
+  check_policy (HYSCAN_BUFFER_QUEUE_DROP_OLDEST);
+  check_policy (HYSCAN_BUFFER_QUEUE_DROP_NEWEST);
+
+  /* Передача данных между потоками с ожиданием свободных буферов. */
+  queue = hyscan_buffer_queue_new (N_BUFFERS, BUFFER_SIZE, HYSCAN_BUFFER_QUEUE_BLOCK);
+
+  start = g_get_monotonic_time ();
+
+  for (i = 0; i < N_CONSUMERS; i++)
+    consumers[i] = g_thread_new ("queue-consumer", consumer_thread, NULL);
+  for (i = 0; i < N_PRODUCERS; i++)
+    producers[i] = g_thread_new ("queue-producer", producer_thread, GUINT_TO_POINTER (i));
+
+  for (i = 0; i < N_PRODUCERS; i++)
+    g_thread_join (producers[i]);
+
+  /* Ожидание обработки всех данных. */
+  while (hyscan_buffer_queue_get_n_buffers (queue) > 0)
+    g_usleep (1000);
+
+  hyscan_buffer_queue_close (queue);
+  for (i = 0; i < N_CONSUMERS; i++)
+    g_thread_join (consumers[i]);
+
+  elapsed = g_get_monotonic_time () - start;
+
+  for (i = 0; i < N_PRODUCERS; i++)
+    if (received[i] != N_MESSAGES)
+      g_error ("producer %d: received %d messages", i, received[i]);
+
+  hyscan_buffer_queue_get_stats (queue, &pushed, &dropped);
+  if ((pushed != N_PRODUCERS * N_MESSAGES) || (dropped != 0))
+    g_error ("wrong statistics: pushed %d, dropped %d", pushed, dropped);
+
+  g_message ("%d messages in %.3f s", pushed, elapsed / 1000000.0);
+
+  g_object_unref (queue);
+
+  g_message ("All done");
+
+  return 0;
+}
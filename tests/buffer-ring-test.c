@@ -0,0 +1,198 @@
+/* buffer-ring-test.c
+ *
+ * Copyright 2019 Screen LLC, Andrei Fadeev <andrei@webcontrol.ru>
+ *
+ * This file is part of HyScanTypes.
+ *
+ * HyScanTypes is dual-licensed: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * HyScanTypes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Alternatively, you can license this code under a commercial license.
+ * Contact the Screen LLC in this case - <info@screen-co.ru>.
+ */
+
+/* HyScanTypes имеет двойную лицензию.
+ *
+ * Во-первых, вы можете распространять HyScanTypes на условиях Стандартной
+ * Общественной Лицензии GNU версии 3, либо по любой более поздней версии
+ * лицензии (по вашему выбору). Полные положения лицензии GNU приведены в
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Во-вторых, этот программный код можно использовать по коммерческой
+ * лицензии. Для этого свяжитесь с ООО Экран - <info@screen-co.ru>.
+ */
+
+#include <hyscan-buffer-ring.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define N_BUFFERS      64
+#define BUFFER_SIZE    4096
+#define N_MESSAGES     1000000
+
+/* Заголовок сообщения. */
+typedef struct
+{
+  gint64       time;
+  guint32      index;
+} test_header;
+
+static HyScanBufferRing *ring;
+
+/* Поток-производитель. */
+static gpointer
+producer_thread (gpointer data)
+{
+  guint32 i;
+
+  for (i = 0; i < N_MESSAGES; i++)
+    {
+      HyScanBuffer *buffer;
+      test_header *header;
+      guint8 *payload;
+      guint32 size;
+
+      while ((buffer = hyscan_buffer_ring_acquire (ring)) == NULL)
+        g_thread_yield ();
+
+      size = sizeof (test_header) + 1 + i % (BUFFER_SIZE - sizeof (test_header));
+      hyscan_buffer_set (buffer, HYSCAN_DATA_BLOB, NULL, size);
+      header = hyscan_buffer_get (buffer, NULL, &size);
+      payload = (guint8 *)(header + 1);
+      memset (payload, i, size - sizeof (test_header));
+
+      header->index = i;
+      header->time = g_get_monotonic_time ();
+
+      hyscan_buffer_ring_commit (ring);
+    }
+
+  return NULL;
+}
+
+static int
+compare_latency (const void *a,
+                 const void *b)
+{
+  gint64 la = *(const gint64 *)a;
+  gint64 lb = *(const gint64 *)b;
+
+  return (la > lb) - (la < lb);
+}
+
+int
+main (int    argc,
+      char **argv)
+{
+  GThread *producer;
+  gint64 *latency;
+  gint64 start, elapsed;
+  guint32 i;
+
+  ring = hyscan_buffer_ring_new (N_BUFFERS - 1, BUFFER_SIZE);
+  if (hyscan_buffer_ring_get_capacity (ring) != N_BUFFERS)
+    g_error ("ring capacity error");
+
+  /* Заполнение и опустошение кольца в одном потоке. */
+  if (hyscan_buffer_ring_peek (ring) != NULL)
+    g_error ("empty ring peek");
+
+  for (i = 0; i < N_BUFFERS; i++)
+    {
+      HyScanBuffer *buffer = hyscan_buffer_ring_acquire (ring);
+
+      if ((buffer == NULL) || (hyscan_buffer_get_capacity (buffer) < BUFFER_SIZE))
+        g_error ("ring acquire error");
+
+      hyscan_buffer_set (buffer, HYSCAN_DATA_BLOB, &i, sizeof (i));
+      hyscan_buffer_ring_commit (ring);
+    }
+
+  if (hyscan_buffer_ring_acquire (ring) != NULL)
+    g_error ("full ring acquire");
+
+  if (hyscan_buffer_ring_get_n_buffers (ring) != N_BUFFERS)
+    g_error ("ring n_buffers error");
+
+  for (i = 0; i < N_BUFFERS; i++)
+    {
+      HyScanBuffer *buffer = hyscan_buffer_ring_peek (ring);
+      guint32 *value;
+      guint32 size;
+
+      if (buffer == NULL)
+        g_error ("ring peek error");
+
+      value = hyscan_buffer_get (buffer, NULL, &size);
+      if ((size != sizeof (i)) || (*value != i))
+        g_error ("ring order error");
+
+      hyscan_buffer_ring_release (ring);
+    }
+
+  if ((hyscan_buffer_ring_peek (ring) != NULL) || (hyscan_buffer_ring_get_n_buffers (ring) != 0))
+    g_error ("empty ring peek");
+
+  /* Передача данных между потоками. */
+  latency = g_new (gint64, N_MESSAGES);
+
+  start = g_get_monotonic_time ();
+  producer = g_thread_new ("ring-producer", producer_thread, NULL);
+
+  for (i = 0; i < N_MESSAGES; i++)
+    {
+      HyScanBuffer *buffer;
+      test_header *header;
+      guint8 *payload;
+      guint32 size;
+      guint32 j;
+
+      while ((buffer = hyscan_buffer_ring_peek (ring)) == NULL)
+        g_thread_yield ();
+
+      header = hyscan_buffer_get (buffer, NULL, &size);
+      latency[i] = g_get_monotonic_time () - header->time;
+
+      if (header->index != i)
+        g_error ("message order error: %d, expected %d", header->index, i);
+
+      if (size != sizeof (test_header) + 1 + i % (BUFFER_SIZE - sizeof (test_header)))
+        g_error ("message size error");
+
+      payload = (guint8 *)(header + 1);
+      for (j = 0; j < size - sizeof (test_header); j++)
+        if (payload[j] != (guint8)i)
+          g_error ("message data error");
+
+      hyscan_buffer_ring_release (ring);
+    }
+
+  g_thread_join (producer);
+  elapsed = g_get_monotonic_time () - start;
+
+  qsort (latency, N_MESSAGES, sizeof (gint64), compare_latency);
+
+  g_message ("%d messages in %.3f s", N_MESSAGES, elapsed / 1000000.0);
+  g_message ("latency, us: p50 %" G_GINT64_FORMAT ", p90 %" G_GINT64_FORMAT
+             ", p99 %" G_GINT64_FORMAT ", p99.9 %" G_GINT64_FORMAT ", max %" G_GINT64_FORMAT,
+             latency[N_MESSAGES / 2], latency[N_MESSAGES / 10 * 9],
+             latency[N_MESSAGES / 100 * 99], latency[N_MESSAGES / 1000 * 999],
+             latency[N_MESSAGES - 1]);
+
+  g_free (latency);
+  g_object_unref (ring);
+
+  g_message ("All done");
+
+  return 0;
+}
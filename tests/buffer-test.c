@@ -33,9 +33,12 @@
  */
 
 #include <hyscan-buffer.h>
+#include <string.h>
+#include <glib/gstdio.h>
 #include <math.h>
 
 #define N_POINTS 10000000
+#define N_RANDOM_POINTS 100003
 
 typedef struct _test_info test_info;
 struct _test_info
@@ -50,26 +53,34 @@ struct _test_info
 test_info float_test_info [] =
 {
   { "HYSCAN_DATA_FLOAT",               HYSCAN_DATA_FLOAT,                0.0, 1.0, 0.0 },
+  { "HYSCAN_DATA_ADC12LE",             HYSCAN_DATA_ADC12LE,             -1.0, 1.0, 2.0 / 4096.0 },
   { "HYSCAN_DATA_ADC14LE",             HYSCAN_DATA_ADC14LE,             -1.0, 1.0, 2.0 / 16384.0 },
   { "HYSCAN_DATA_ADC16LE",             HYSCAN_DATA_ADC16LE,             -1.0, 1.0, 2.0 / 65536.0 },
   { "HYSCAN_DATA_ADC24LE",             HYSCAN_DATA_ADC24LE,             -1.0, 1.0, 4.0 / 16777216.0 },
+  { "HYSCAN_DATA_ADC24LE_PACKED",      HYSCAN_DATA_ADC24LE_PACKED,      -1.0, 1.0, 4.0 / 16777216.0 },
   { "HYSCAN_DATA_FLOAT16LE",           HYSCAN_DATA_FLOAT16LE,           -1.0, 1.0, 1.0 / 2048.0 },
+  { "HYSCAN_DATA_BFLOAT16LE",          HYSCAN_DATA_BFLOAT16LE,          -1.0, 1.0, 1.0 / 256.0 },
   { "HYSCAN_DATA_FLOAT32LE",           HYSCAN_DATA_FLOAT32LE,           -1.0, 1.0, 0.0 },
   { "HYSCAN_DATA_AMPLITUDE_INT8",      HYSCAN_DATA_AMPLITUDE_INT8,       0.0, 1.0, 1.0 / 256.0 },
   { "HYSCAN_DATA_AMPLITUDE_INT16LE",   HYSCAN_DATA_AMPLITUDE_INT16LE,    0.0, 1.0, 1.0 / 16384.0 },
   { "HYSCAN_DATA_AMPLITUDE_INT24LE",   HYSCAN_DATA_AMPLITUDE_INT24LE,    0.0, 1.0, 2.0 / 16777216.0 },
+  { "HYSCAN_DATA_AMPLITUDE_INT24LE_PACKED", HYSCAN_DATA_AMPLITUDE_INT24LE_PACKED, 0.0, 1.0, 2.0 / 16777216.0 },
   { "HYSCAN_DATA_AMPLITUDE_INT32LE",   HYSCAN_DATA_AMPLITUDE_INT32LE,    0.0, 1.0, 2.0 / 4294967296.0 },
   { "HYSCAN_DATA_AMPLITUDE_FLOAT16LE", HYSCAN_DATA_AMPLITUDE_FLOAT16LE,  0.0, 1.0, 1.0 / 2048.0 },
+  { "HYSCAN_DATA_AMPLITUDE_BFLOAT16LE", HYSCAN_DATA_AMPLITUDE_BFLOAT16LE, 0.0, 1.0, 1.0 / 256.0 },
   { "HYSCAN_DATA_AMPLITUDE_FLOAT32LE", HYSCAN_DATA_AMPLITUDE_FLOAT32LE,  0.0, 1.0, 0.0 }
 };
 
 test_info complex_float_test_info [] =
 {
   { "HYSCAN_DATA_COMPLEX_FLOAT",       HYSCAN_DATA_COMPLEX_FLOAT,        0.0, 1.0, 0.0 },
+  { "HYSCAN_DATA_COMPLEX_ADC12LE_PACKED", HYSCAN_DATA_COMPLEX_ADC12LE_PACKED, -1.0, 1.0, 4.0 / 4096.0 },
   { "HYSCAN_DATA_COMPLEX_ADC14LE",     HYSCAN_DATA_COMPLEX_ADC14LE,     -1.0, 1.0, 4.0 / 16384.0 },
   { "HYSCAN_DATA_COMPLEX_ADC16LE",     HYSCAN_DATA_COMPLEX_ADC16LE,     -1.0, 1.0, 4.0 / 65536.0 },
   { "HYSCAN_DATA_COMPLEX_ADC24LE",     HYSCAN_DATA_COMPLEX_ADC24LE,     -1.0, 1.0, 5.0 / 16777216.0 },
+  { "HYSCAN_DATA_COMPLEX_ADC24LE_PACKED", HYSCAN_DATA_COMPLEX_ADC24LE_PACKED, -1.0, 1.0, 5.0 / 16777216.0 },
   { "HYSCAN_DATA_COMPLEX_FLOAT16LE",   HYSCAN_DATA_COMPLEX_FLOAT16LE,   -1.0, 1.0, 1.0 / 2048.0 },
+  { "HYSCAN_DATA_COMPLEX_BFLOAT16LE",  HYSCAN_DATA_COMPLEX_BFLOAT16LE,  -1.0, 1.0, 1.0 / 256.0 },
   { "HYSCAN_DATA_COMPLEX_FLOAT32LE",   HYSCAN_DATA_COMPLEX_FLOAT32LE,   -1.0, 1.0, 0.0 }
 };
 
@@ -79,6 +90,1426 @@ test_info doa_test_info [] =
   { "HYSCAN_DATA_DOA_FLOAT32LE",       HYSCAN_DATA_DOA_FLOAT32LE,       -1.0, 1.0, 0.0 }
 };
 
+HyScanBufferSimd simd_levels [] =
+{
+  HYSCAN_BUFFER_SIMD_SSE2,
+  HYSCAN_BUFFER_SIMD_AVX2,
+  HYSCAN_BUFFER_SIMD_NEON,
+  HYSCAN_BUFFER_SIMD_F16C
+};
+
+/* Функция проверяет побитное совпадение результатов импорта данных
+ * векторными и скалярными функциями. */
+static void
+check_simd_import (HyScanBuffer *raw)
+{
+  HyScanBuffer *reference;
+  HyScanBuffer *vector;
+  HyScanBufferSimd simd;
+
+  gpointer reference_data;
+  gpointer vector_data;
+  guint32 reference_size;
+  guint32 vector_size;
+
+  guint i;
+
+  reference = hyscan_buffer_new ();
+  vector = hyscan_buffer_new ();
+  simd = hyscan_buffer_get_simd ();
+
+  hyscan_buffer_set_simd (HYSCAN_BUFFER_SIMD_NONE);
+  if (!hyscan_buffer_import (reference, raw))
+    g_error ("can't import reference data");
+
+  reference_data = hyscan_buffer_get (reference, NULL, &reference_size);
+
+  for (i = 0; i < sizeof (simd_levels) / sizeof (HyScanBufferSimd); i++)
+    {
+      if (!hyscan_buffer_set_simd (simd_levels[i]))
+        continue;
+
+      if (!hyscan_buffer_import (vector, raw))
+        g_error ("can't import data with simd %d", simd_levels[i]);
+
+      vector_data = hyscan_buffer_get (vector, NULL, &vector_size);
+      if ((vector_size != reference_size) || (memcmp (vector_data, reference_data, vector_size) != 0))
+        g_error ("simd %d import mismatch", simd_levels[i]);
+    }
+
+  /* Импорт амплитуды. */
+  hyscan_buffer_set_simd (HYSCAN_BUFFER_SIMD_NONE);
+  if (hyscan_buffer_import_amplitude (reference, raw))
+    {
+      reference_data = hyscan_buffer_get (reference, NULL, &reference_size);
+
+      for (i = 0; i < sizeof (simd_levels) / sizeof (HyScanBufferSimd); i++)
+        {
+          gfloat *reference_values = reference_data;
+          gfloat *vector_values;
+          guint32 j;
+
+          if (!hyscan_buffer_set_simd (simd_levels[i]))
+            continue;
+
+          if (!hyscan_buffer_import_amplitude (vector, raw))
+            g_error ("can't import amplitude with simd %d", simd_levels[i]);
+
+          vector_values = hyscan_buffer_get (vector, NULL, &vector_size);
+          if (vector_size != reference_size)
+            g_error ("simd %d amplitude size mismatch", simd_levels[i]);
+
+          /* Значения NaN могут отличаться содержимым мантиссы. */
+          for (j = 0; j < vector_size / sizeof (gfloat); j++)
+            {
+              if (isnan (reference_values[j]) && isnan (vector_values[j]))
+                continue;
+
+              if (memcmp (&reference_values[j], &vector_values[j], sizeof (gfloat)) != 0)
+                g_error ("simd %d amplitude mismatch", simd_levels[i]);
+            }
+        }
+    }
+
+  hyscan_buffer_set_simd (simd);
+
+  g_object_unref (reference);
+  g_object_unref (vector);
+}
+
+/* Функция проверяет векторные функции на произвольных данных, размер
+ * которых не кратен размеру вектора, а адрес не выровнен. */
+static void
+check_simd_random (HyScanDataType type)
+{
+  HyScanBuffer *raw;
+  guint8 *data;
+  guint32 size;
+  guint32 i;
+
+  raw = hyscan_buffer_new ();
+
+  size = N_RANDOM_POINTS * hyscan_data_get_point_size (type);
+  data = g_malloc (size + 1);
+  for (i = 0; i < size; i++)
+    data[i + 1] = g_random_int ();
+
+  hyscan_buffer_wrap (raw, type, data + 1, size);
+  check_simd_import (raw);
+
+  g_object_unref (raw);
+  g_free (data);
+}
+
+/* Функция проверяет побитное совпадение результатов экспорта данных
+ * векторными и скалярными функциями. */
+static void
+check_simd_export (HyScanBuffer   *buffer,
+                   HyScanDataType  type)
+{
+  HyScanBuffer *reference;
+  HyScanBuffer *vector;
+  HyScanBufferSimd simd;
+
+  gpointer reference_data;
+  gpointer vector_data;
+  guint32 reference_size;
+  guint32 vector_size;
+
+  guint i;
+
+  reference = hyscan_buffer_new ();
+  vector = hyscan_buffer_new ();
+  simd = hyscan_buffer_get_simd ();
+
+  hyscan_buffer_set_simd (HYSCAN_BUFFER_SIMD_NONE);
+  if (!hyscan_buffer_export (buffer, reference, type))
+    g_error ("can't export reference data");
+
+  reference_data = hyscan_buffer_get (reference, NULL, &reference_size);
+
+  for (i = 0; i < sizeof (simd_levels) / sizeof (HyScanBufferSimd); i++)
+    {
+      if (!hyscan_buffer_set_simd (simd_levels[i]))
+        continue;
+
+      if (!hyscan_buffer_export (buffer, vector, type))
+        g_error ("can't export data with simd %d", simd_levels[i]);
+
+      vector_data = hyscan_buffer_get (vector, NULL, &vector_size);
+      if ((vector_size != reference_size) || (memcmp (vector_data, reference_data, vector_size) != 0))
+        g_error ("simd %d export mismatch", simd_levels[i]);
+    }
+
+  hyscan_buffer_set_simd (simd);
+
+  g_object_unref (reference);
+  g_object_unref (vector);
+}
+
+/* Функция проверяет векторные функции экспорта на произвольных значениях,
+ * включая выходящие за допустимый диапазон, бесконечности и денормализованные
+ * числа. Значения NaN используются только для форматов с плавающей точкой,
+ * для целочисленных форматов их преобразование не определено. */
+static void
+check_simd_random_export (HyScanDataType float_type,
+                          HyScanDataType type)
+{
+  HyScanBuffer *buffer;
+  gfloat *values;
+  guint32 n_values;
+  guint32 size;
+  guint32 i;
+
+  const gfloat special_values[] = { 0.0f, -0.0f, 1.0f, -1.0f, 2.0f, -2.0f,
+                                    INFINITY, -INFINITY, 65535.0f, 65536.0f, -65536.0f,
+                                    5.9604645e-8f, 6.1035156e-5f, 6.1035149e-5f, -6.1035156e-5f,
+                                    0.99999994f, 1.0000001f, -0.99999994f, -1.0000001f };
+
+  gboolean nan;
+
+  switch (type)
+    {
+    case HYSCAN_DATA_FLOAT:
+    case HYSCAN_DATA_FLOAT16LE:
+    case HYSCAN_DATA_FLOAT32LE:
+    case HYSCAN_DATA_AMPLITUDE_FLOAT16LE:
+    case HYSCAN_DATA_AMPLITUDE_FLOAT32LE:
+    case HYSCAN_DATA_COMPLEX_FLOAT:
+    case HYSCAN_DATA_COMPLEX_FLOAT16LE:
+    case HYSCAN_DATA_COMPLEX_FLOAT32LE:
+    case HYSCAN_DATA_DOA:
+    case HYSCAN_DATA_DOA_FLOAT32LE:
+      nan = TRUE;
+      break;
+
+    default:
+      nan = FALSE;
+    }
+
+  buffer = hyscan_buffer_new ();
+
+  size = N_RANDOM_POINTS * hyscan_data_get_point_size (float_type);
+  n_values = size / sizeof (gfloat);
+  values = g_malloc (size + sizeof (gfloat));
+  for (i = 0; i < n_values; i++)
+    {
+      union { guint32 code; gfloat value; } random;
+
+      random.code = g_random_int ();
+      if ((i % 2) || (!nan && isnan (random.value)))
+        random.value = g_random_double_range (-1.5, 1.5);
+
+      values[i + 1] = random.value;
+    }
+
+  /* Граничные значения. */
+  for (i = 0; i < G_N_ELEMENTS (special_values) && i < n_values; i++)
+    values[i + 1] = special_values[i];
+
+  hyscan_buffer_wrap (buffer, float_type, values + 1, size);
+  check_simd_export (buffer, type);
+
+  g_object_unref (buffer);
+  g_free (values);
+}
+
+/* Функция проверяет совпадение результатов параллельного и
+ * последовательного импорта и экспорта данных. */
+static void
+check_parallel (HyScanBuffer   *buffer,
+                HyScanBuffer   *raw,
+                HyScanDataType  type)
+{
+  const guint n_threads[] = { 0, 3 };
+  HyScanBuffer *reference;
+  HyScanBuffer *parallel;
+
+  gpointer reference_data;
+  gpointer parallel_data;
+  guint32 reference_size;
+  guint32 parallel_size;
+
+  guint i;
+
+  reference = hyscan_buffer_new ();
+  parallel = hyscan_buffer_new ();
+
+  for (i = 0; i < G_N_ELEMENTS (n_threads); i++)
+    {
+      if (!hyscan_buffer_import (reference, raw) ||
+          !hyscan_buffer_import_parallel (parallel, raw, n_threads[i]))
+        {
+          g_error ("can't import data");
+        }
+
+      reference_data = hyscan_buffer_get (reference, NULL, &reference_size);
+      parallel_data = hyscan_buffer_get (parallel, NULL, &parallel_size);
+      if ((parallel_size != reference_size) || (memcmp (parallel_data, reference_data, parallel_size) != 0))
+        g_error ("parallel import mismatch");
+
+      if (!hyscan_buffer_export (buffer, reference, type) ||
+          !hyscan_buffer_export_parallel (buffer, parallel, type, n_threads[i]))
+        {
+          g_error ("can't export data");
+        }
+
+      reference_data = hyscan_buffer_get (reference, NULL, &reference_size);
+      parallel_data = hyscan_buffer_get (parallel, NULL, &parallel_size);
+      if ((parallel_size != reference_size) || (memcmp (parallel_data, reference_data, parallel_size) != 0))
+        g_error ("parallel export mismatch");
+    }
+
+  g_object_unref (reference);
+  g_object_unref (parallel);
+}
+
+/* Функция проверяет импорт данных с преобразованием. Для ускорения
+ * проверяется только начало данных. */
+static void
+check_transform (HyScanBuffer *data)
+{
+  const HyScanBufferOp ops[] = { { HYSCAN_BUFFER_OP_OFFSET,    0.125f },
+                                 { HYSCAN_BUFFER_OP_SCALE,     2.5f },
+                                 { HYSCAN_BUFFER_OP_AMPLITUDE, 0.0f },
+                                 { HYSCAN_BUFFER_OP_DB,        20.0f } };
+  HyScanBuffer *raw;
+  HyScanBuffer *reference;
+  HyScanBuffer *transform;
+  HyScanDataType type;
+  gpointer raw_data;
+  guint32 raw_size;
+  gfloat *reference_data;
+  gfloat *transform_data;
+  guint32 n_points;
+  guint32 i;
+
+  raw = hyscan_buffer_new ();
+  reference = hyscan_buffer_new ();
+  transform = hyscan_buffer_new ();
+
+  raw_data = hyscan_buffer_get (data, &type, &raw_size);
+  raw_size = MIN (raw_size, N_RANDOM_POINTS * hyscan_data_get_point_size (type));
+  hyscan_buffer_wrap (raw, type, raw_data, raw_size);
+
+  if (!hyscan_buffer_import (reference, raw))
+    g_error ("can't import data");
+
+  /* DB недопустим для комплексных данных до вычисления амплитуды. */
+  type = hyscan_buffer_get_data_type (reference);
+  if ((type == HYSCAN_DATA_COMPLEX_FLOAT) && hyscan_buffer_import_transform (transform, raw, ops + 3, 1))
+    g_error ("transform error");
+
+  /* Импорт в буфер с исходными данными. */
+  if (hyscan_buffer_import_transform (raw, raw, ops, G_N_ELEMENTS (ops)) ||
+      hyscan_buffer_import_amplitude (raw, raw))
+    {
+      g_error ("import into raw buffer");
+    }
+
+  if (!hyscan_buffer_import_transform (transform, raw, ops, G_N_ELEMENTS (ops)))
+    g_error ("can't import data with transform");
+
+  if (hyscan_buffer_get_data_type (transform) != HYSCAN_DATA_FLOAT)
+    g_error ("transform type mismatch");
+
+  reference_data = hyscan_buffer_get_float (transform, &n_points);
+  transform_data = reference_data;
+
+  if (type == HYSCAN_DATA_COMPLEX_FLOAT)
+    {
+      HyScanComplexFloat *complex_data;
+      guint32 n_complex_points;
+
+      complex_data = hyscan_buffer_get_complex_float (reference, &n_complex_points);
+      if (n_complex_points != n_points)
+        g_error ("transform size mismatch");
+
+      for (i = 0; i < n_points; i++)
+        {
+          gfloat re = (complex_data[i].re + 0.125f) * 2.5f;
+          gfloat im = (complex_data[i].im + 0.125f) * 2.5f;
+          gfloat value = 20.0f * log10f (sqrtf (re * re + im * im));
+
+          if (memcmp (&value, &transform_data[i], sizeof (gfloat)) != 0)
+            g_error ("transform error at %d: %.12f %.12f", i, value, transform_data[i]);
+        }
+    }
+  else
+    {
+      guint32 n_float_points;
+
+      reference_data = hyscan_buffer_get_float (reference, &n_float_points);
+      if (n_float_points != n_points)
+        g_error ("transform size mismatch");
+
+      for (i = 0; i < n_points; i++)
+        {
+          gfloat value = 20.0f * log10f (fabsf ((reference_data[i] + 0.125f) * 2.5f));
+
+          if (memcmp (&value, &transform_data[i], sizeof (gfloat)) != 0)
+            g_error ("transform error at %d: %.12f %.12f", i, value, transform_data[i]);
+        }
+    }
+
+  g_object_unref (raw);
+  g_object_unref (reference);
+  g_object_unref (transform);
+}
+
+/* Функция проверяет совпадение результатов прямого преобразования данных
+ * в каждый из совместимых типов с результатом импорта и экспорта. Для
+ * ускорения проверяется только начало данных. */
+static void
+check_transcode (HyScanBuffer *data,
+                 test_info    *info,
+                 guint         n_info)
+{
+  HyScanBuffer *raw;
+  HyScanBuffer *values;
+  HyScanBuffer *reference;
+  HyScanBuffer *transcode;
+  HyScanDataType type;
+  gpointer raw_data;
+  guint32 raw_size;
+
+  gpointer reference_data;
+  gpointer transcode_data;
+  guint32 reference_size;
+  guint32 transcode_size;
+
+  guint i;
+
+  raw = hyscan_buffer_new ();
+  values = hyscan_buffer_new ();
+  reference = hyscan_buffer_new ();
+  transcode = hyscan_buffer_new ();
+
+  raw_data = hyscan_buffer_get (data, &type, &raw_size);
+  raw_size = MIN (raw_size, N_RANDOM_POINTS * hyscan_data_get_point_size (type));
+  hyscan_buffer_wrap (raw, type, raw_data, raw_size);
+
+  if (!hyscan_buffer_import (values, raw))
+    g_error ("can't import data");
+
+  for (i = 0; i < n_info; i++)
+    {
+      if (!hyscan_buffer_export (values, reference, info[i].type))
+        g_error ("can't export data");
+
+      if (!hyscan_buffer_transcode (transcode, raw, info[i].type))
+        g_error ("can't transcode data");
+
+      reference_data = hyscan_buffer_get (reference, NULL, &reference_size);
+      transcode_data = hyscan_buffer_get (transcode, NULL, &transcode_size);
+      if ((transcode_size != reference_size) || (memcmp (transcode_data, reference_data, transcode_size) != 0))
+        g_error ("transcode to %s mismatch", info[i].name);
+    }
+
+  /* Несовместимые типы. */
+  if (hyscan_buffer_transcode (transcode, raw, HYSCAN_DATA_DOA_FLOAT32LE) &&
+      (hyscan_buffer_get_data_type (values) != HYSCAN_DATA_DOA))
+    {
+      g_error ("transcode to incompatible type");
+    }
+
+  g_object_unref (raw);
+  g_object_unref (values);
+  g_object_unref (reference);
+  g_object_unref (transcode);
+}
+
+/* Функция проверяет импорт части данных и импорт с прореживанием. Для
+ * ускорения проверяется только начало данных. */
+static void
+check_decimation (HyScanBuffer *data)
+{
+  const guint32 factors[] = { 1, 7, 1000 };
+  HyScanBuffer *raw;
+  HyScanBuffer *reference;
+  HyScanBuffer *decimated;
+  HyScanDataType type;
+  gpointer raw_data;
+  guint32 raw_size;
+
+  gfloat *reference_data;
+  gfloat *decimated_data;
+  guint32 reference_size;
+  guint32 decimated_size;
+  guint32 n_values;
+  guint32 n_points;
+
+  guint32 i, j, k;
+
+  raw = hyscan_buffer_new ();
+  reference = hyscan_buffer_new ();
+  decimated = hyscan_buffer_new ();
+
+  raw_data = hyscan_buffer_get (data, &type, &raw_size);
+  raw_size = MIN (raw_size, N_RANDOM_POINTS * hyscan_data_get_point_size (type));
+  hyscan_buffer_wrap (raw, type, raw_data, raw_size);
+
+  if (!hyscan_buffer_import (reference, raw))
+    g_error ("can't import data");
+
+  reference_data = hyscan_buffer_get (reference, &type, &reference_size);
+  n_values = hyscan_data_get_point_size (type) / sizeof (gfloat);
+  n_points = reference_size / hyscan_data_get_point_size (type);
+
+  /* Импорт части данных. */
+  if (!hyscan_buffer_import_range (decimated, raw, 13, 1000))
+    g_error ("can't import range");
+
+  decimated_data = hyscan_buffer_get (decimated, NULL, &decimated_size);
+  if ((decimated_size != 1000 * n_values * sizeof (gfloat)) ||
+      (memcmp (decimated_data, reference_data + 13 * n_values, decimated_size) != 0))
+    {
+      g_error ("range mismatch");
+    }
+
+  if (!hyscan_buffer_import_range (decimated, raw, n_points - 10, 1000))
+    g_error ("can't import range");
+
+  if (hyscan_buffer_get_data_size (decimated) != 10 * n_values * sizeof (gfloat))
+    g_error ("range size mismatch");
+
+  if (hyscan_buffer_import_range (decimated, raw, n_points + 1, 1))
+    g_error ("range out of data");
+
+  /* Импорт в буфер с исходными данными. */
+  if (hyscan_buffer_import_range (raw, raw, 0, n_points) ||
+      hyscan_buffer_import_decimated (raw, raw, 1, HYSCAN_BUFFER_DECIMATION_STRIDE))
+    {
+      g_error ("import into raw buffer");
+    }
+
+  /* Импорт с прореживанием. */
+  for (i = 0; i < G_N_ELEMENTS (factors); i++)
+    {
+      guint32 factor = factors[i];
+      guint32 n_groups = (n_points + factor - 1) / factor;
+
+      if (!hyscan_buffer_import_decimated (decimated, raw, factor, HYSCAN_BUFFER_DECIMATION_STRIDE))
+        g_error ("can't import decimated data");
+
+      decimated_data = hyscan_buffer_get (decimated, NULL, &decimated_size);
+      if (decimated_size != n_groups * n_values * sizeof (gfloat))
+        g_error ("decimated size mismatch");
+
+      for (j = 0; j < n_groups; j++)
+        if (memcmp (decimated_data + j * n_values, reference_data + j * factor * n_values, n_values * sizeof (gfloat)) != 0)
+          g_error ("stride decimation mismatch at %d", j);
+
+      if (!hyscan_buffer_import_decimated (decimated, raw, factor, HYSCAN_BUFFER_DECIMATION_MAX))
+        g_error ("can't import decimated data");
+
+      decimated_data = hyscan_buffer_get (decimated, NULL, &decimated_size);
+      if (decimated_size != n_groups * n_values * sizeof (gfloat))
+        g_error ("decimated size mismatch");
+
+      for (j = 0; j < n_groups; j++)
+        {
+          guint32 best = j * factor;
+
+          for (k = j * factor; k < MIN ((j + 1) * factor, n_points); k++)
+            {
+              gfloat *point = reference_data + k * n_values;
+              gfloat *best_point = reference_data + best * n_values;
+              gfloat metric, best_metric;
+
+              if (n_values == 2)
+                {
+                  metric = point[0] * point[0] + point[1] * point[1];
+                  best_metric = best_point[0] * best_point[0] + best_point[1] * best_point[1];
+                }
+              else if (n_values == 1)
+                {
+                  metric = fabsf (point[0]);
+                  best_metric = fabsf (best_point[0]);
+                }
+              else
+                {
+                  metric = point[n_values - 1];
+                  best_metric = best_point[n_values - 1];
+                }
+
+              if (metric > best_metric)
+                best = k;
+            }
+
+          if (memcmp (decimated_data + j * n_values, reference_data + best * n_values, n_values * sizeof (gfloat)) != 0)
+            g_error ("max decimation mismatch at %d", j);
+        }
+
+      if (!hyscan_buffer_import_decimated (decimated, raw, factor, HYSCAN_BUFFER_DECIMATION_MEAN))
+        g_error ("can't import decimated data");
+
+      decimated_data = hyscan_buffer_get (decimated, NULL, &decimated_size);
+      if (decimated_size != n_groups * n_values * sizeof (gfloat))
+        g_error ("decimated size mismatch");
+
+      for (j = 0; j < n_groups; j++)
+        {
+          gdouble sum[3] = { 0.0, 0.0, 0.0 };
+          guint32 count = 0;
+          guint32 l;
+
+          for (k = j * factor; k < MIN ((j + 1) * factor, n_points); k++, count++)
+            for (l = 0; l < n_values; l++)
+              sum[l] += reference_data[k * n_values + l];
+
+          for (l = 0; l < n_values; l++)
+            {
+              gfloat mean = sum[l] / count;
+
+              if (memcmp (&decimated_data[j * n_values + l], &mean, sizeof (gfloat)) != 0)
+                g_error ("mean decimation mismatch at %d", j);
+            }
+        }
+    }
+
+  g_object_unref (raw);
+  g_object_unref (reference);
+  g_object_unref (decimated);
+}
+
+/* Функция проверяет выбор отрицательного пика при прореживании. */
+static void
+check_decimation_peak (void)
+{
+  gfloat data[] = { 0.1f, -0.9f, 0.2f, 0.5f, -0.25f, 0.0f };
+  HyScanBuffer *values;
+  HyScanBuffer *raw;
+  HyScanBuffer *decimated;
+  gfloat *decimated_data;
+  guint32 n_points;
+
+  values = hyscan_buffer_new ();
+  raw = hyscan_buffer_new ();
+  decimated = hyscan_buffer_new ();
+
+  hyscan_buffer_set_float (values, data, G_N_ELEMENTS (data));
+  if (!hyscan_buffer_export (values, raw, HYSCAN_DATA_FLOAT32LE))
+    g_error ("can't export data");
+
+  if (!hyscan_buffer_import_decimated (decimated, raw, 3, HYSCAN_BUFFER_DECIMATION_MAX))
+    g_error ("can't import decimated data");
+
+  decimated_data = hyscan_buffer_get_float (decimated, &n_points);
+  if ((n_points != 2) || (decimated_data[0] != -0.9f) || (decimated_data[1] != 0.5f))
+    g_error ("negative peak mismatch");
+
+  g_object_unref (values);
+  g_object_unref (raw);
+  g_object_unref (decimated);
+}
+
+/* Функция проверяет политики увеличения памяти. */
+static void
+check_growth (void)
+{
+  HyScanBufferGrowth growths[] = { HYSCAN_BUFFER_GROWTH_EXACT,
+                                   HYSCAN_BUFFER_GROWTH_GEOMETRIC,
+                                   HYSCAN_BUFFER_GROWTH_POWER_OF_TWO };
+  guint max_allocations[] = { 1000, 32, 16 };
+  HyScanBuffer *buffer;
+  guint8 *data;
+  guint32 size;
+  guint i, j;
+
+  for (i = 0; i < G_N_ELEMENTS (growths); i++)
+    {
+      buffer = hyscan_buffer_new ();
+      hyscan_buffer_set_growth (buffer, growths[i]);
+
+      /* Медленно растущие данные. */
+      for (j = 1; j <= 1000; j++)
+        {
+          hyscan_buffer_set (buffer, HYSCAN_DATA_BLOB, NULL, 100 * j);
+          if (hyscan_buffer_get_capacity (buffer) < 100 * j)
+            g_error ("capacity error");
+        }
+
+      if (hyscan_buffer_get_n_allocations (buffer) > max_allocations[i])
+        g_error ("too many allocations %d", hyscan_buffer_get_n_allocations (buffer));
+
+      /* Уменьшение памяти до размера данных. */
+      data = hyscan_buffer_get (buffer, NULL, &size);
+      memset (data, 0x5a, size);
+      hyscan_buffer_set_data_size (buffer, 1000);
+      hyscan_buffer_shrink_to_fit (buffer);
+
+      data = hyscan_buffer_get (buffer, NULL, &size);
+      if ((hyscan_buffer_get_capacity (buffer) != 1000) || (size != 1000) ||
+          (data[0] != 0x5a) || (data[999] != 0x5a))
+        {
+          g_error ("shrink error");
+        }
+
+      /* После резервирования память не выделяется. */
+      if (!hyscan_buffer_reserve (buffer, 1000000))
+        g_error ("can't reserve memory");
+
+      j = hyscan_buffer_get_n_allocations (buffer);
+      data = hyscan_buffer_get (buffer, NULL, &size);
+      if ((hyscan_buffer_get_capacity (buffer) != 1000000) || (size != 1000) || (data[999] != 0x5a))
+        g_error ("reserve error");
+
+      for (size = 1; size <= 1000000; size += 999)
+        hyscan_buffer_set (buffer, HYSCAN_DATA_BLOB, NULL, size);
+
+      if (hyscan_buffer_get_n_allocations (buffer) != j)
+        g_error ("unexpected allocations");
+
+      g_object_unref (buffer);
+    }
+}
+
+/* Функция проверяет размещение данных в памяти mmap. */
+static void
+check_mmap (void)
+{
+  HyScanBuffer *buffer;
+  HyScanBuffer *copy;
+  guint32 threshold;
+  guint32 *values;
+  guint32 size;
+  guint32 i;
+
+  threshold = hyscan_buffer_get_mmap_threshold ();
+  hyscan_buffer_set_mmap_threshold (4 * 1024 * 1024);
+
+  buffer = hyscan_buffer_new ();
+  copy = hyscan_buffer_new ();
+
+  /* Небольшие данные размещаются в обычной памяти. */
+  hyscan_buffer_set (buffer, HYSCAN_DATA_BLOB, NULL, 1024 * 1024);
+  values = hyscan_buffer_get (buffer, NULL, &size);
+  for (i = 0; i < size / sizeof (guint32); i++)
+    values[i] = i;
+
+  if (hyscan_buffer_is_mapped (buffer))
+    g_error ("unexpected mmap storage");
+
+  /* Увеличение размера данных сохраняет их содержимое. */
+  for (size = 5 * 1024 * 1024; size <= 80 * 1024 * 1024; size *= 4)
+    {
+      if (!hyscan_buffer_set_data_size (buffer, size))
+        g_error ("can't set data size");
+
+      values = hyscan_buffer_get (buffer, NULL, &size);
+      if (!hyscan_buffer_is_mapped (buffer) ||
+          (GPOINTER_TO_SIZE (values) % HYSCAN_BUFFER_ALIGNMENT) != 0)
+        {
+          g_error ("mmap storage expected");
+        }
+
+      for (i = 0; i < 1024 * 1024 / sizeof (guint32); i++)
+        if (values[i] != i)
+          g_error ("mmap data mismatch");
+
+      values[size / sizeof (guint32) - 1] = 1;
+    }
+
+  /* Копия отображённых данных. */
+  hyscan_buffer_copy (copy, buffer);
+  values = hyscan_buffer_get (copy, NULL, &size);
+  if (!hyscan_buffer_is_mapped (copy) || (values[1024] != 1024))
+    g_error ("mmap copy error");
+
+  /* Уменьшение размера данных ниже порога. */
+  hyscan_buffer_set_data_size (buffer, 1024 * 1024);
+  hyscan_buffer_shrink_to_fit (buffer);
+  values = hyscan_buffer_get (buffer, NULL, &size);
+  if (hyscan_buffer_is_mapped (buffer) || (hyscan_buffer_get_capacity (buffer) != size))
+    g_error ("mmap shrink error");
+
+  for (i = 0; i < size / sizeof (guint32); i++)
+    if (values[i] != i)
+      g_error ("mmap data mismatch");
+
+  g_object_unref (buffer);
+  g_object_unref (copy);
+
+  hyscan_buffer_set_mmap_threshold (threshold);
+}
+
+/* Функция проверяет отображение файла в память. */
+static void
+check_map_file (void)
+{
+  HyScanBuffer *buffer;
+  HyScanBuffer *wrapper;
+  HyScanBuffer *reference;
+  HyScanBuffer *mapped;
+  HyScanBuffer *source;
+  HyScanBuffer *view;
+  guint16 *data;
+  gpointer mapped_data;
+  gchar *contents;
+  gchar *path;
+  gsize length;
+  gconstpointer values1;
+  gconstpointer values2;
+  guint32 size1;
+  guint32 size2;
+  guint32 offset;
+  guint32 size;
+  guint32 i;
+
+  buffer = hyscan_buffer_new ();
+  wrapper = hyscan_buffer_new ();
+  reference = hyscan_buffer_new ();
+  mapped = hyscan_buffer_new ();
+
+  /* Файл с отсчётами АЦП, расположенными с невыровненного смещения. */
+  offset = 12345;
+  size = N_RANDOM_POINTS * sizeof (guint16);
+  data = g_malloc (offset + size);
+  for (i = 0; i < (offset + size) / sizeof (guint16); i++)
+    data[i] = g_random_int ();
+
+  path = g_build_filename (g_get_tmp_dir (), "hyscan-buffer-test.bin", NULL);
+  if (!g_file_set_contents (path, (gchar*)data, offset + size, NULL))
+    g_error ("can't write test file");
+
+  /* Импорт данных из файла. */
+  if (!hyscan_buffer_map_file (mapped, HYSCAN_DATA_ADC16LE, path, offset, size))
+    g_error ("can't map file");
+
+  hyscan_buffer_wrap (wrapper, HYSCAN_DATA_ADC16LE, (guint8*)data + offset, size);
+  if (!hyscan_buffer_import (reference, wrapper) || !hyscan_buffer_import (buffer, mapped))
+    g_error ("can't import data");
+
+  values1 = hyscan_buffer_peek (reference, NULL, &size1);
+  values2 = hyscan_buffer_peek (buffer, NULL, &size2);
+  if ((size1 != size2) || (memcmp (values1, values2, size1) != 0))
+    g_error ("mapped file import mismatch");
+
+  /* Область до конца файла. */
+  if (!hyscan_buffer_map_file (mapped, HYSCAN_DATA_ADC16LE, path, offset, 0) ||
+      (hyscan_buffer_get_data_size (mapped) != size))
+    {
+      g_error ("can't map file tail");
+    }
+
+  /* Изменение данных не затрагивает файл. */
+  mapped_data = hyscan_buffer_get (mapped, NULL, &size1);
+  memset (mapped_data, 0, size1);
+  if (!g_file_get_contents (path, &contents, &length, NULL) ||
+      (length != offset + size) || (memcmp (contents, data, length) != 0))
+    {
+      g_error ("mapped file modified");
+    }
+
+  /* Области за пределами файла. */
+  if (hyscan_buffer_map_file (mapped, HYSCAN_DATA_ADC16LE, path, offset + size + 1, 0) ||
+      hyscan_buffer_map_file (mapped, HYSCAN_DATA_ADC16LE, path, offset, size + 1))
+    {
+      g_error ("mapped out of file");
+    }
+
+  /* Представление области файла остаётся доступным после удаления буфера,
+   * отобразившего её. Смещение выровнено для создания представления. */
+  source = hyscan_buffer_new ();
+  view = hyscan_buffer_new ();
+
+  hyscan_buffer_wrap (wrapper, HYSCAN_DATA_FLOAT32LE, (guint8*)data + offset - 1, size);
+  if (!hyscan_buffer_map_file (source, HYSCAN_DATA_FLOAT32LE, path, offset - 1, size) ||
+      !hyscan_buffer_import (reference, wrapper) || !hyscan_buffer_import_view (view, source, NULL))
+    {
+      g_error ("can't import mapped file view");
+    }
+
+  g_object_unref (source);
+
+  values1 = hyscan_buffer_peek (reference, NULL, &size1);
+  values2 = hyscan_buffer_peek (view, NULL, &size2);
+  if ((size1 != size2) || (memcmp (values1, values2, size1) != 0))
+    g_error ("mapped file view mismatch");
+
+  values2 = hyscan_buffer_get (view, NULL, &size2);
+  if ((size1 != size2) || (memcmp (values1, values2, size1) != 0))
+    g_error ("mapped file view mismatch");
+
+  g_object_unref (view);
+
+  /* Переход в режим выделения памяти. */
+  hyscan_buffer_set (mapped, HYSCAN_DATA_BLOB, NULL, 0);
+  g_remove (path);
+
+  g_object_unref (buffer);
+  g_object_unref (wrapper);
+  g_object_unref (reference);
+  g_object_unref (mapped);
+  g_free (contents);
+  g_free (path);
+  g_free (data);
+}
+
+/* Функция проверяет выравнивание данных. */
+static void
+check_alignment (void)
+{
+  HyScanBuffer *buffer;
+  guint8 data[256];
+  guint8 *aligned;
+  guint8 *values;
+  guint32 size;
+  guint32 i;
+
+  buffer = hyscan_buffer_new ();
+
+  for (i = 0; i < sizeof (data); i++)
+    data[i] = i;
+
+  /* Увеличение размера сохраняет выравнивание и данные. */
+  hyscan_buffer_set (buffer, HYSCAN_DATA_BLOB, data, sizeof (data));
+  for (i = 1; i <= 1024 * 1024; i *= 3)
+    {
+      if (!hyscan_buffer_set_data_size (buffer, i + sizeof (data)))
+        g_error ("can't set data size");
+
+      values = hyscan_buffer_get (buffer, NULL, &size);
+      if ((GPOINTER_TO_SIZE (values) % HYSCAN_BUFFER_ALIGNMENT) != 0)
+        g_error ("data alignment error");
+      if (hyscan_buffer_get_alignment (buffer) != HYSCAN_BUFFER_ALIGNMENT)
+        g_error ("alignment query error");
+      if (memcmp (values, data, sizeof (data)) != 0)
+        g_error ("data lost on resize");
+    }
+
+  /* Выравнивание внешних данных. */
+  aligned = data + (HYSCAN_BUFFER_ALIGNMENT - GPOINTER_TO_SIZE (data) % HYSCAN_BUFFER_ALIGNMENT) % HYSCAN_BUFFER_ALIGNMENT;
+
+  hyscan_buffer_wrap (buffer, HYSCAN_DATA_BLOB, aligned + 1, 16);
+  if (hyscan_buffer_get_alignment (buffer) != 1)
+    g_error ("wrapper alignment error");
+
+  hyscan_buffer_wrap (buffer, HYSCAN_DATA_BLOB, aligned + 8, 16);
+  if (hyscan_buffer_get_alignment (buffer) != 8)
+    g_error ("wrapper alignment error");
+
+  hyscan_buffer_wrap (buffer, HYSCAN_DATA_BLOB, aligned, 16);
+  if (hyscan_buffer_get_alignment (buffer) != HYSCAN_BUFFER_ALIGNMENT)
+    g_error ("wrapper alignment error");
+
+  g_object_unref (buffer);
+}
+
+/* Функция проверяет совместное использование памяти копиями буфера. */
+static void
+check_shared (void)
+{
+  HyScanBuffer *orig;
+  HyScanBuffer *copy;
+  gfloat data[16];
+  gconstpointer orig_data;
+  gconstpointer copy_data;
+  gfloat *orig_values;
+  gfloat *copy_values;
+  guint32 orig_size;
+  guint32 copy_size;
+  guint32 n_points;
+  guint i;
+
+  orig = hyscan_buffer_new ();
+  copy = hyscan_buffer_new ();
+
+  for (i = 0; i < G_N_ELEMENTS (data); i++)
+    data[i] = i;
+
+  hyscan_buffer_set_float (orig, data, G_N_ELEMENTS (data));
+  hyscan_buffer_copy (copy, orig);
+
+  /* Копия использует память оригинала. */
+  orig_data = hyscan_buffer_peek (orig, NULL, &orig_size);
+  copy_data = hyscan_buffer_peek (copy, NULL, &copy_size);
+  if ((orig_data != copy_data) || (orig_size != copy_size))
+    g_error ("shared storage expected");
+
+  /* Изменение копии не затрагивает оригинал. */
+  copy_values = hyscan_buffer_get_float (copy, &n_points);
+  if ((copy_values == orig_data) || (n_points != G_N_ELEMENTS (data)))
+    g_error ("storage detach failed");
+
+  for (i = 0; i < n_points; i++)
+    copy_values[i] = -copy_values[i];
+
+  orig_values = hyscan_buffer_get_float (orig, &n_points);
+  if ((orig_values != orig_data) || (memcmp (orig_values, data, sizeof (data)) != 0))
+    g_error ("original data modified");
+
+  /* Изменение размера совместно используемых данных. */
+  hyscan_buffer_copy (copy, orig);
+  if (!hyscan_buffer_set_data_size (copy, sizeof (data) / 2))
+    g_error ("can't set data size");
+
+  orig_values = hyscan_buffer_get_float (orig, &n_points);
+  copy_values = hyscan_buffer_get_float (copy, &copy_size);
+  if ((n_points != G_N_ELEMENTS (data)) || (copy_size != n_points / 2) ||
+      (orig_values == copy_values) || (memcmp (copy_values, data, sizeof (data) / 2) != 0))
+    {
+      g_error ("shared data resize failed");
+    }
+
+  /* Освобождение оригинала не затрагивает копию. */
+  hyscan_buffer_copy (copy, orig);
+  g_object_unref (orig);
+
+  copy_values = hyscan_buffer_get_float (copy, &n_points);
+  if ((copy_values != copy_data) || (memcmp (copy_values, data, sizeof (data)) != 0))
+    g_error ("shared data lost");
+
+  g_object_unref (copy);
+}
+
+/* Функция проверяет импорт данных без копирования. */
+static void
+check_view (HyScanBuffer *raw)
+{
+  HyScanBuffer *reference;
+  HyScanBuffer *view;
+  HyScanBuffer *stored;
+  HyScanBuffer *shared;
+  HyScanBuffer *sources[2];
+  HyScanDataType type;
+  gboolean is_view;
+
+  gpointer raw_data;
+  gpointer saved_data;
+  gpointer reference_data;
+  gconstpointer shared_data;
+  gconstpointer view_data;
+  gpointer changed_data;
+  guint32 raw_size;
+  guint32 reference_size;
+  guint32 shared_size;
+  guint32 view_size;
+  guint i;
+
+  reference = hyscan_buffer_new ();
+  view = hyscan_buffer_new ();
+  stored = hyscan_buffer_new ();
+  shared = hyscan_buffer_new ();
+
+  raw_data = hyscan_buffer_get (raw, &type, &raw_size);
+  if (!hyscan_buffer_import (reference, raw) || !hyscan_buffer_import_view (view, raw, &is_view))
+    g_error ("can't import data");
+
+  reference_data = hyscan_buffer_get (reference, NULL, &reference_size);
+  view_data = hyscan_buffer_peek (view, NULL, &view_size);
+  if ((view_size != reference_size) || (memcmp (view_data, reference_data, view_size) != 0))
+    g_error ("view import mismatch");
+
+  if ((type == HYSCAN_DATA_FLOAT) ||
+      (type == HYSCAN_DATA_COMPLEX_FLOAT) ||
+      (type == HYSCAN_DATA_DOA)
+#if G_BYTE_ORDER == G_LITTLE_ENDIAN
+      || (type == HYSCAN_DATA_FLOAT32LE)
+      || (type == HYSCAN_DATA_COMPLEX_FLOAT32LE)
+      || (type == HYSCAN_DATA_AMPLITUDE_FLOAT32LE)
+      || (type == HYSCAN_DATA_DOA_FLOAT32LE)
+#endif
+     )
+    {
+      if (!is_view || (view_data != raw_data))
+        g_error ("view expected");
+    }
+  else if (is_view || (view_data == raw_data))
+    {
+      g_error ("copy expected");
+    }
+
+  /* Повторный импорт в буфер-представление. */
+  if (!hyscan_buffer_import (view, raw))
+    g_error ("can't import data");
+
+  view_data = hyscan_buffer_get (view, NULL, &view_size);
+  if ((view_data == raw_data) || (memcmp (view_data, reference_data, view_size) != 0))
+    g_error ("view reimport mismatch");
+
+  /* Изменение представления не затрагивает исходные данные и их копии. */
+  saved_data = g_malloc (raw_size);
+  memcpy (saved_data, raw_data, raw_size);
+  hyscan_buffer_copy (stored, raw);
+  hyscan_buffer_copy (shared, stored);
+  sources[0] = raw;
+  sources[1] = stored;
+
+  for (i = 0; i < G_N_ELEMENTS (sources); i++)
+    {
+      if (!hyscan_buffer_import_view (view, sources[i], NULL))
+        g_error ("can't import data");
+
+      changed_data = hyscan_buffer_get (view, NULL, &view_size);
+      memset (changed_data, 0xff, view_size);
+
+      if (!hyscan_buffer_import_view (view, sources[i], NULL))
+        g_error ("can't import data");
+
+      hyscan_buffer_export_in_place (view, HYSCAN_DATA_AMPLITUDE_INT8);
+
+      raw_data = hyscan_buffer_get (raw, NULL, &raw_size);
+      shared_data = hyscan_buffer_peek (shared, NULL, &shared_size);
+      if ((memcmp (raw_data, saved_data, raw_size) != 0) ||
+          (shared_size != raw_size) || (memcmp (shared_data, saved_data, raw_size) != 0))
+        {
+          g_error ("view modified original data");
+        }
+    }
+
+  g_free (saved_data);
+
+  g_object_unref (reference);
+  g_object_unref (view);
+  g_object_unref (stored);
+  g_object_unref (shared);
+}
+
+/* Функция проверяет импорт и экспорт данных на месте. */
+static void
+check_in_place (HyScanBuffer *data)
+{
+  HyScanBuffer *raw;
+  HyScanBuffer *reference;
+  HyScanBuffer *in_place;
+  HyScanDataType type;
+  gpointer raw_data;
+  guint32 raw_size;
+
+  gpointer reference_data;
+  gpointer in_place_data;
+  guint32 reference_size;
+  guint32 in_place_size;
+
+  raw = hyscan_buffer_new ();
+  reference = hyscan_buffer_new ();
+  in_place = hyscan_buffer_new ();
+
+  raw_data = hyscan_buffer_get (data, &type, &raw_size);
+  raw_size = MIN (raw_size, N_RANDOM_POINTS * hyscan_data_get_point_size (type));
+  hyscan_buffer_wrap (raw, type, raw_data, raw_size);
+
+  /* Импорт. */
+  hyscan_buffer_copy (in_place, raw);
+  if (!hyscan_buffer_import (reference, raw) || !hyscan_buffer_import_in_place (in_place))
+    g_error ("can't import data");
+
+  reference_data = hyscan_buffer_get (reference, NULL, &reference_size);
+  in_place_data = hyscan_buffer_get (in_place, NULL, &in_place_size);
+  if ((in_place_size != reference_size) || (memcmp (in_place_data, reference_data, in_place_size) != 0))
+    g_error ("in place import mismatch");
+
+  /* Экспорт. */
+  if (!hyscan_buffer_export (reference, raw, type) || !hyscan_buffer_export_in_place (in_place, type))
+    g_error ("can't export data");
+
+  reference_data = hyscan_buffer_get (raw, NULL, &reference_size);
+  in_place_data = hyscan_buffer_get (in_place, NULL, &in_place_size);
+  if ((in_place_size != reference_size) || (memcmp (in_place_data, reference_data, in_place_size) != 0))
+    g_error ("in place export mismatch");
+
+  g_object_unref (raw);
+  g_object_unref (reference);
+  g_object_unref (in_place);
+}
+
+/* Функция проверяет импорт и экспорт данных, разделённых на сегменты. */
+static void
+check_segments (HyScanBuffer *data)
+{
+  static const guint32 sizes[] = { 1, 3, 7, 2, 64, 5, 1000, 13, 6, 4093 };
+
+  HyScanBuffer *raw;
+  HyScanBuffer *segmented;
+  HyScanBuffer *reference;
+  HyScanBuffer *values;
+  HyScanDataType type;
+  guint8 *raw_data;
+  guint8 *segmented_data;
+  guint32 raw_size;
+
+  gconstpointer reference_data;
+  gconstpointer values_data;
+  guint32 reference_size;
+  guint32 values_size;
+  guint32 offset;
+  guint n_segments;
+
+  raw = hyscan_buffer_new ();
+  segmented = hyscan_buffer_new ();
+  reference = hyscan_buffer_new ();
+  values = hyscan_buffer_new ();
+
+  raw_data = hyscan_buffer_get (data, &type, &raw_size);
+  raw_size = MIN (raw_size, N_RANDOM_POINTS * hyscan_data_get_point_size (type));
+  hyscan_buffer_wrap (raw, type, raw_data, raw_size);
+
+  /* Сегменты разного размера, в том числе меньше одной точки. */
+  hyscan_buffer_wrap_segments (segmented, type, NULL, 0);
+  for (offset = 0, n_segments = 0; offset < raw_size; n_segments++)
+    {
+      guint32 size = MIN (sizes[n_segments % G_N_ELEMENTS (sizes)], raw_size - offset);
+
+      if (!hyscan_buffer_append_segment (segmented, raw_data + offset, size))
+        g_error ("can't append segment");
+
+      offset += size;
+    }
+
+  if ((hyscan_buffer_get_n_segments (segmented) != n_segments) ||
+      (hyscan_buffer_get_data_size (segmented) != raw_size))
+    {
+      g_error ("segments size mismatch");
+    }
+
+  /* Импорт. */
+  if (!hyscan_buffer_import (reference, raw) || !hyscan_buffer_import (values, segmented))
+    g_error ("can't import data");
+
+  reference_data = hyscan_buffer_peek (reference, NULL, &reference_size);
+  values_data = hyscan_buffer_peek (values, NULL, &values_size);
+  if ((values_size != reference_size) || (memcmp (values_data, reference_data, values_size) != 0))
+    g_error ("segmented import mismatch");
+
+  /* Экспорт в сегменты той же структуры. */
+  segmented_data = g_malloc0 (raw_size);
+  hyscan_buffer_wrap_segments (segmented, type, NULL, 0);
+  for (offset = 0, n_segments = 0; offset < raw_size; n_segments++)
+    {
+      guint32 size = MIN (sizes[n_segments % G_N_ELEMENTS (sizes)], raw_size - offset);
+
+      hyscan_buffer_append_segment (segmented, segmented_data + offset, size);
+      offset += size;
+    }
+
+  if (!hyscan_buffer_export (reference, raw, type) || !hyscan_buffer_export (values, segmented, type))
+    g_error ("can't export data");
+
+  if (hyscan_buffer_get_n_segments (segmented) != n_segments)
+    g_error ("segments lost on export");
+
+  if (memcmp (segmented_data, raw_data, raw_size) != 0)
+    g_error ("segmented export mismatch");
+
+  /* Сборка сегментов для непрерывного доступа. */
+  values_data = hyscan_buffer_peek (segmented, NULL, &values_size);
+  if ((hyscan_buffer_get_n_segments (segmented) != 0) || (values_size != raw_size) ||
+      (memcmp (values_data, raw_data, raw_size) != 0))
+    {
+      g_error ("segments gather mismatch");
+    }
+
+  /* Копирование в буфер, являющийся обёрткой над сегментами. */
+  memset (segmented_data, 0, raw_size);
+  hyscan_buffer_wrap_segments (segmented, type, NULL, 0);
+  hyscan_buffer_append_segment (segmented, segmented_data, raw_size);
+  hyscan_buffer_copy (segmented, values);
+
+  reference_data = hyscan_buffer_peek (values, NULL, &reference_size);
+  values_data = hyscan_buffer_peek (segmented, NULL, &values_size);
+  if ((hyscan_buffer_get_n_segments (segmented) != 0) || (values_size != reference_size) ||
+      (memcmp (values_data, reference_data, values_size) != 0))
+    {
+      g_error ("segmented copy mismatch");
+    }
+
+  g_free (segmented_data);
+
+  g_object_unref (raw);
+  g_object_unref (segmented);
+  g_object_unref (reference);
+  g_object_unref (values);
+}
+
+/* Функция проверяет импорт нескольких строк данных в матрицу. */
+static void
+check_batch (HyScanBuffer *data)
+{
+  HyScanBuffer *raws[7];
+  HyScanBuffer *line;
+  HyScanBuffer *matrix;
+  HyScanDataType type;
+  guint8 *raw_data;
+  guint32 raw_size;
+  guint32 point_size;
+  guint32 parallel_threshold;
+  guint layout;
+  guint i;
+
+  line = hyscan_buffer_new ();
+  matrix = hyscan_buffer_new ();
+
+  /* Строки данных разной длины. */
+  raw_data = hyscan_buffer_get (data, &type, &raw_size);
+  point_size = hyscan_data_get_point_size (type);
+  for (i = 0; i < G_N_ELEMENTS (raws); i++)
+    {
+      guint32 n_points = MIN (1000 + 997 * i, raw_size / point_size - 131 * i);
+
+      raws[i] = hyscan_buffer_new ();
+      hyscan_buffer_wrap (raws[i], type, raw_data + (gsize)131 * i * point_size, n_points * point_size);
+    }
+
+  /* Импорт в нескольких потоках. */
+  parallel_threshold = hyscan_buffer_get_parallel_threshold ();
+  hyscan_buffer_set_parallel_threshold (1);
+
+  for (layout = HYSCAN_BUFFER_LAYOUT_ROW_MAJOR; layout <= HYSCAN_BUFFER_LAYOUT_COLUMN_MAJOR; layout++)
+    {
+      const guint32 n_points = 5000;
+      const guint32 stride = (layout == HYSCAN_BUFFER_LAYOUT_ROW_MAJOR) ? n_points + 3 : G_N_ELEMENTS (raws) + 2;
+      const gfloat *matrix_data;
+      guint32 matrix_size;
+      guint n_values;
+      guint n_allocations;
+
+      n_allocations = hyscan_buffer_get_n_allocations (matrix);
+      if (!hyscan_buffer_import_batch (matrix, raws, G_N_ELEMENTS (raws), n_points, stride, layout, 4))
+        g_error ("can't import batch");
+
+      matrix_data = hyscan_buffer_peek (matrix, NULL, &matrix_size);
+      n_values = hyscan_data_get_point_size (hyscan_buffer_get_data_type (matrix)) / sizeof (gfloat);
+      if ((hyscan_buffer_get_n_allocations (matrix) > n_allocations + 1) ||
+          (matrix_size != ((layout == HYSCAN_BUFFER_LAYOUT_ROW_MAJOR) ? G_N_ELEMENTS (raws) : n_points) *
+                          stride * n_values * sizeof (gfloat)))
+        {
+          g_error ("batch matrix size error");
+        }
+
+      /* Каждая строка матрицы совпадает с импортом строки данных. */
+      for (i = 0; i < G_N_ELEMENTS (raws); i++)
+        {
+          const gfloat *values;
+          guint32 n_line_values;
+          guint32 j;
+
+          hyscan_buffer_import (line, raws[i]);
+          values = hyscan_buffer_peek (line, NULL, &n_line_values);
+          n_line_values /= sizeof (gfloat);
+
+          for (j = 0; j < n_points * n_values; j++)
+            {
+              gfloat value = (j < n_line_values) ? values[j] : 0.0f;
+              gsize index;
+
+              if (layout == HYSCAN_BUFFER_LAYOUT_ROW_MAJOR)
+                index = (gsize)i * stride * n_values + j;
+              else
+                index = ((gsize)(j / n_values) * stride + i) * n_values + j % n_values;
+
+              if (memcmp (&matrix_data[index], &value, sizeof (gfloat)) != 0)
+                g_error ("batch data mismatch at %d:%d", i, j);
+            }
+        }
+
+      /* Точки матрицы за пределами строк. */
+      for (i = 0; i < matrix_size / sizeof (gfloat); i++)
+        {
+          guint32 point = i / n_values;
+          gboolean padding;
+
+          if (layout == HYSCAN_BUFFER_LAYOUT_ROW_MAJOR)
+            padding = (point % stride) >= n_points;
+          else
+            padding = (point % stride) >= G_N_ELEMENTS (raws);
+
+          if (padding && (matrix_data[i] != 0.0f))
+            g_error ("batch padding error");
+        }
+    }
+
+  hyscan_buffer_set_parallel_threshold (parallel_threshold);
+
+  /* Строки, импортируемые в разные типы данных, не объединяются. */
+  if (hyscan_buffer_get_data_type (matrix) != HYSCAN_DATA_DOA)
+    {
+      HyScanBuffer *mixed[2] = { line, raws[0] };
+
+      hyscan_buffer_set_doa (line, NULL, 1);
+      if (hyscan_buffer_import_batch (matrix, mixed, 2, 0, 0, HYSCAN_BUFFER_LAYOUT_ROW_MAJOR, 1))
+        g_error ("mixed batch accepted");
+    }
+
+  for (i = 0; i < G_N_ELEMENTS (raws); i++)
+    g_object_unref (raws[i]);
+
+  g_object_unref (line);
+  g_object_unref (matrix);
+}
+
+/* Функция проверяет импорт комплексных и пространственных данных в
+ * отдельные массивы компонент точек. */
+static void
+check_planar (HyScanBuffer *raw)
+{
+  HyScanBuffer *reference;
+  HyScanBuffer *planes[3];
+  const gfloat *reference_data;
+  guint32 reference_size;
+  guint n_values;
+  guint n_points;
+  guint pass;
+  guint i, j;
+
+  reference = hyscan_buffer_new ();
+  for (i = 0; i < G_N_ELEMENTS (planes); i++)
+    planes[i] = hyscan_buffer_new ();
+
+  if (!hyscan_buffer_import (reference, raw))
+    g_error ("can't import data");
+
+  reference_data = hyscan_buffer_peek (reference, NULL, &reference_size);
+  n_values = hyscan_data_get_point_size (hyscan_buffer_get_data_type (reference)) / sizeof (gfloat);
+  n_points = reference_size / (n_values * sizeof (gfloat));
+
+  /* Импорт и разделение импортированных данных. */
+  for (pass = 0; pass < 2; pass++)
+    {
+      gboolean status;
+
+      if (n_values == 2)
+        {
+          status = (pass == 0) ? hyscan_buffer_import_complex_planar (planes[0], planes[1], raw) :
+                                 hyscan_buffer_get_complex_planar (reference, planes[0], planes[1]);
+        }
+      else
+        {
+          status = (pass == 0) ? hyscan_buffer_import_doa_planar (planes[0], planes[1], planes[2], raw) :
+                                 hyscan_buffer_get_doa_planar (reference, planes[0], planes[1], planes[2]);
+        }
+
+      if (!status)
+        g_error ("can't import planar data");
+
+      for (i = 0; i < n_values; i++)
+        {
+          const gfloat *values;
+          guint32 n_plane_points;
+
+          values = hyscan_buffer_get_float (planes[i], &n_plane_points);
+          if (n_plane_points != n_points)
+            g_error ("planar size mismatch");
+
+          for (j = 0; j < n_points; j++)
+            if (memcmp (&values[j], &reference_data[j * n_values + i], sizeof (gfloat)) != 0)
+              g_error ("planar data mismatch at %d:%d", i, j);
+        }
+    }
+
+  /* Одинаковые буферы компонент не допускаются. */
+  if (hyscan_buffer_import_complex_planar (planes[0], planes[0], raw) ||
+      hyscan_buffer_import_doa_planar (planes[0], planes[1], planes[0], raw))
+    {
+      g_error ("aliased planes accepted");
+    }
+
+  g_object_unref (reference);
+  for (i = 0; i < G_N_ELEMENTS (planes); i++)
+    g_object_unref (planes[i]);
+}
+
 int
 main (int    argc,
       char **argv)
@@ -109,6 +1540,13 @@ main (int    argc,
   copy = hyscan_buffer_new ();
   wrapper = hyscan_buffer_new ();
 
+  check_shared ();
+  check_alignment ();
+  check_growth ();
+  check_mmap ();
+  check_map_file ();
+  check_decimation_peak ();
+
   /* Тест форматов действительных данных. */
   for (i = 0; i < sizeof (float_test_info) / sizeof (test_info); i++)
     {
@@ -131,6 +1569,9 @@ main (int    argc,
       if (!hyscan_buffer_export (in, raw, float_test_info[i].type))
         g_error ("can't export data");
 
+      check_simd_export (in, float_test_info[i].type);
+      check_simd_random_export (HYSCAN_DATA_FLOAT, float_test_info[i].type);
+
       hyscan_buffer_copy (copy, raw);
       copy_data = hyscan_buffer_get (copy, &copy_type, &copy_size);
       if (copy_size != N_POINTS * hyscan_data_get_point_size (float_test_info[i].type))
@@ -140,6 +1581,17 @@ main (int    argc,
       if (!hyscan_buffer_import (out, wrapper))
         g_error ("can't import data");
 
+      check_simd_import (wrapper);
+      check_simd_random (copy_type);
+      check_parallel (in, wrapper, copy_type);
+      check_decimation (wrapper);
+      check_in_place (wrapper);
+      check_view (wrapper);
+      check_segments (wrapper);
+      check_batch (wrapper);
+      check_transcode (wrapper, float_test_info, G_N_ELEMENTS (float_test_info));
+      check_transform (wrapper);
+
       /* Импортированые данные. */
       float_data_out = hyscan_buffer_get_float (out, &n_points);
       if ((float_data_out == NULL) || (n_points != N_POINTS))
@@ -178,6 +1630,9 @@ main (int    argc,
       if (!hyscan_buffer_export (in, raw, complex_float_test_info[i].type))
         g_error ("can't export data");
 
+      check_simd_export (in, complex_float_test_info[i].type);
+      check_simd_random_export (HYSCAN_DATA_COMPLEX_FLOAT, complex_float_test_info[i].type);
+
       hyscan_buffer_copy (copy, raw);
       copy_data = hyscan_buffer_get (copy, &copy_type, &copy_size);
       if (copy_size != N_POINTS * hyscan_data_get_point_size (complex_float_test_info[i].type))
@@ -187,6 +1642,18 @@ main (int    argc,
       if (!hyscan_buffer_import (out, wrapper))
         g_error ("can't import data");
 
+      check_simd_import (wrapper);
+      check_simd_random (copy_type);
+      check_parallel (in, wrapper, copy_type);
+      check_decimation (wrapper);
+      check_in_place (wrapper);
+      check_view (wrapper);
+      check_segments (wrapper);
+      check_batch (wrapper);
+      check_planar (wrapper);
+      check_transcode (wrapper, complex_float_test_info, G_N_ELEMENTS (complex_float_test_info));
+      check_transform (wrapper);
+
       /* Импортированые данные. */
       complex_float_data_out = hyscan_buffer_get_complex_float (out, &n_points);
       if ((complex_float_data_out == NULL) || (n_points != N_POINTS))
@@ -231,6 +1698,9 @@ main (int    argc,
       if (!hyscan_buffer_export (in, raw, doa_test_info[i].type))
         g_error ("can't export data");
 
+      check_simd_export (in, doa_test_info[i].type);
+      check_simd_random_export (HYSCAN_DATA_DOA, doa_test_info[i].type);
+
       hyscan_buffer_copy (copy, raw);
       copy_data = hyscan_buffer_get (copy, &copy_type, &copy_size);
       if (copy_size != N_POINTS * hyscan_data_get_point_size (doa_test_info[i].type))
@@ -240,6 +1710,17 @@ main (int    argc,
       if (!hyscan_buffer_import (out, wrapper))
         g_error ("can't import data");
 
+      check_simd_import (wrapper);
+      check_simd_random (copy_type);
+      check_parallel (in, wrapper, copy_type);
+      check_decimation (wrapper);
+      check_in_place (wrapper);
+      check_view (wrapper);
+      check_segments (wrapper);
+      check_batch (wrapper);
+      check_planar (wrapper);
+      check_transcode (wrapper, doa_test_info, G_N_ELEMENTS (doa_test_info));
+
       /* Импортированые данные. */
       doa_data_out = hyscan_buffer_get_doa (out, &n_points);
       if ((doa_data_out == NULL) || (n_points != N_POINTS))